@@ -0,0 +1,459 @@
+// Micro-benchmarks for Tensor, Dense, activations, loss and a full training
+// epoch. Run with --filter=<substr> to select a subset.
+
+#include "benchmark.h"
+#include "../include/utec/algebra/Tensor.h"
+#include "../include/utec/algebra/Reduce.h"
+#include "../include/utec/nn/dense.h"
+#include "../include/utec/nn/activation.h"
+#include "../include/utec/nn/loss.h"
+#include "../include/utec/nn/sequential.h"
+#include "../include/utec/nn/neural_network.h"
+#include "../include/utec/agent/LUTAgent.h"
+#include "../include/utec/agent/EnvGym.h"
+#include <cmath>
+
+using namespace utec::bench;
+using namespace utec::neural_network;
+
+namespace
+{
+    template <typename T>
+    Tensor<T, 2> make_tensor(size_t rows, size_t cols)
+    {
+        Tensor<T, 2> t(rows, cols);
+        for (size_t i = 0; i < t.size(); ++i)
+            t.data()[i] = static_cast<T>(std::sin(0.37 * i));
+        return t;
+    }
+
+    void bm_tensor_add(State &state)
+    {
+        size_t n = state.range(0);
+        auto a = make_tensor<float>(n, n);
+        auto b = make_tensor<float>(n, n);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            Tensor<float, 2> c = a + b;
+            do_not_optimize(c.data());
+        }
+        state.set_flops_per_iteration(double(n) * n);
+        state.set_bytes_per_iteration(3.0 * n * n * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_tensor_add)->arg(64)->arg(256)->arg(1024);
+
+    void bm_tensor_mul(State &state)
+    {
+        size_t n = state.range(0);
+        auto a = make_tensor<float>(n, n);
+        auto b = make_tensor<float>(n, n);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            Tensor<float, 2> c = a * b;
+            do_not_optimize(c.data());
+        }
+        state.set_flops_per_iteration(double(n) * n);
+        state.set_bytes_per_iteration(3.0 * n * n * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_tensor_mul)->arg(64)->arg(1024);
+
+    void bm_tensor_scalar_mul(State &state)
+    {
+        size_t n = state.range(0);
+        auto a = make_tensor<float>(n, n);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            Tensor<float, 2> c = a * 0.5f;
+            do_not_optimize(c.data());
+        }
+        state.set_flops_per_iteration(double(n) * n);
+        state.set_bytes_per_iteration(2.0 * n * n * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_tensor_scalar_mul)->arg(64)->arg(1024);
+
+    // a + b * c evaluated in one pass into a preallocated tensor
+    void bm_tensor_fused_expr(State &state)
+    {
+        size_t n = state.range(0);
+        auto a = make_tensor<float>(n, n);
+        auto b = make_tensor<float>(n, n);
+        auto c = make_tensor<float>(n, n);
+        Tensor<float, 2> out(n, n);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            out = a + b * c;
+            do_not_optimize(out.data());
+        }
+        state.set_flops_per_iteration(2.0 * n * n);
+        state.set_bytes_per_iteration(4.0 * n * n * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_tensor_fused_expr)->arg(64)->arg(1024);
+
+    // SGD-style in-place update: w -= g * lr
+    void bm_tensor_axpy_inplace(State &state)
+    {
+        size_t n = state.range(0);
+        auto w = make_tensor<float>(n, n);
+        auto g = make_tensor<float>(n, n);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            w -= g * 1e-6f;
+            do_not_optimize(w.data());
+        }
+        state.set_flops_per_iteration(2.0 * n * n);
+        state.set_bytes_per_iteration(3.0 * n * n * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_tensor_axpy_inplace)->arg(64)->arg(1024);
+
+    // Bias-style broadcast: [rows, cols] + [1, cols]
+    void bm_tensor_broadcast_add(State &state)
+    {
+        size_t rows = state.range(0), cols = state.range(1);
+        auto a = make_tensor<float>(rows, cols);
+        auto bias = make_tensor<float>(1, cols);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            Tensor<float, 2> c = a + bias;
+            do_not_optimize(c.data());
+        }
+        state.set_flops_per_iteration(double(rows) * cols);
+        state.set_bytes_per_iteration(2.0 * rows * cols * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_tensor_broadcast_add)->args({2000, 64})->args({256, 1024});
+
+    // Column broadcast: [rows, cols] * [rows, 1] (stride-0 inner operand)
+    void bm_tensor_broadcast_col(State &state)
+    {
+        size_t rows = state.range(0), cols = state.range(1);
+        auto a = make_tensor<float>(rows, cols);
+        auto scale = make_tensor<float>(rows, 1);
+        Tensor<float, 2> c(rows, cols);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            c = a * scale;
+            do_not_optimize(c.data());
+        }
+        state.set_flops_per_iteration(double(rows) * cols);
+        state.set_bytes_per_iteration(2.0 * rows * cols * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_tensor_broadcast_col)->args({2000, 64})->args({256, 1024});
+
+    void bm_reduce_column_sum(State &state)
+    {
+        size_t rows = state.range(0), cols = state.range(1);
+        auto a = make_tensor<float>(rows, cols);
+        Tensor<float, 1> out(cols);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            sum_into(a, 0, out);
+            do_not_optimize(out.data());
+        }
+        state.set_flops_per_iteration(double(rows) * cols);
+        state.set_bytes_per_iteration(double(rows) * cols * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_reduce_column_sum)->args({2000, 64})->args({256, 1024});
+
+    void bm_reduce_row_argmax(State &state)
+    {
+        size_t rows = state.range(0), cols = state.range(1);
+        auto a = make_tensor<float>(rows, cols);
+        Tensor<size_t, 1> out(rows);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            argmax_into(a, 1, out);
+            do_not_optimize(out.data());
+        }
+        state.set_bytes_per_iteration(double(rows) * cols * sizeof(float));
+        state.set_items_per_iteration(double(rows));
+    }
+    UTEC_BENCHMARK(bm_reduce_row_argmax)->args({2000, 3})->args({256, 1024});
+
+    // A batch temporary created and dropped every step, as in the training loop
+    template <typename Alloc>
+    void tensor_temporary_cycle(State &state)
+    {
+        size_t rows = state.range(0), cols = state.range(1);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            Tensor<float, 2, Alloc> tmp(rows, cols);
+            do_not_optimize(tmp.data());
+        }
+        state.set_bytes_per_iteration(double(rows) * cols * sizeof(float));
+    }
+
+    void bm_tensor_temporary_aligned(State &state) { tensor_temporary_cycle<AlignedAllocator<float>>(state); }
+    UTEC_BENCHMARK(bm_tensor_temporary_aligned)->args({32, 64})->args({2000, 256});
+
+    void bm_tensor_temporary_pool(State &state) { tensor_temporary_cycle<PoolAllocator<float>>(state); }
+    UTEC_BENCHMARK(bm_tensor_temporary_pool)->args({32, 64})->args({2000, 256});
+
+    void bm_transpose_2d(State &state)
+    {
+        size_t rows = state.range(0), cols = state.range(1);
+        auto a = make_tensor<float>(rows, cols);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            auto t = a.transpose_2d();
+            do_not_optimize(t.data());
+        }
+        state.set_bytes_per_iteration(2.0 * rows * cols * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_transpose_2d)->args({2000, 64})->args({1024, 1024});
+
+    void bm_dense_forward(State &state)
+    {
+        size_t batch = state.range(0), width = state.range(1);
+        Dense<float> layer(width, width, make_tensor<float>(width, width));
+        auto x = make_tensor<float>(batch, width);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            auto y = layer.forward(x);
+            do_not_optimize(y.data());
+        }
+        state.set_flops_per_iteration(2.0 * batch * width * width);
+        state.set_bytes_per_iteration((2.0 * batch * width + width * width) * sizeof(float));
+        state.set_items_per_iteration(double(batch));
+    }
+    UTEC_BENCHMARK(bm_dense_forward)->args_product({{1, 32, 256, 2000}, {64, 256}});
+
+    // Inference path: packed panels, no input caching
+    void bm_dense_infer(State &state)
+    {
+        size_t batch = state.range(0), width = state.range(1);
+        Dense<float> layer(width, width, make_tensor<float>(width, width));
+        auto x = make_tensor<float>(batch, width);
+        Tensor<float, 2> y;
+        for ([[maybe_unused]] auto _ : state)
+        {
+            layer.infer_into(x, y);
+            do_not_optimize(y.data());
+        }
+        state.set_flops_per_iteration(2.0 * batch * width * width);
+        state.set_bytes_per_iteration((2.0 * batch * width + width * width) * sizeof(float));
+        state.set_items_per_iteration(double(batch));
+    }
+    UTEC_BENCHMARK(bm_dense_infer)->args_product({{1, 4, 32, 256, 2000}, {3, 64, 256}});
+
+    void bm_dense_backward(State &state)
+    {
+        size_t batch = state.range(0), width = state.range(1);
+        Dense<float> layer(width, width, make_tensor<float>(width, width));
+        auto x = make_tensor<float>(batch, width);
+        auto grad = make_tensor<float>(batch, width);
+        layer.forward(x);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            auto dx = layer.backward(grad);
+            do_not_optimize(dx.data());
+        }
+        // dW = x^T g, db = colsum(g), dx = g W^T
+        state.set_flops_per_iteration(4.0 * batch * width * width + double(batch) * width);
+        state.set_bytes_per_iteration((3.0 * batch * width + 2.0 * width * width) * sizeof(float));
+        state.set_items_per_iteration(double(batch));
+    }
+    UTEC_BENCHMARK(bm_dense_backward)->args_product({{1, 32, 256, 2000}, {64, 256}});
+
+    void bm_relu_forward(State &state)
+    {
+        size_t batch = state.range(0), width = state.range(1);
+        ReLU<float> relu;
+        auto x = make_tensor<float>(batch, width);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            auto y = relu.forward(x);
+            do_not_optimize(y.data());
+        }
+        state.set_bytes_per_iteration(3.0 * batch * width * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_relu_forward)->args({2000, 64})->args({2000, 256});
+
+    void bm_relu_backward(State &state)
+    {
+        size_t batch = state.range(0), width = state.range(1);
+        ReLU<float> relu;
+        auto x = make_tensor<float>(batch, width);
+        auto grad = make_tensor<float>(batch, width);
+        relu.forward(x);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            auto dx = relu.backward(grad);
+            do_not_optimize(dx.data());
+        }
+        state.set_flops_per_iteration(double(batch) * width);
+        state.set_bytes_per_iteration(3.0 * batch * width * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_relu_backward)->args({2000, 64})->args({2000, 256});
+
+    void bm_mse_loss(State &state)
+    {
+        size_t batch = state.range(0), width = state.range(1);
+        auto pred = make_tensor<float>(batch, width);
+        auto target = make_tensor<float>(batch, width);
+        MSELoss<float> loss;
+        for ([[maybe_unused]] auto _ : state)
+        {
+            float l = loss.forward(pred, target);
+            auto grad = loss.backward();
+            do_not_optimize(l);
+            do_not_optimize(grad.data());
+        }
+        state.set_flops_per_iteration(5.0 * batch * width);
+        state.set_bytes_per_iteration(3.0 * batch * width * sizeof(float));
+    }
+    UTEC_BENCHMARK(bm_mse_loss)->args({2000, 3})->args({2000, 256});
+
+    void bm_softmax_cross_entropy(State &state)
+    {
+        size_t batch = state.range(0), classes = state.range(1);
+        auto logits = make_tensor<float>(batch, classes);
+        std::vector<int> labels(batch);
+        for (size_t i = 0; i < batch; ++i)
+            labels[i] = static_cast<int>(i % classes);
+        SoftmaxCrossEntropyLoss<float> loss;
+        for ([[maybe_unused]] auto _ : state)
+        {
+            float l = loss.forward(logits, labels);
+            do_not_optimize(l);
+            do_not_optimize(loss.backward().data());
+        }
+        state.set_bytes_per_iteration(2.0 * batch * classes * sizeof(float));
+        state.set_items_per_iteration(double(batch));
+    }
+    UTEC_BENCHMARK(bm_softmax_cross_entropy)->args({2000, 3})->args({2000, 256});
+
+    // One epoch of the train.cpp architecture: forward, loss, backward, update
+    void bm_train_epoch(State &state)
+    {
+        size_t samples = state.range(0);
+        auto model = std::make_unique<Sequential<float>>();
+        model->add_layer(std::make_unique<Dense<float>>(3, 64));
+        model->add_layer(std::make_unique<ReLU<float>>());
+        model->add_layer(std::make_unique<Dense<float>>(64, 32));
+        model->add_layer(std::make_unique<ReLU<float>>());
+        model->add_layer(std::make_unique<Dense<float>>(32, 3));
+        NeuralNetwork<float> net;
+        net.add_layer(std::move(model));
+
+        auto X = make_tensor<float>(samples, 3);
+        Tensor<float, 2> Y(samples, 3);
+        for (size_t i = 0; i < samples; ++i)
+            Y(i, i % 3) = 1.0f;
+
+        for ([[maybe_unused]] auto _ : state)
+        {
+            float loss = net.train(X, Y, 1, 0.01f);
+            do_not_optimize(loss);
+        }
+        double macs = 3.0 * 64 + 64.0 * 32 + 32.0 * 3;
+        state.set_flops_per_iteration(6.0 * samples * macs); // 2 forward + 4 backward
+        state.set_items_per_iteration(double(samples));
+        state.set_label("samples/s");
+    }
+    UTEC_BENCHMARK(bm_train_epoch)->arg(256)->arg(2000);
+
+    std::unique_ptr<ILayer<float>> make_policy()
+    {
+        auto model = std::make_unique<Sequential<float>>();
+        model->add_layer(std::make_unique<Dense<float>>(3, 64));
+        model->add_layer(std::make_unique<ReLU<float>>());
+        model->add_layer(std::make_unique<Dense<float>>(64, 32));
+        model->add_layer(std::make_unique<ReLU<float>>());
+        model->add_layer(std::make_unique<Dense<float>>(32, 3));
+        return model;
+    }
+
+    std::vector<utec::nn::State> make_states(size_t n)
+    {
+        std::vector<utec::nn::State> states(n);
+        for (size_t i = 0; i < n; ++i)
+            states[i] = {std::fmod(i * 0.618034f, 1.0f), std::fmod(i * 0.414214f, 1.0f),
+                         std::fmod(i * 0.732051f, 1.0f)};
+        return states;
+    }
+
+    // One decision of the 3-64-32-3 policy network
+    void bm_agent_act(State &state)
+    {
+        utec::nn::PongAgent<float> agent(make_policy());
+        auto states = make_states(1024);
+        size_t i = 0;
+        for ([[maybe_unused]] auto _ : state)
+        {
+            int action = agent.act(states[i++ & 1023]);
+            do_not_optimize(action);
+        }
+        state.set_items_per_iteration(1.0);
+    }
+    UTEC_BENCHMARK(bm_agent_act);
+
+    // The same policy compiled into a LUT of range(0)^3 cells
+    void bm_lut_act(State &state)
+    {
+        const size_t cells = state.range(0);
+        utec::nn::PongAgent<float> agent(make_policy());
+        auto lut = utec::nn::LUTAgent::compile(agent, {cells, cells, cells});
+        auto states = make_states(1024);
+        size_t i = 0;
+        for ([[maybe_unused]] auto _ : state)
+        {
+            int action = lut.act(states[i++ & 1023]);
+            do_not_optimize(action);
+        }
+        state.set_items_per_iteration(1.0);
+    }
+    UTEC_BENCHMARK(bm_lut_act)->arg(32)->arg(128);
+
+    // 10000 frames tracking the ball, one decision every range(0) frames
+    // and after each restart (episodes restart on a miss), one step() per frame
+    void bm_env_step(State &state)
+    {
+        const size_t repeat = state.range(0), frames = 10000;
+        for ([[maybe_unused]] auto _ : state)
+        {
+            utec::nn::EnvGym env(3);
+            utec::nn::State s = env.reset();
+            float reward;
+            bool done;
+            int action = 0;
+            bool fresh = true;
+            for (size_t t = 0; t < frames; ++t)
+            {
+                if (t % repeat == 0 || fresh)
+                    action = s.ball_y > s.paddle_y ? 1 : -1;
+                s = env.step(action, reward, done);
+                fresh = done;
+                if (done)
+                    s = env.reset();
+            }
+            do_not_optimize(s);
+        }
+        state.set_items_per_iteration(static_cast<double>(frames));
+    }
+    UTEC_BENCHMARK(bm_env_step)->arg(1)->arg(64)->arg(1024);
+
+    // The same frames through step_repeat
+    void bm_env_step_repeat(State &state)
+    {
+        const size_t repeat = state.range(0), frames = 10000;
+        for ([[maybe_unused]] auto _ : state)
+        {
+            utec::nn::EnvGym env(3);
+            utec::nn::State s = env.reset();
+            float reward;
+            bool done;
+            size_t stepped;
+            for (size_t t = 0; t < frames; t += stepped)
+            {
+                s = env.step_repeat(s.ball_y > s.paddle_y ? 1 : -1, std::min(frames - t, repeat - t % repeat),
+                                    reward, done, stepped);
+                if (done)
+                    s = env.reset();
+            }
+            do_not_optimize(s);
+        }
+        state.set_items_per_iteration(static_cast<double>(frames));
+    }
+    UTEC_BENCHMARK(bm_env_step_repeat)->arg(1)->arg(64)->arg(1024);
+}
+
+UTEC_BENCHMARK_MAIN();
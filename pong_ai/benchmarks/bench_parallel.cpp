@@ -0,0 +1,321 @@
+// Benchmarks for ThreadPool and ConcurrentQueue: submission cost, round-trip
+// and enqueue-to-execution latency percentiles, throughput/scaling over the
+// number of producers, consumers and worker threads, realtime-lane latency
+// under background load, and the per-step overhead of a reusable TaskGraph.
+// Use --json=results.json to keep the numbers for later comparison.
+
+#include "benchmark.h"
+#include "../include/utec/parallel/ThreadPool.h"
+#include "../include/utec/parallel/ConcurrentQueue.h"
+#include "../include/utec/parallel/TaskGraph.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace utec::bench;
+using namespace utec::parallel;
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    double ns_between(clock_type::time_point a, clock_type::time_point b)
+    {
+        return std::chrono::duration<double, std::nano>(b - a).count();
+    }
+
+    // Busy work of roughly `n` floating point operations
+    inline float spin_work(int n)
+    {
+        static volatile float decay = 0.999f; // opaque to the optimizer
+        const float d = decay;
+        float acc = 1.0f;
+        for (int i = 0; i < n; ++i)
+            acc = acc * d + 0.001f;
+        return acc;
+    }
+
+    // Cost of enqueue alone: a batch of no-op tasks is submitted per iteration
+    // and drained outside the timed region.
+    void bm_pool_submit(State &state)
+    {
+        const size_t threads = state.range(0);
+        const size_t batch = 256;
+        ThreadPool pool(threads);
+        std::vector<std::future<void>> futures;
+        futures.reserve(batch);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            for (size_t i = 0; i < batch; ++i)
+                futures.push_back(pool.enqueue([] {}));
+            state.pause_timing();
+            for (auto &f : futures)
+                f.get();
+            futures.clear();
+            state.resume_timing();
+        }
+        state.set_items_per_iteration(double(batch));
+        state.set_label("submits/s");
+    }
+    UTEC_BENCHMARK(bm_pool_submit)->arg(1)->arg(2)->arg(4)->arg(8);
+
+    // enqueue + future::get of a single no-op task
+    void bm_pool_round_trip(State &state)
+    {
+        ThreadPool pool(state.range(0));
+        std::vector<double> samples;
+        for ([[maybe_unused]] auto _ : state)
+        {
+            auto start = clock_type::now();
+            pool.enqueue([] {}).get();
+            samples.push_back(ns_between(start, clock_type::now()));
+        }
+        state.set_counter("p50_ns", percentile(samples, 0.50));
+        state.set_counter("p99_ns", percentile(samples, 0.99));
+        state.set_counter("p999_ns", percentile(samples, 0.999));
+    }
+    UTEC_BENCHMARK(bm_pool_round_trip)->arg(1)->arg(4);
+
+    // Delay between enqueue and the start of execution, with `producers`
+    // threads submitting concurrently into a pool of `threads` workers.
+    void bm_pool_enqueue_to_start(State &state)
+    {
+        const size_t threads = state.range(0);
+        const size_t producers = state.range(1);
+        const size_t per_producer = 512;
+        ThreadPool pool(threads);
+        std::vector<double> samples(producers * per_producer);
+
+        for ([[maybe_unused]] auto _ : state)
+        {
+            std::atomic<size_t> done{0};
+            std::vector<std::thread> submitters;
+            for (size_t p = 0; p < producers; ++p)
+            {
+                submitters.emplace_back([&, p]
+                                        {
+                    for (size_t i = 0; i < per_producer; ++i)
+                    {
+                        size_t slot = p * per_producer + i;
+                        auto queued_at = clock_type::now();
+                        pool.enqueue([&samples, &done, slot, queued_at]
+                                     {
+                            samples[slot] = ns_between(queued_at, clock_type::now());
+                            done.fetch_add(1, std::memory_order_release); });
+                    } });
+            }
+            for (auto &t : submitters)
+                t.join();
+            while (done.load(std::memory_order_acquire) < samples.size())
+                std::this_thread::yield();
+        }
+
+        state.set_items_per_iteration(double(samples.size()));
+        state.set_label("tasks/s");
+        state.set_counter("p50_ns", percentile(samples, 0.50));
+        state.set_counter("p99_ns", percentile(samples, 0.99));
+        state.set_counter("p999_ns", percentile(samples, 0.999));
+    }
+    UTEC_BENCHMARK(bm_pool_enqueue_to_start)->args_product({{1, 2, 4, 8}, {1, 4}});
+
+    // Scaling curve: fixed amount of small compute tasks over N workers
+    void bm_pool_scaling(State &state)
+    {
+        const size_t threads = state.range(0);
+        const int work = static_cast<int>(state.range(1));
+        const size_t tasks = 1024;
+        ThreadPool pool(threads);
+        std::vector<std::future<float>> futures;
+        futures.reserve(tasks);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            for (size_t i = 0; i < tasks; ++i)
+                futures.push_back(pool.enqueue([work]
+                                               { return spin_work(work); }));
+            for (auto &f : futures)
+                do_not_optimize(f.get());
+            futures.clear();
+        }
+        state.set_items_per_iteration(double(tasks));
+        state.set_flops_per_iteration(2.0 * tasks * work);
+        state.set_label("tasks/s");
+    }
+    UTEC_BENCHMARK(bm_pool_scaling)->args_product({{1, 2, 4, 8}, {100, 10000}});
+
+    // Round trip of a short task while the pool is saturated with batch jobs.
+    // Second arg: 0 = everything Normal (plain FIFO, the task waits behind the
+    // backlog), 1 = batch jobs on the Background lane, task on Realtime.
+    void bm_pool_mixed_load(State &state)
+    {
+        const size_t threads = state.range(0);
+        const bool realtime = state.range(1) != 0;
+        const size_t backlog = 64;
+        ThreadPool pool(threads);
+        std::vector<std::future<float>> background;
+        std::vector<double> samples;
+        const TaskOptions latency_class{realtime ? Priority::Realtime : Priority::Normal, std::nullopt};
+        const TaskOptions batch_class{realtime ? Priority::Background : Priority::Normal, std::nullopt};
+
+        for ([[maybe_unused]] auto _ : state)
+        {
+            state.pause_timing();
+            for (size_t i = 0; i < backlog; ++i)
+                background.push_back(pool.enqueue_with(batch_class, []
+                                                       { return spin_work(20000); }));
+            state.resume_timing();
+
+            auto start = clock_type::now();
+            pool.enqueue_with(latency_class, [] {}).get();
+            samples.push_back(ns_between(start, clock_type::now()));
+
+            state.pause_timing();
+            for (auto &f : background)
+                do_not_optimize(f.get());
+            background.clear();
+            state.resume_timing();
+        }
+        state.set_label(realtime ? "lanes" : "fifo");
+        state.set_counter("p50_ns", percentile(samples, 0.50));
+        state.set_counter("p99_ns", percentile(samples, 0.99));
+    }
+    UTEC_BENCHMARK(bm_pool_mixed_load)->args_product({{1, 4}, {0, 1}});
+
+    // One "training step" of `shards` small tasks, a reduction and an update.
+    // Second arg: 0 = enqueue + future.get() per stage from the caller,
+    // 1 = the same dependencies as a TaskGraph built once and re-run.
+    void bm_graph_step(State &state)
+    {
+        const size_t shards = state.range(0);
+        const bool graph_mode = state.range(1) != 0;
+        const int work = 2000;
+        ThreadPool pool(4);
+        std::vector<float> partial(shards);
+        float total = 0;
+
+        TaskGraph step;
+        auto reduce = step.emplace([&]
+                                   {
+            total = 0;
+            for (float p : partial)
+                total += p; },
+                                   "reduce");
+        auto update = step.emplace([&]
+                                   { total = spin_work(work) * total; },
+                                   "update");
+        reduce.precede(update);
+        for (size_t s = 0; s < shards; ++s)
+            step.emplace([&, s]
+                         { partial[s] = spin_work(work); },
+                         "forward")
+                .precede(reduce);
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(shards);
+        for ([[maybe_unused]] auto _ : state)
+        {
+            if (graph_mode)
+            {
+                step.run(pool);
+            }
+            else
+            {
+                for (size_t s = 0; s < shards; ++s)
+                    futures.push_back(pool.enqueue([&, s]
+                                                   { partial[s] = spin_work(work); }));
+                for (auto &f : futures)
+                    f.get();
+                futures.clear();
+                pool.enqueue([&]
+                             {
+                    total = 0;
+                    for (float p : partial)
+                        total += p; })
+                    .get();
+                pool.enqueue([&]
+                             { total = spin_work(work) * total; })
+                    .get();
+            }
+            do_not_optimize(total);
+        }
+        state.set_items_per_iteration(double(shards + 2));
+        state.set_label(graph_mode ? "graph" : "futures");
+    }
+    UTEC_BENCHMARK(bm_graph_step)->args_product({{4, 32}, {0, 1}});
+
+    // ConcurrentQueue throughput with P producers and C consumers
+    void bm_queue_throughput(State &state)
+    {
+        const size_t producers = state.range(0);
+        const size_t consumers = state.range(1);
+        const size_t per_producer = 4096;
+        const size_t total = producers * per_producer;
+
+        for ([[maybe_unused]] auto _ : state)
+        {
+            ConcurrentQueue<size_t> queue;
+            std::atomic<size_t> consumed{0};
+            std::vector<std::thread> threads;
+            for (size_t c = 0; c < consumers; ++c)
+            {
+                threads.emplace_back([&]
+                                     {
+                    size_t item;
+                    while (queue.pop(item))
+                    {
+                        do_not_optimize(item);
+                        if (consumed.fetch_add(1, std::memory_order_relaxed) + 1 == total)
+                            queue.shutdown();
+                    } });
+            }
+            for (size_t p = 0; p < producers; ++p)
+            {
+                threads.emplace_back([&, p]
+                                     {
+                    for (size_t i = 0; i < per_producer; ++i)
+                        queue.push(p * per_producer + i); });
+            }
+            for (auto &t : threads)
+                t.join();
+        }
+        state.set_items_per_iteration(double(total));
+        state.set_label("items/s");
+    }
+    UTEC_BENCHMARK(bm_queue_throughput)->args_product({{1, 2, 4}, {1, 2, 4}});
+
+    // Push-to-pop latency through a single queue with one consumer
+    void bm_queue_latency(State &state)
+    {
+        const size_t producers = state.range(0);
+        const size_t per_producer = 1024;
+        std::vector<double> samples(producers * per_producer);
+
+        for ([[maybe_unused]] auto _ : state)
+        {
+            ConcurrentQueue<std::pair<size_t, clock_type::time_point>> queue;
+            std::thread consumer([&]
+                                 {
+                std::pair<size_t, clock_type::time_point> item;
+                for (size_t n = 0; n < samples.size() && queue.pop(item); ++n)
+                    samples[item.first] = ns_between(item.second, clock_type::now()); });
+            std::vector<std::thread> threads;
+            for (size_t p = 0; p < producers; ++p)
+            {
+                threads.emplace_back([&, p]
+                                     {
+                    for (size_t i = 0; i < per_producer; ++i)
+                        queue.push({p * per_producer + i, clock_type::now()}); });
+            }
+            for (auto &t : threads)
+                t.join();
+            consumer.join();
+        }
+        state.set_items_per_iteration(double(samples.size()));
+        state.set_counter("p50_ns", percentile(samples, 0.50));
+        state.set_counter("p99_ns", percentile(samples, 0.99));
+        state.set_counter("p999_ns", percentile(samples, 0.999));
+    }
+    UTEC_BENCHMARK(bm_queue_latency)->arg(1)->arg(2)->arg(4);
+}
+
+UTEC_BENCHMARK_MAIN();
@@ -0,0 +1,437 @@
+#ifndef UTEC_BENCHMARKS_BENCHMARK_H
+#define UTEC_BENCHMARKS_BENCHMARK_H
+
+// Minimal self-contained benchmark harness with a Google-Benchmark-like API:
+//
+//   void bm_something(utec::bench::State &state)
+//   {
+//       for ([[maybe_unused]] auto _ : state) { ... }
+//       state.set_flops_per_iteration(...);
+//   }
+//   UTEC_BENCHMARK(bm_something)->args({64, 256});
+//   UTEC_BENCHMARK_MAIN();
+//
+// Each benchmark is calibrated until one run takes at least --min_time
+// seconds, then repeated --repetitions times; the median is reported.
+// --json=<file> additionally writes all results (including custom counters
+// set with State::set_counter) as JSON for tracking over time.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace utec::bench
+{
+
+    // Prevents the compiler from discarding a computed value
+    template <typename T>
+    inline void do_not_optimize(T const &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    inline void clobber_memory()
+    {
+        asm volatile("" : : : "memory");
+    }
+
+    class State
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        State(uint64_t iterations, std::vector<int64_t> args)
+            : max_iterations_(iterations), args_(std::move(args))
+        {
+        }
+
+        int64_t range(size_t i) const { return args_.at(i); }
+        uint64_t iterations() const { return max_iterations_; }
+
+        // Work per iteration, used to derive GFLOP/s, GB/s and items/s
+        void set_flops_per_iteration(double flops) { flops_ = flops; }
+        void set_bytes_per_iteration(double bytes) { bytes_ = bytes; }
+        void set_items_per_iteration(double items) { items_ = items; }
+        void set_label(std::string label) { label_ = std::move(label); }
+
+        // Arbitrary named result (latency percentiles, queue depths, ...)
+        void set_counter(const std::string &name, double value)
+        {
+            for (auto &c : counters_)
+            {
+                if (c.first == name)
+                {
+                    c.second = value;
+                    return;
+                }
+            }
+            counters_.emplace_back(name, value);
+        }
+
+        // Exclude setup code inside the loop from the measurement
+        void pause_timing() { accumulated_ += clock::now() - start_; }
+        void resume_timing() { start_ = clock::now() - accumulated_; accumulated_ = {}; }
+
+        double flops() const { return flops_; }
+        double bytes() const { return bytes_; }
+        double items() const { return items_; }
+        const std::string &label() const { return label_; }
+        const std::vector<std::pair<std::string, double>> &counters() const { return counters_; }
+        double elapsed_seconds() const { return std::chrono::duration<double>(elapsed_).count(); }
+
+        struct Iterator
+        {
+            State *state;
+            uint64_t remaining;
+
+            bool operator!=(const Iterator &) const
+            {
+                if (remaining != 0)
+                    return true;
+                state->finish();
+                return false;
+            }
+            void operator++() { --remaining; }
+            int operator*() const { return 0; }
+        };
+
+        Iterator begin()
+        {
+            start_ = clock::now();
+            return {this, max_iterations_};
+        }
+        Iterator end() { return {this, 0}; }
+
+    private:
+        void finish() { elapsed_ = clock::now() - start_; }
+
+        uint64_t max_iterations_;
+        std::vector<int64_t> args_;
+        clock::time_point start_{};
+        clock::duration accumulated_{}; // running time before a pause
+        clock::duration elapsed_{};
+        double flops_ = 0;
+        double bytes_ = 0;
+        double items_ = 0;
+        std::string label_;
+        std::vector<std::pair<std::string, double>> counters_;
+    };
+
+    // q in [0, 1]; sorts the samples in place
+    inline double percentile(std::vector<double> &samples, double q)
+    {
+        if (samples.empty())
+            return 0;
+        std::sort(samples.begin(), samples.end());
+        size_t idx = static_cast<size_t>(q * (samples.size() - 1) + 0.5);
+        return samples[std::min(idx, samples.size() - 1)];
+    }
+
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations = 0;
+        double ns_per_iter = 0;
+        double gflops = 0;
+        double gbytes_per_sec = 0;
+        double items_per_sec = 0;
+        std::string label;
+        std::vector<std::pair<std::string, double>> counters;
+    };
+
+    class Benchmark
+    {
+    public:
+        Benchmark(std::string name, std::function<void(State &)> fn)
+            : name_(std::move(name)), fn_(std::move(fn))
+        {
+        }
+
+        Benchmark *arg(int64_t a)
+        {
+            arg_sets_.push_back({a});
+            return this;
+        }
+
+        Benchmark *args(std::vector<int64_t> a)
+        {
+            arg_sets_.push_back(std::move(a));
+            return this;
+        }
+
+        // Cartesian product of the given value lists
+        Benchmark *args_product(const std::vector<std::vector<int64_t>> &lists)
+        {
+            std::vector<std::vector<int64_t>> combos{{}};
+            for (const auto &list : lists)
+            {
+                std::vector<std::vector<int64_t>> next;
+                for (const auto &prefix : combos)
+                {
+                    for (int64_t v : list)
+                    {
+                        auto c = prefix;
+                        c.push_back(v);
+                        next.push_back(std::move(c));
+                    }
+                }
+                combos = std::move(next);
+            }
+            for (auto &c : combos)
+                arg_sets_.push_back(std::move(c));
+            return this;
+        }
+
+        const std::string &name() const { return name_; }
+        const std::function<void(State &)> &function() const { return fn_; }
+
+        std::vector<std::vector<int64_t>> arg_sets() const
+        {
+            if (arg_sets_.empty())
+                return {{}};
+            return arg_sets_;
+        }
+
+    private:
+        std::string name_;
+        std::function<void(State &)> fn_;
+        std::vector<std::vector<int64_t>> arg_sets_;
+    };
+
+    inline std::vector<std::unique_ptr<Benchmark>> &registry()
+    {
+        static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+        return benchmarks;
+    }
+
+    inline Benchmark *register_benchmark(const std::string &name, std::function<void(State &)> fn)
+    {
+        registry().push_back(std::make_unique<Benchmark>(name, std::move(fn)));
+        return registry().back().get();
+    }
+
+    struct Options
+    {
+        std::string filter;
+        double min_time = 0.2;
+        int repetitions = 3;
+        std::string json_path;
+    };
+
+    inline Options parse_options(int argc, char **argv)
+    {
+        Options opts;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string a = argv[i];
+            auto value = [&](const char *prefix) -> const char *
+            {
+                size_t n = std::strlen(prefix);
+                return a.compare(0, n, prefix) == 0 ? a.c_str() + n : nullptr;
+            };
+            if (const char *v = value("--filter="))
+                opts.filter = v;
+            else if (const char *v = value("--min_time="))
+                opts.min_time = std::atof(v);
+            else if (const char *v = value("--repetitions="))
+                opts.repetitions = std::max(1, std::atoi(v));
+            else if (const char *v = value("--json="))
+                opts.json_path = v;
+            else
+            {
+                std::cerr << "Unknown option: " << a << "\n"
+                          << "Usage: " << argv[0]
+                          << " [--filter=substr] [--min_time=sec] [--repetitions=n] [--json=file]\n";
+                std::exit(1);
+            }
+        }
+        return opts;
+    }
+
+    inline std::string full_name(const Benchmark &b, const std::vector<int64_t> &args)
+    {
+        std::string name = b.name();
+        for (int64_t a : args)
+            name += "/" + std::to_string(a);
+        return name;
+    }
+
+    inline Result run_one(const Benchmark &b, const std::vector<int64_t> &args, const Options &opts)
+    {
+        // Grow the iteration count until a single run reaches min_time
+        uint64_t iters = 1;
+        double seconds = 0;
+        while (true)
+        {
+            State state(iters, args);
+            b.function()(state);
+            seconds = state.elapsed_seconds();
+            if (seconds >= opts.min_time || iters >= (uint64_t(1) << 40))
+                break;
+            double scale = seconds > 0 ? opts.min_time * 1.4 / seconds : 10.0;
+            iters = static_cast<uint64_t>(iters * std::clamp(scale, 2.0, 10.0));
+        }
+
+        std::vector<State> runs;
+        std::vector<double> samples;
+        Result result;
+        result.name = full_name(b, args);
+        result.iterations = iters;
+        for (int r = 0; r < opts.repetitions; ++r)
+        {
+            runs.emplace_back(iters, args);
+            b.function()(runs.back());
+            samples.push_back(runs.back().elapsed_seconds());
+        }
+
+        // Report the counters of the median run alongside its time
+        std::vector<size_t> order(runs.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                  { return samples[a] < samples[b]; });
+        const State &median = runs[order[order.size() / 2]];
+        result.gflops = median.flops();
+        result.gbytes_per_sec = median.bytes();
+        result.items_per_sec = median.items();
+        result.label = median.label();
+        result.counters = median.counters();
+        double per_iter = median.elapsed_seconds() / static_cast<double>(iters);
+
+        result.ns_per_iter = per_iter * 1e9;
+        result.gflops = result.gflops / per_iter * 1e-9;
+        result.gbytes_per_sec = result.gbytes_per_sec / per_iter * 1e-9;
+        result.items_per_sec = result.items_per_sec / per_iter;
+        return result;
+    }
+
+    inline void print_header()
+    {
+        std::printf("%-44s %12s %14s %10s %10s %14s\n",
+                    "Benchmark", "Iterations", "Time/iter", "GFLOP/s", "GB/s", "items/s");
+        std::printf("%s\n", std::string(108, '-').c_str());
+    }
+
+    inline void print_result(const Result &r)
+    {
+        char time[32];
+        if (r.ns_per_iter < 1e3)
+            std::snprintf(time, sizeof(time), "%.1f ns", r.ns_per_iter);
+        else if (r.ns_per_iter < 1e6)
+            std::snprintf(time, sizeof(time), "%.2f us", r.ns_per_iter * 1e-3);
+        else
+            std::snprintf(time, sizeof(time), "%.2f ms", r.ns_per_iter * 1e-6);
+
+        auto num = [](double v, char *buf, size_t n, const char *fmt)
+        {
+            if (v > 0)
+                std::snprintf(buf, n, fmt, v);
+            else
+                std::snprintf(buf, n, "-");
+        };
+        char gflops[32], gbs[32], items[32];
+        num(r.gflops, gflops, sizeof(gflops), "%.3f");
+        num(r.gbytes_per_sec, gbs, sizeof(gbs), "%.3f");
+        num(r.items_per_sec, items, sizeof(items), "%.4g");
+        std::printf("%-44s %12llu %14s %10s %10s %14s %s", r.name.c_str(),
+                    static_cast<unsigned long long>(r.iterations), time, gflops, gbs, items,
+                    r.label.c_str());
+        for (const auto &c : r.counters)
+            std::printf(" %s=%.4g", c.first.c_str(), c.second);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+    inline std::string json_escape(const std::string &s)
+    {
+        std::string out;
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    inline void write_json(const std::string &path, const std::vector<Result> &results)
+    {
+        std::ofstream out(path);
+        if (!out)
+        {
+            std::cerr << "Error: Could not open JSON output file: " << path << "\n";
+            return;
+        }
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        out << "{\n  \"context\": {\"date\": \"" << date
+            << "\", \"hardware_concurrency\": " << std::thread::hardware_concurrency()
+            << "},\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result &r = results[i];
+            out << "    {\"name\": \"" << json_escape(r.name) << "\""
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_iter\": " << r.ns_per_iter
+                << ", \"gflops\": " << r.gflops
+                << ", \"gbytes_per_sec\": " << r.gbytes_per_sec
+                << ", \"items_per_sec\": " << r.items_per_sec;
+            for (const auto &c : r.counters)
+                out << ", \"" << json_escape(c.first) << "\": " << c.second;
+            out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+    inline std::vector<Result> run_all(const Options &opts)
+    {
+        std::vector<Result> results;
+        print_header();
+        for (const auto &b : registry())
+        {
+            for (const auto &args : b->arg_sets())
+            {
+                std::string name = full_name(*b, args);
+                if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos)
+                    continue;
+                results.push_back(run_one(*b, args, opts));
+                print_result(results.back());
+            }
+        }
+        if (!opts.json_path.empty())
+            write_json(opts.json_path, results);
+        return results;
+    }
+
+} // namespace utec::bench
+
+#define UTEC_BENCH_CONCAT_(a, b) a##b
+#define UTEC_BENCH_CONCAT(a, b) UTEC_BENCH_CONCAT_(a, b)
+
+#define UTEC_BENCHMARK(fn)                                                   \
+    static ::utec::bench::Benchmark *UTEC_BENCH_CONCAT(utec_bench_, __LINE__) \
+        [[maybe_unused]] = ::utec::bench::register_benchmark(#fn, fn)
+
+#define UTEC_BENCHMARK_MAIN()                                    \
+    int main(int argc, char **argv)                              \
+    {                                                            \
+        auto opts = ::utec::bench::parse_options(argc, argv);    \
+        ::utec::bench::run_all(opts);                            \
+        return 0;                                                \
+    }
+
+#endif // UTEC_BENCHMARKS_BENCHMARK_H
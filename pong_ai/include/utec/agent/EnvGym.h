@@ -1,8 +1,13 @@
 #ifndef UTEC_AGENT_ENVGYM_H
 #define UTEC_AGENT_ENVGYM_H
 
-#include <random>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include "State.h"
+#include "../random/Philox.h"
 
 namespace utec::nn
 {
@@ -22,17 +27,30 @@ namespace utec::nn
         const float ball_radius = 0.02f;
         const float dt = 0.016f; // ~60 FPS
 
-        // Random number generation
-        std::mt19937 rng;
-        std::uniform_real_distribution<float> vel_dist;
+        // Random number generation (counter-based: 48 bytes per env)
+        utec::random::Philox rng;
+
+        float vel_dist() { return -0.05f + 0.1f * rng.uniform(); }
+
+        // Non-deterministic seed drawn once per process
+        static uint64_t process_seed()
+        {
+            static const uint64_t seed = utec::random::entropy_seed();
+            return seed;
+        }
 
     public:
-        EnvGym() : rng(std::random_device{}()),
-                   vel_dist(-0.05f, 0.05f)
+        EnvGym() : rng(process_seed(), utec::random::next_stream<utec::random::EnvStreams>())
         {
             // nop
         }
 
+        // Reproducible episodes: the same (seed, stream) always gives the same
+        // sequence of initial velocities. Use one stream per parallel env.
+        explicit EnvGym(uint64_t seed, uint32_t stream = 0) : rng(seed, stream)
+        {
+        }
+
         State reset()
         {
             // Initialize ball at center
@@ -40,8 +58,8 @@ namespace utec::nn
             ball_y = 0.5f;
 
             // Random initial velocity (mostly rightward)
-            ball_vx = 0.03f + vel_dist(rng);
-            ball_vy = vel_dist(rng);
+            ball_vx = 0.03f + vel_dist();
+            ball_vy = vel_dist();
 
             paddle_y = 0.5f;
             done_flag = false;
@@ -109,11 +127,157 @@ namespace utec::nn
             return get_state();
         }
 
+        // Frames that step() is guaranteed to run without a wall or paddle
+        // event, whatever the actions. The bound is analytic (distance over
+        // speed per axis) and conservative: every float add can round by at
+        // most 2^-24 in [0, 1], so that slack is added to each speed.
+        size_t frames_to_event() const
+        {
+            if (done_flag)
+                return 0;
+            return std::min(frames_inside(ball_x, ball_vx, ball_radius, 1.0f - paddle_width - ball_radius),
+                            frames_inside(ball_y, ball_vy, ball_radius, 1.0f - ball_radius));
+        }
+
+        // Holds `action` for up to `frames` frames (action repeat), stopping
+        // early when the episode ends. reward is the sum over the frames and
+        // stepped the number of frames run. The result is bit-identical to
+        // calling step() once per frame: collision-free stretches jump
+        // straight to their last frame (see accumulate) and the frame of
+        // each event goes through step() itself.
+        State step_repeat(int action, size_t frames, float &reward, bool &done, size_t &stepped)
+        {
+            if (frames == 1 && !done_flag)
+            {
+                stepped = 1;
+                return step(action, reward, done);
+            }
+            reward = 0;
+            done = done_flag;
+            stepped = 0;
+            while (stepped < frames && !done)
+            {
+                const size_t free = frames - stepped > 1 ? std::min(frames - stepped, frames_to_event()) : 0;
+                const float move = action * 0.04f;
+                if (free < jump_threshold)
+                {
+                    for (size_t i = 0; i < free; ++i)
+                    {
+                        paddle_y += move;
+                        paddle_y = std::max(0.1f, std::min(0.9f, paddle_y));
+                        ball_x += ball_vx;
+                        ball_y += ball_vy;
+                    }
+                }
+                else
+                {
+                    size_t n = free;
+                    ball_x = accumulate(ball_x, ball_vx, n, ball_vx > 0 ? HUGE_VALF : -HUGE_VALF);
+                    n = free;
+                    ball_y = accumulate(ball_y, ball_vy, n, ball_vy > 0 ? HUGE_VALF : -HUGE_VALF);
+                    // The paddle stops at the wall and stays there
+                    n = free;
+                    const float wall = move > 0 ? 0.9f : 0.1f;
+                    paddle_y = accumulate(paddle_y, move, n, wall);
+                    if (n > 0)
+                        paddle_y = wall;
+                }
+                stepped += free;
+                if (stepped < frames)
+                {
+                    float r;
+                    step(action, r, done);
+                    reward += r;
+                    ++stepped;
+                }
+            }
+            return get_state();
+        }
+
     private:
         State get_state() const
         {
             return {ball_x, ball_y, paddle_y};
         }
+
+        // Below this many free frames the plain per-frame adds are cheaper
+        // than the jumps (measured with bm_env_step_repeat)
+        static constexpr size_t jump_threshold = 64;
+
+        // x after up to n frames of `x += v` in float, stopping before the
+        // first result past `limit`; n is left with the frames not run.
+        //
+        // Inside one binade [2^(e-1), 2^e) floats are spaced u = 2^(e-24)
+        // apart, so while x + v lands in that binade it rounds to x + d with
+        // the same d = round(v / u) * u every frame: k frames add exactly
+        // k * d. A run therefore costs one jump per binade crossed instead
+        // of one add per frame. Ties (which round to even and alternate),
+        // speeds below u and non-positive x fall back to single adds.
+        static float accumulate(float x, float v, size_t &n, float limit)
+        {
+            if (v == 0.0f)
+            {
+                n = 0;
+                return x;
+            }
+            const double low = 8388608.0, high = 16777216.0; // 2^23, 2^24
+            while (n > 0)
+            {
+                // Spacing of the floats in the binade of x (exponent bits only)
+                const uint32_t exponent = std::bit_cast<uint32_t>(x) & 0x7F800000u;
+                const double u = std::bit_cast<float>(exponent) / low;
+                const double X = x / u, V = v / u, lim = limit / u; // Exact: powers of two
+                const double mag = std::fabs(V);
+                const double whole = mag < high ? static_cast<double>(static_cast<int64_t>(mag)) : mag;
+                size_t k = 0;
+                if (x > 0.0f && mag >= 1.0 && mag < high && mag - whole != 0.5)
+                {
+                    const double D = std::copysign(mag - whole > 0.5 ? whole + 1.0 : whole, V);
+                    // Frame j (1-based) is exact while X + (j-1) D + V stays in
+                    // the binade and X + j D does not pass the limit. Both
+                    // are linear in j, so checking the first and j-th frame
+                    // is enough; every term is exact in double.
+                    auto valid = [&](double j)
+                    {
+                        const double sum_first = X + V, sum_last = X + (j - 1) * D + V, result = X + j * D;
+                        return sum_first >= low && sum_first < high && sum_last >= low && sum_last < high &&
+                               (v > 0 ? result <= lim : result >= lim);
+                    };
+                    const double edge = v > 0 ? std::min(high - X - V, lim - X) : std::min(X + V - low, X - lim);
+                    const double guess = std::max(0.0, std::min(static_cast<double>(n), edge / std::fabs(D)));
+                    k = static_cast<size_t>(guess);
+                    while (k > 0 && !valid(static_cast<double>(k)))
+                        --k;
+                    while (k < n && valid(static_cast<double>(k + 1)))
+                        ++k;
+                    if (k > 0)
+                    {
+                        x = static_cast<float>((X + static_cast<double>(k) * D) * u);
+                        n -= k;
+                        continue;
+                    }
+                }
+                // One frame as step() does it (also crosses into the next binade)
+                const float next = x + v;
+                if (v > 0 ? next > limit : next < limit)
+                    return x;
+                x = next;
+                --n;
+            }
+            return x;
+        }
+
+        // Frames k >= 1 for which pos + k * vel (accumulated in float) stays
+        // strictly inside (low, high)
+        static size_t frames_inside(float pos, float vel, float low, float high)
+        {
+            if (!(pos > low && pos < high))
+                return 0;
+            const double slack = 5.9604644775390625e-8; // 2^-24
+            const double distance = vel > 0 ? static_cast<double>(high) - pos : pos - static_cast<double>(low);
+            const double bound = distance / (std::fabs(static_cast<double>(vel)) + slack);
+            return bound > 1.0 ? static_cast<size_t>(bound) - 1 : 0;
+        }
     };
 
 } // namespace utec::nn
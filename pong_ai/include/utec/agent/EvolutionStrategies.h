@@ -0,0 +1,297 @@
+#ifndef UTEC_AGENT_EVOLUTIONSTRATEGIES_H
+#define UTEC_AGENT_EVOLUTIONSTRATEGIES_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "PongAgent.h"
+#include "EnvGym.h"
+#include "../parallel/ThreadPool.h"
+#include "../random/Philox.h"
+
+namespace utec::nn
+{
+
+    struct ESConfig
+    {
+        size_t population = 64;     // Antithetic pairs per generation (2x evaluations)
+        float sigma = 0.5f;         // Perturbation scale
+        float learning_rate = 0.05f;
+        float weight_decay = 0.0f;
+        bool adam = true;           // Adam on the ES gradient estimate, else plain SGD
+        size_t episodes = 16;       // EnvGym episodes per fitness evaluation
+        size_t max_steps = 1000;    // Frame cap per episode
+        size_t action_repeat = 1;   // Frames each decision is held (EnvGym::step_repeat)
+        size_t workers = std::max(1u, std::thread::hardware_concurrency());
+        uint64_t seed = 1;
+        bool rank_shaping = true;   // Centered ranks instead of raw rewards
+    };
+
+    struct ESStats
+    {
+        size_t generation = 0;
+        float mean_fitness = 0; // Over all perturbed policies
+        float max_fitness = 0;
+        double seconds = 0;
+    };
+
+    // Total reward of one episode, capped at max_steps frames. With
+    // action_repeat > 1 the agent decides once every action_repeat frames.
+    template <typename T>
+    float run_episode(PongAgent<T> &agent, EnvGym &env, size_t max_steps, size_t action_repeat = 1)
+    {
+        State s = env.reset();
+        float total = 0;
+        float reward = 0;
+        bool done = false;
+        if (action_repeat <= 1)
+        {
+            for (size_t t = 0; t < max_steps && !done; ++t)
+            {
+                s = env.step(agent.act(s), reward, done);
+                total += reward;
+            }
+            return total;
+        }
+        size_t stepped = 0;
+        for (size_t t = 0; t < max_steps && !done; t += stepped)
+        {
+            s = env.step_repeat(agent.act(s), std::min(action_repeat, max_steps - t), reward, done, stepped);
+            total += reward;
+        }
+        return total;
+    }
+
+    // Gradient-free training on game reward (OpenAI-style evolution strategies).
+    //
+    // Each generation samples `population` noise vectors eps_i and evaluates
+    // theta + sigma * eps_i and theta - sigma * eps_i on the same batch of
+    // seeded episodes. Noise is never shipped around: eps_i is the Philox
+    // substream (seed, generation, i), regenerated by whoever needs it, so
+    // workers only return two fitness scalars per pair. The update is
+    //     g = sum_i (F+_i - F-_i) * eps_i / (2 * population * sigma)
+    // followed by an Adam (or SGD) step on theta. It is computed in a fixed
+    // order, so results do not depend on the number of workers.
+    template <typename T>
+    class EvolutionStrategies
+    {
+    public:
+        using ModelFactory = std::function<std::unique_ptr<utec::neural_network::ILayer<T>>()>;
+
+        EvolutionStrategies(ModelFactory factory, const ESConfig &config,
+                            utec::parallel::ThreadPool &pool)
+            : config_(config), pool_(pool)
+        {
+            if (config_.population == 0 || config_.episodes == 0 || config_.workers == 0)
+            {
+                throw std::invalid_argument("ES needs a positive population, episode count and worker count");
+            }
+            // One private model per worker slot: each slot loads its own
+            // perturbed parameters with establecer_parametros
+            for (size_t w = 0; w < config_.workers; ++w)
+            {
+                slots_.push_back(std::make_unique<Slot>(factory()));
+            }
+            theta_ = slots_[0]->agent.obtener_parametros();
+            if (theta_.empty())
+            {
+                throw std::invalid_argument("ES model has no parameters");
+            }
+            m_.assign(theta_.size(), T(0));
+            v_.assign(theta_.size(), T(0));
+            for (auto &slot : slots_)
+            {
+                slot->eps.resize(theta_.size());
+                slot->candidate.resize(theta_.size());
+            }
+        }
+
+        // Runs one generation and updates the parameters
+        ESStats step()
+        {
+            auto start = std::chrono::steady_clock::now();
+            const size_t pairs = config_.population;
+            std::vector<float> fitness(2 * pairs);
+
+            std::vector<std::future<void>> pending;
+            pending.reserve(slots_.size());
+            for (size_t w = 0; w < slots_.size(); ++w)
+            {
+                pending.push_back(pool_.enqueue([this, w, pairs, &fitness]
+                                                {
+                    Slot &slot = *slots_[w];
+                    for (size_t i = w; i < pairs; i += slots_.size())
+                    {
+                        fill_noise(slot.eps, i);
+                        fitness[2 * i] = evaluate_perturbed(slot, +config_.sigma);
+                        fitness[2 * i + 1] = evaluate_perturbed(slot, -config_.sigma);
+                    } }));
+            }
+            // Workers write into fitness until they are all done
+            utec::parallel::wait_all(pending);
+
+            // Only the scalars come back; the gradient regenerates the noise
+            std::vector<float> weights = fitness_weights(fitness);
+            std::vector<T> grad(theta_.size(), T(0));
+            std::vector<T> eps(theta_.size());
+            for (size_t i = 0; i < pairs; ++i)
+            {
+                const T w = static_cast<T>(weights[2 * i] - weights[2 * i + 1]);
+                if (w == T(0))
+                    continue;
+                fill_noise(eps, i);
+                for (size_t k = 0; k < grad.size(); ++k)
+                    grad[k] += w * eps[k];
+            }
+
+            const T scale = static_cast<T>(1.0 / (2.0 * pairs * config_.sigma));
+            const T lr = static_cast<T>(config_.learning_rate);
+            const T decay = static_cast<T>(config_.weight_decay);
+            if (config_.adam)
+            {
+                // Bias-corrected Adam step (beta1 = 0.9, beta2 = 0.999)
+                const T b1 = T(0.9), b2 = T(0.999);
+                const T c1 = T(1) - std::pow(b1, static_cast<T>(generation_ + 1));
+                const T c2 = T(1) - std::pow(b2, static_cast<T>(generation_ + 1));
+                for (size_t k = 0; k < theta_.size(); ++k)
+                {
+                    const T g = scale * grad[k] - decay * theta_[k];
+                    m_[k] = b1 * m_[k] + (T(1) - b1) * g;
+                    v_[k] = b2 * v_[k] + (T(1) - b2) * g * g;
+                    theta_[k] += lr * (m_[k] / c1) / (std::sqrt(v_[k] / c2) + T(1e-8));
+                }
+            }
+            else
+            {
+                for (size_t k = 0; k < theta_.size(); ++k)
+                    theta_[k] += lr * (scale * grad[k] - decay * theta_[k]);
+            }
+
+            ESStats stats;
+            stats.generation = generation_++;
+            stats.mean_fitness = std::accumulate(fitness.begin(), fitness.end(), 0.0f) / fitness.size();
+            stats.max_fitness = *std::max_element(fitness.begin(), fitness.end());
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return stats;
+        }
+
+        // Mean reward of the current (unperturbed) parameters on `episodes`
+        // seeded episodes. Runs on the calling thread.
+        float evaluate(size_t episodes, uint64_t seed)
+        {
+            Slot &slot = *slots_[0];
+            slot.agent.establecer_parametros(theta_);
+            float total = 0;
+            for (size_t e = 0; e < episodes; ++e)
+            {
+                EnvGym env(seed, static_cast<uint32_t>(e));
+                total += run_episode(slot.agent, env, config_.max_steps, config_.action_repeat);
+            }
+            return total / static_cast<float>(episodes);
+        }
+
+        const std::vector<T> &parameters() const { return theta_; }
+
+        void set_parameters(const std::vector<T> &params)
+        {
+            if (params.size() != theta_.size())
+            {
+                throw std::invalid_argument("Parameter count mismatch");
+            }
+            theta_ = params;
+        }
+
+        size_t generation() const { return generation_; }
+        const ESConfig &config() const { return config_; }
+
+    private:
+        struct Slot
+        {
+            explicit Slot(std::unique_ptr<utec::neural_network::ILayer<T>> model)
+                : agent(std::move(model)) {}
+            PongAgent<T> agent;
+            std::vector<T> eps;       // Noise of the pair being evaluated
+            std::vector<T> candidate; // theta +/- sigma * eps
+        };
+
+        // splitmix64 finalizer over the combined key
+        static uint64_t mix(uint64_t a, uint64_t b)
+        {
+            uint64_t z = a + 0x9E3779B97F4A7C15ull * (b + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // Noise of pair i in the current generation
+        void fill_noise(std::vector<T> &eps, size_t i) const
+        {
+            utec::random::Philox rng(config_.seed, static_cast<uint32_t>(generation_),
+                                     static_cast<uint32_t>(i));
+            rng.fill_normal(eps.data(), eps.size());
+        }
+
+        float evaluate_perturbed(Slot &slot, float sign_sigma)
+        {
+            const T s = static_cast<T>(sign_sigma);
+            for (size_t k = 0; k < theta_.size(); ++k)
+                slot.candidate[k] = theta_[k] + s * slot.eps[k];
+            slot.agent.establecer_parametros(slot.candidate);
+
+            // Every member of a generation plays the same episodes
+            // (common random numbers), which keeps F+ - F- low-variance
+            const uint64_t episode_seed = mix(config_.seed ^ 0xE5E5E5E5ull, generation_);
+            float total = 0;
+            for (size_t e = 0; e < config_.episodes; ++e)
+            {
+                EnvGym env(episode_seed, static_cast<uint32_t>(e));
+                total += run_episode(slot.agent, env, config_.max_steps, config_.action_repeat);
+            }
+            return total / static_cast<float>(config_.episodes);
+        }
+
+        // Raw fitness, or centered ranks in [-0.5, 0.5] (ties share a rank)
+        std::vector<float> fitness_weights(const std::vector<float> &fitness) const
+        {
+            if (!config_.rank_shaping)
+                return fitness;
+
+            const size_t n = fitness.size();
+            std::vector<size_t> order(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                             { return fitness[a] < fitness[b]; });
+
+            std::vector<float> ranks(n);
+            for (size_t i = 0; i < n;)
+            {
+                size_t j = i;
+                while (j < n && fitness[order[j]] == fitness[order[i]])
+                    ++j;
+                float rank = 0.5f * static_cast<float>(i + j - 1); // Average rank of the tie
+                for (size_t k = i; k < j; ++k)
+                    ranks[order[k]] = n > 1 ? rank / (n - 1) - 0.5f : 0.0f;
+                i = j;
+            }
+            return ranks;
+        }
+
+        ESConfig config_;
+        utec::parallel::ThreadPool &pool_;
+        std::vector<std::unique_ptr<Slot>> slots_;
+        std::vector<T> theta_;
+        std::vector<T> m_, v_; // Adam moments
+        size_t generation_ = 0;
+    };
+
+} // namespace utec::nn
+
+#endif // UTEC_AGENT_EVOLUTIONSTRATEGIES_H
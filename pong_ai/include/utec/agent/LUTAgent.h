@@ -0,0 +1,308 @@
+#ifndef UTEC_AGENT_LUTAGENT_H
+#define UTEC_AGENT_LUTAGENT_H
+
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "PongAgent.h"
+#include "State.h"
+#include "../parallel/ThreadPool.h"
+#include "../random/Philox.h"
+
+namespace utec::nn
+{
+
+    // Cells per axis of the decision grid over [0, 1]^3
+    struct LUTResolution
+    {
+        size_t ball_x = 64;
+        size_t ball_y = 64;
+        size_t paddle_y = 64;
+    };
+
+    // How often a LUTAgent picks the network's action.
+    // confusion[net + 1][lut + 1] counts states by (network, LUT) action.
+    struct LUTAgreement
+    {
+        size_t samples = 0;
+        size_t matches = 0;
+        size_t confusion[3][3] = {};
+
+        double rate() const { return samples == 0 ? 1.0 : static_cast<double>(matches) / samples; }
+    };
+
+    // A trained policy compiled into a quantized decision grid.
+    //
+    // compile() evaluates the network at the center of every cell (in
+    // parallel, one ball_x slab per task, batched through act_batch) and
+    // stores each (ball_x, ball_y) row along paddle_y as runs of equal
+    // actions. Decision regions of a small MLP are large and smooth, so a
+    // row holds a handful of runs and act() is a quantization, one row
+    // lookup and a short scan: a few nanoseconds, no floating-point math.
+    //
+    // The result is exact at cell centers; elsewhere it differs from the
+    // network only in cells that a decision boundary crosses, which
+    // agreement() measures.
+    class LUTAgent
+    {
+    public:
+        static constexpr size_t max_resolution = 65535; // Run ends are 16-bit
+
+        // Empty until assigned from compile() or load()
+        LUTAgent() = default;
+
+        template <typename T>
+        static LUTAgent compile(PongAgent<T> &agent, const LUTResolution &resolution)
+        {
+            return compile_impl(agent, resolution, nullptr);
+        }
+
+        template <typename T>
+        static LUTAgent compile(PongAgent<T> &agent, const LUTResolution &resolution,
+                                utec::parallel::ThreadPool &pool)
+        {
+            return compile_impl(agent, resolution, &pool);
+        }
+
+        // Same values as PongAgent::act: +1 down, 0 stay, -1 up. States
+        // outside [0, 1] use the nearest cell.
+        int act(const State &s) const
+        {
+            const size_t row = cell(s.ball_x, res_.ball_x) * res_.ball_y + cell(s.ball_y, res_.ball_y);
+            const size_t k = cell(s.paddle_y, res_.paddle_y);
+            // Run ends increase and the last one is paddle_y, so this stops
+            size_t r = row_start_[row];
+            while (run_ends_[r] <= k)
+                ++r;
+            return run_actions_[r];
+        }
+
+        template <typename T>
+        LUTAgreement agreement(PongAgent<T> &agent, const std::vector<State> &states) const
+        {
+            LUTAgreement report;
+            const std::vector<int> expected = agent.act_batch(states);
+            for (size_t i = 0; i < states.size(); ++i)
+            {
+                const int got = act(states[i]);
+                ++report.confusion[expected[i] + 1][got + 1];
+                report.matches += got == expected[i];
+            }
+            report.samples = states.size();
+            return report;
+        }
+
+        // Agreement over `samples` states drawn uniformly from [0, 1]^3
+        template <typename T>
+        LUTAgreement agreement(PongAgent<T> &agent, size_t samples, uint64_t seed) const
+        {
+            utec::random::Philox rng(seed);
+            std::vector<float> coords(3 * samples);
+            rng.fill_uniform(coords.data(), coords.size());
+            std::vector<State> states(samples);
+            for (size_t i = 0; i < samples; ++i)
+                states[i] = {coords[3 * i], coords[3 * i + 1], coords[3 * i + 2]};
+            return agreement(agent, states);
+        }
+
+        bool empty() const { return row_start_.empty(); }
+        const LUTResolution &resolution() const { return res_; }
+        size_t cells() const { return res_.ball_x * res_.ball_y * res_.paddle_y; }
+        size_t runs() const { return run_ends_.size(); }
+
+        // Memory of the compressed table (a dense one takes cells() bytes)
+        size_t bytes() const
+        {
+            return row_start_.size() * sizeof(uint32_t) + run_ends_.size() * (sizeof(uint16_t) + sizeof(int8_t));
+        }
+
+        // Binary file in native byte order. Returns false on I/O errors.
+        bool save(const std::string &path) const
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            const uint32_t header[5] = {file_magic, static_cast<uint32_t>(res_.ball_x),
+                                        static_cast<uint32_t>(res_.ball_y), static_cast<uint32_t>(res_.paddle_y),
+                                        static_cast<uint32_t>(run_ends_.size())};
+            out.write(reinterpret_cast<const char *>(header), sizeof(header));
+            write_vector(out, row_start_);
+            write_vector(out, run_ends_);
+            write_vector(out, run_actions_);
+            return static_cast<bool>(out.flush());
+        }
+
+        // Returns false (and leaves lut untouched) if the file is not a valid table
+        static bool load(const std::string &path, LUTAgent &lut)
+        {
+            std::ifstream in(path, std::ios::binary);
+            uint32_t header[5];
+            if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != file_magic)
+                return false;
+            LUTAgent loaded;
+            loaded.res_ = {header[1], header[2], header[3]};
+            if (!valid(loaded.res_))
+                return false;
+            loaded.row_start_.resize(header[1] * static_cast<size_t>(header[2]) + 1);
+            loaded.run_ends_.resize(header[4]);
+            loaded.run_actions_.resize(header[4]);
+            if (!read_vector(in, loaded.row_start_) || !read_vector(in, loaded.run_ends_) ||
+                !read_vector(in, loaded.run_actions_) || !loaded.consistent())
+                return false;
+            lut = std::move(loaded);
+            return true;
+        }
+
+    private:
+        static constexpr uint32_t file_magic = 0x54554C50; // "PLUT"
+
+        static bool valid(const LUTResolution &r)
+        {
+            return r.ball_x > 0 && r.ball_y > 0 && r.paddle_y > 0 && r.ball_x <= max_resolution &&
+                   r.ball_y <= max_resolution && r.paddle_y <= max_resolution;
+        }
+
+        // Cell of v in [0, 1] on an n-cell axis; out of range (or NaN) clamps
+        static size_t cell(float v, size_t n)
+        {
+            if (!(v > 0.0f))
+                return 0;
+            if (v >= 1.0f)
+                return n - 1;
+            const size_t c = static_cast<size_t>(v * static_cast<float>(n));
+            return c < n ? c : n - 1;
+        }
+
+        static float center(size_t c, size_t n)
+        {
+            return (static_cast<float>(c) + 0.5f) / static_cast<float>(n);
+        }
+
+        // Runs of the rows of one ball_x slab
+        struct Slab
+        {
+            std::vector<uint32_t> row_runs; // Runs per row
+            std::vector<uint16_t> ends;
+            std::vector<int8_t> actions;
+        };
+
+        template <typename T>
+        static Slab compile_slab(PongAgent<T> &agent, const LUTResolution &r, size_t i)
+        {
+            std::vector<State> states;
+            states.reserve(r.ball_y * r.paddle_y);
+            for (size_t j = 0; j < r.ball_y; ++j)
+            {
+                for (size_t k = 0; k < r.paddle_y; ++k)
+                    states.push_back({center(i, r.ball_x), center(j, r.ball_y), center(k, r.paddle_y)});
+            }
+            const std::vector<int> actions = agent.act_batch(states);
+
+            Slab slab;
+            slab.row_runs.reserve(r.ball_y);
+            for (size_t j = 0; j < r.ball_y; ++j)
+            {
+                const int *row = actions.data() + j * r.paddle_y;
+                uint32_t runs = 0;
+                for (size_t k = 0; k < r.paddle_y; ++k)
+                {
+                    if (k + 1 == r.paddle_y || row[k + 1] != row[k])
+                    {
+                        slab.ends.push_back(static_cast<uint16_t>(k + 1));
+                        slab.actions.push_back(static_cast<int8_t>(row[k]));
+                        ++runs;
+                    }
+                }
+                slab.row_runs.push_back(runs);
+            }
+            return slab;
+        }
+
+        template <typename T>
+        static LUTAgent compile_impl(PongAgent<T> &agent, const LUTResolution &resolution,
+                                     utec::parallel::ThreadPool *pool)
+        {
+            if (!valid(resolution))
+                throw std::invalid_argument("LUT resolution must be between 1 and 65535 cells per axis");
+
+            // One task per ball_x slab; inline from a worker of the pool
+            std::vector<Slab> slabs(resolution.ball_x);
+            if (pool != nullptr && utec::parallel::ThreadPool::current_worker() < 0)
+            {
+                std::vector<std::future<void>> pending;
+                pending.reserve(slabs.size());
+                for (size_t i = 0; i < slabs.size(); ++i)
+                {
+                    pending.push_back(pool->enqueue([&agent, &resolution, &slabs, i]
+                                                    { slabs[i] = compile_slab(agent, resolution, i); }));
+                }
+                // Tasks write into slabs until they are all done
+                utec::parallel::wait_all(pending);
+            }
+            else
+            {
+                for (size_t i = 0; i < slabs.size(); ++i)
+                    slabs[i] = compile_slab(agent, resolution, i);
+            }
+
+            // Slabs in order: identical tables with and without the pool
+            LUTAgent lut;
+            lut.res_ = resolution;
+            lut.row_start_.reserve(resolution.ball_x * resolution.ball_y + 1);
+            uint32_t offset = 0;
+            for (const Slab &slab : slabs)
+            {
+                for (uint32_t runs : slab.row_runs)
+                {
+                    lut.row_start_.push_back(offset);
+                    offset += runs;
+                }
+                lut.run_ends_.insert(lut.run_ends_.end(), slab.ends.begin(), slab.ends.end());
+                lut.run_actions_.insert(lut.run_actions_.end(), slab.actions.begin(), slab.actions.end());
+            }
+            lut.row_start_.push_back(offset);
+            return lut;
+        }
+
+        // Every row ends exactly at paddle_y with increasing run ends
+        bool consistent() const
+        {
+            if (row_start_.empty() || row_start_.front() != 0 || row_start_.back() != run_ends_.size())
+                return false;
+            for (size_t row = 0; row + 1 < row_start_.size(); ++row)
+            {
+                const uint32_t begin = row_start_[row], end = row_start_[row + 1];
+                if (begin >= end || end > run_ends_.size() || run_ends_[end - 1] != res_.paddle_y)
+                    return false;
+                for (uint32_t r = begin; r < end; ++r)
+                {
+                    if ((r > begin && run_ends_[r] <= run_ends_[r - 1]) || run_actions_[r] < -1 || run_actions_[r] > 1)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename V>
+        static void write_vector(std::ofstream &out, const std::vector<V> &v)
+        {
+            out.write(reinterpret_cast<const char *>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(V)));
+        }
+
+        template <typename V>
+        static bool read_vector(std::ifstream &in, std::vector<V> &v)
+        {
+            return static_cast<bool>(
+                in.read(reinterpret_cast<char *>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(V))));
+        }
+
+        LUTResolution res_;
+        std::vector<uint32_t> row_start_;   // First run of each (ball_x, ball_y) row, plus the total
+        std::vector<uint16_t> run_ends_;    // Exclusive paddle_y cell where each run ends
+        std::vector<int8_t> run_actions_;   // Action of each run
+    };
+
+} // namespace utec::nn
+
+#endif // UTEC_AGENT_LUTAGENT_H
@@ -2,10 +2,14 @@
 #define UTEC_AGENT_PONGAGENT_H
 
 #include "../nn/neural_network.h"
+#include "../algebra/Reduce.h"
+#include "../parallel/Rcu.h"
 #include "EnvGym.h"
 #include "State.h"
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <vector>
 
 namespace utec::nn
 {
@@ -14,41 +18,35 @@ namespace utec::nn
     class PongAgent
     {
     private:
-        std::unique_ptr<utec::neural_network::ILayer<T>> model;
+        using Model = utec::neural_network::ILayer<T>;
 
-    public:
-        PongAgent(std::unique_ptr<utec::neural_network::ILayer<T>> m)
-            : model(std::move(m)) {}
+        // Published model: act() runs on a snapshot, so new weights can be
+        // swapped in while other threads keep answering
+        utec::parallel::RcuCell<Model> model;
+        std::unique_ptr<Model> spare; // Previous version, reused by the next update
+        std::mutex update_mutex;      // Serializes writers (spare)
 
-        int act(const State &s)
+        // Builds the next version in spare and publishes it; the version it
+        // replaces comes back as the new spare once no act() uses it
+        void publish_spare()
         {
-            // Convert state to tensor (batch size 1, 3 features)
-            utec::algebra::Tensor<T, 2> input(1, 3);
-            input(0, 0) = static_cast<T>(s.ball_x);
-            input(0, 1) = static_cast<T>(s.ball_y);
-            input(0, 2) = static_cast<T>(s.paddle_y);
-
-            // Forward pass through the model
-            utec::algebra::Tensor<T, 2> output = model->forward(input);
+            spare->prepare_inference();
+            spare = model.exchange(std::move(spare));
+        }
 
+        static void check_output(const utec::algebra::Tensor<T, 2> &output)
+        {
             // Handle different output dimensions
             if (output.shape()[1] < 3)
             {
                 throw std::runtime_error("Model output must have at least 3 columns");
             }
+        }
 
+        static int to_action(const T *scores)
+        {
             // Get action with highest probability in the first 3 columns
-            int action_index = 0;
-            T max_val = output(0, 0);
-
-            for (int i = 1; i < 3; i++)
-            {
-                if (output(0, i) > max_val)
-                {
-                    max_val = output(0, i);
-                    action_index = i;
-                }
-            }
+            const size_t action_index = utec::algebra::argmax(scores, 3);
 
             // Map to action: 0 = down, 1 = stay, 2 = up
             // But the test expects: +1 = up, -1 = down
@@ -59,15 +57,108 @@ namespace utec::nn
             return 0;      // stay
         }
 
+    public:
+        PongAgent(std::unique_ptr<utec::neural_network::ILayer<T>> m)
+            : model(std::move(m))
+        {
+            model.read()->prepare_inference();
+        }
+
+        int act(const State &s)
+        {
+            // Convert state to tensor (batch size 1, 3 features)
+            utec::algebra::Tensor<T, 2> input(1, 3);
+            input(0, 0) = static_cast<T>(s.ball_x);
+            input(0, 1) = static_cast<T>(s.ball_y);
+            input(0, 2) = static_cast<T>(s.paddle_y);
+
+            // Inference pass: nothing is cached for backward, so concurrent
+            // act() calls (ParallelPongAgent::act_async) do not race, and
+            // Dense layers run their packed batch-1 kernels
+            utec::algebra::Tensor<T, 2> output;
+            {
+                auto snapshot = model.read();
+                snapshot->infer_into(input, output);
+            }
+
+            check_output(output);
+            return to_action(output.data());
+        }
+
+        // One inference pass for `count` states (e.g. requests batched by the
+        // policy server); actions[i] is what act(states[i]) would return
+        void act_batch(const State *states, size_t count, int *actions)
+        {
+            if (count == 0)
+                return;
+            utec::algebra::Tensor<T, 2> input(count, 3);
+            for (size_t i = 0; i < count; ++i)
+            {
+                input(i, 0) = static_cast<T>(states[i].ball_x);
+                input(i, 1) = static_cast<T>(states[i].ball_y);
+                input(i, 2) = static_cast<T>(states[i].paddle_y);
+            }
+
+            utec::algebra::Tensor<T, 2> output;
+            {
+                auto snapshot = model.read();
+                snapshot->infer_into(input, output);
+            }
+            check_output(output);
+            const size_t columns = output.shape()[1];
+            for (size_t i = 0; i < count; ++i)
+                actions[i] = to_action(output.data() + i * columns);
+        }
+
+        std::vector<int> act_batch(const std::vector<State> &states)
+        {
+            std::vector<int> actions(states.size());
+            act_batch(states.data(), states.size(), actions.data());
+            return actions;
+        }
+
         // Nuevos métodos
         std::vector<T> obtener_parametros()
         {
-            return model->obtener_parametros();
+            return model.read()->obtener_parametros();
         }
 
+        // Hot swap: the parameters go into a copy of the model that replaces
+        // the published one atomically. act() calls in flight finish on the
+        // old weights, later ones see all of the new ones, never a mix.
+        // After the first update the copy is recycled (double buffering).
         void establecer_parametros(const std::vector<T> &params)
         {
-            model->establecer_parametros(params);
+            std::lock_guard<std::mutex> lock(update_mutex);
+            if (!spare)
+                spare = model.read()->clone();
+            if (!spare)
+            {
+                // Model without clone(): updated in place, not safe against
+                // concurrent act()
+                model.read()->establecer_parametros(params);
+                return;
+            }
+            spare->establecer_parametros(params);
+            publish_spare();
+        }
+
+        // Replaces the whole model (e.g. one loaded from a checkpoint)
+        void publish_model(std::unique_ptr<utec::neural_network::ILayer<T>> next)
+        {
+            if (!next)
+                throw std::invalid_argument("publish_model needs a model");
+            std::lock_guard<std::mutex> lock(update_mutex);
+            spare = std::move(next);
+            publish_spare();
+            // The old model may not match the new structure
+            spare.reset();
+        }
+
+        // Number of models published so far, starting at 1
+        uint64_t model_version() const
+        {
+            return model.version();
         }
     };
 
@@ -0,0 +1,386 @@
+#ifndef UTEC_ALGEBRA_ALLOCATOR_H
+#define UTEC_ALGEBRA_ALLOCATOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "../parallel/Affinity.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Storage allocators for Tensor (third template parameter).
+//
+//     Tensor<float, 2> a(rows, cols);                             // 64-byte aligned
+//     Tensor<float, 2, HugePageAllocator<float>> acts(4096, 1024); // THP-backed
+//     Tensor<float, 2, PoolAllocator<float>> scratch(batch, width); // recycled
+//
+// Every allocator returns at least cache-line aligned memory, so kernels
+// can rely on data() starting a cache line (and a full AVX-512 vector).
+// They are stateless and interchangeable between equal types, as std::vector
+// requires; the NUMA and huge-page variants fall back to plain aligned
+// allocation on platforms without the corresponding system calls.
+
+namespace utec::algebra
+{
+
+    using utec::parallel::cache_line;
+    constexpr size_t huge_page_size = size_t{2} << 20;
+
+    namespace detail
+    {
+        inline void *aligned_new(size_t bytes, size_t align)
+        {
+            return ::operator new(bytes, std::align_val_t(align));
+        }
+
+        inline void aligned_delete(void *p, size_t align) noexcept
+        {
+            ::operator delete(p, std::align_val_t(align));
+        }
+
+        template <typename T>
+        size_t checked_bytes(size_t n)
+        {
+            if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+                throw std::bad_array_new_length();
+            return n * sizeof(T);
+        }
+
+        inline size_t round_up(size_t bytes, size_t multiple)
+        {
+            return (bytes + multiple - 1) / multiple * multiple;
+        }
+
+        // Common allocator boilerplate; Derived provides allocate/deallocate
+        template <typename T, template <typename> class Derived>
+        struct AllocatorBase
+        {
+            using value_type = T;
+            using is_always_equal = std::true_type;
+
+            template <typename U>
+            struct rebind
+            {
+                using other = Derived<U>;
+            };
+        };
+    } // namespace detail
+
+    // Plain over-aligned allocation (the Tensor default)
+    template <typename T, size_t Align = cache_line>
+    class AlignedAllocator
+    {
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+        static constexpr size_t alignment = std::max(Align, alignof(T));
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Align>;
+        };
+
+        AlignedAllocator() noexcept = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Align> &) noexcept {}
+
+        T *allocate(size_t n)
+        {
+            return static_cast<T *>(detail::aligned_new(detail::checked_bytes<T>(n), alignment));
+        }
+
+        void deallocate(T *p, size_t) noexcept
+        {
+            detail::aligned_delete(p, alignment);
+        }
+    };
+
+    template <typename T, typename U, size_t Align>
+    bool operator==(const AlignedAllocator<T, Align> &, const AlignedAllocator<U, Align> &) noexcept
+    {
+        return true;
+    }
+
+    // Buffers of at least one huge page are 2 MB aligned and advised for
+    // transparent huge pages, so a large activation or weight matrix needs
+    // one TLB entry per 2 MB instead of per 4 KB. Smaller buffers are
+    // ordinary aligned allocations.
+    template <typename T>
+    class HugePageAllocator : public detail::AllocatorBase<T, HugePageAllocator>
+    {
+    public:
+        HugePageAllocator() noexcept = default;
+        template <typename U>
+        HugePageAllocator(const HugePageAllocator<U> &) noexcept {}
+
+        T *allocate(size_t n)
+        {
+            const size_t bytes = detail::checked_bytes<T>(n);
+            if (bytes < huge_page_size)
+                return static_cast<T *>(detail::aligned_new(bytes, cache_line));
+            const size_t rounded = detail::round_up(bytes, huge_page_size);
+            void *p = std::aligned_alloc(huge_page_size, rounded);
+            if (p == nullptr)
+                throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            // Advisory only: without THP support the buffer is just 2 MB aligned
+            madvise(p, rounded, MADV_HUGEPAGE);
+#endif
+            return static_cast<T *>(p);
+        }
+
+        void deallocate(T *p, size_t n) noexcept
+        {
+            if (n * sizeof(T) < huge_page_size)
+                detail::aligned_delete(p, cache_line);
+            else
+                std::free(p);
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const HugePageAllocator<T> &, const HugePageAllocator<U> &) noexcept
+    {
+        return true;
+    }
+
+    namespace detail
+    {
+        // NUMA node of the CPU the calling thread runs on, or -1
+        inline int current_numa_node() noexcept
+        {
+#if defined(__linux__) && defined(SYS_getcpu)
+            unsigned cpu = 0, node = 0;
+            if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+                return static_cast<int>(node);
+#endif
+            return -1;
+        }
+    } // namespace detail
+
+    // Pages placed on the NUMA node of the allocating thread, even when
+    // another thread touches them first (a worker filling a tensor that
+    // the owner then reads). Buffers smaller than numa_min_bytes, and
+    // systems without mbind, get ordinary aligned memory, which the kernel
+    // places on first touch.
+    template <typename T>
+    class NumaLocalAllocator : public detail::AllocatorBase<T, NumaLocalAllocator>
+    {
+    public:
+        static constexpr size_t numa_min_bytes = size_t{64} << 10;
+
+        NumaLocalAllocator() noexcept = default;
+        template <typename U>
+        NumaLocalAllocator(const NumaLocalAllocator<U> &) noexcept {}
+
+        T *allocate(size_t n)
+        {
+            const size_t bytes = detail::checked_bytes<T>(n);
+#if defined(__linux__) && defined(SYS_mbind)
+            if (bytes >= numa_min_bytes)
+            {
+                const size_t rounded = detail::round_up(bytes, page_size());
+                void *p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (p == MAP_FAILED)
+                    throw std::bad_alloc();
+                // Preferred, not strict: falls back to other nodes when the local one is full
+                utec::parallel::bind_memory_to_node(p, rounded, detail::current_numa_node());
+                return static_cast<T *>(p);
+            }
+#endif
+            return static_cast<T *>(detail::aligned_new(bytes, cache_line));
+        }
+
+        void deallocate(T *p, size_t n) noexcept
+        {
+#if defined(__linux__) && defined(SYS_mbind)
+            if (n * sizeof(T) >= numa_min_bytes)
+            {
+                munmap(p, detail::round_up(n * sizeof(T), page_size()));
+                return;
+            }
+#endif
+            (void)n;
+            detail::aligned_delete(p, cache_line);
+        }
+
+    private:
+        static size_t page_size() noexcept
+        {
+#if defined(__linux__)
+            static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            return size;
+#else
+            return 4096;
+#endif
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const NumaLocalAllocator<T> &, const NumaLocalAllocator<U> &) noexcept
+    {
+        return true;
+    }
+
+    namespace detail
+    {
+        // Per-thread free lists of power-of-two blocks (64 B .. 64 MB).
+        // A block freed on another thread than the one that allocated it
+        // simply joins that thread's cache: every block comes from the same
+        // aligned operator new, so any thread can hand it out or release it.
+        class SizeClassCache
+        {
+        public:
+            static constexpr size_t min_shift = 6;
+            static constexpr size_t max_shift = 26;
+            static constexpr size_t max_cached_bytes = size_t{64} << 20;
+
+            // The calling thread's cache, or nullptr once it has been
+            // destroyed (tensors freed by later thread_local/static destructors)
+            static SizeClassCache *local()
+            {
+                if (destroyed())
+                    return nullptr;
+                thread_local SizeClassCache cache;
+                return &cache;
+            }
+
+            ~SizeClassCache()
+            {
+                destroyed() = true;
+                for (auto &list : free_)
+                {
+                    for (void *p : list)
+                        aligned_delete(p, cache_line);
+                }
+            }
+
+            // Size class of a request, or -1 when it is too large to pool
+            static int size_class(size_t bytes) noexcept
+            {
+                size_t shift = min_shift;
+                while ((size_t{1} << shift) < bytes)
+                    ++shift;
+                return shift > max_shift ? -1 : static_cast<int>(shift - min_shift);
+            }
+
+            void *allocate(size_t bytes)
+            {
+                const int c = size_class(bytes);
+                if (c < 0)
+                    return aligned_new(bytes, cache_line);
+                auto &list = free_[c];
+                if (!list.empty())
+                {
+                    void *p = list.back();
+                    list.pop_back();
+                    cached_ -= block_bytes(c);
+                    ++hits_;
+                    return p;
+                }
+                ++misses_;
+                return aligned_new(block_bytes(c), cache_line);
+            }
+
+            void deallocate(void *p, size_t bytes) noexcept
+            {
+                const int c = size_class(bytes);
+                if (c >= 0 && cached_ + block_bytes(c) <= max_cached_bytes)
+                {
+                    try
+                    {
+                        free_[c].push_back(p);
+                        cached_ += block_bytes(c);
+                        return;
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+                aligned_delete(p, cache_line);
+            }
+
+            size_t cached_bytes() const noexcept { return cached_; }
+            size_t hits() const noexcept { return hits_; }
+            size_t misses() const noexcept { return misses_; }
+
+        private:
+            static bool &destroyed() noexcept
+            {
+                thread_local bool flag = false;
+                return flag;
+            }
+
+            static size_t block_bytes(int c) noexcept { return size_t{1} << (c + min_shift); }
+
+            std::array<std::vector<void *>, max_shift - min_shift + 1> free_;
+            size_t cached_ = 0;
+            size_t hits_ = 0, misses_ = 0;
+        };
+    } // namespace detail
+
+    // Recycles freed buffers by power-of-two size class, so tensors that are
+    // created and dropped every step (batch temporaries, gradients) stop
+    // reaching the system allocator after the first iteration. Each thread
+    // keeps up to 64 MB of free blocks.
+    template <typename T>
+    class PoolAllocator : public detail::AllocatorBase<T, PoolAllocator>
+    {
+    public:
+        PoolAllocator() noexcept = default;
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+        T *allocate(size_t n)
+        {
+            const size_t bytes = detail::checked_bytes<T>(n);
+            if (auto *cache = detail::SizeClassCache::local())
+                return static_cast<T *>(cache->allocate(bytes));
+            return static_cast<T *>(detail::aligned_new(bytes, cache_line));
+        }
+
+        void deallocate(T *p, size_t n) noexcept
+        {
+            if (auto *cache = detail::SizeClassCache::local())
+                cache->deallocate(p, n * sizeof(T));
+            else
+                detail::aligned_delete(p, cache_line);
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &) noexcept
+    {
+        return true;
+    }
+
+    // Row length (in elements) for a private row-major buffer of `cols`
+    // columns: rounded up to whole cache lines, plus one more line when a
+    // row would be a multiple of 1 KB. Power-of-two widths otherwise put
+    // the same column of consecutive rows in the same few L1 sets, and a
+    // kernel walking down a column thrashes them.
+    template <typename T>
+    size_t padded_leading_dim(size_t cols) noexcept
+    {
+        const size_t per_line = std::max<size_t>(1, cache_line / sizeof(T));
+        size_t ld = (cols + per_line - 1) / per_line * per_line;
+        if (ld > per_line && (ld * sizeof(T)) % 1024 == 0)
+            ld += per_line;
+        return ld;
+    }
+
+} // namespace utec::algebra
+
+#endif // UTEC_ALGEBRA_ALLOCATOR_H
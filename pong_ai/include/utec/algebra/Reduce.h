@@ -0,0 +1,576 @@
+#ifndef UTEC_ALGEBRA_REDUCE_H
+#define UTEC_ALGEBRA_REDUCE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Tensor.h"
+#include "../parallel/ThreadPool.h"
+
+// Reductions over Tensor: whole-tensor sum/max/mean and the same plus argmax
+// along one axis. Axis results keep the reduced dimension with extent 1, so
+// they broadcast straight back against the input (x - max(x, 1)).
+//
+// Sums are pairwise: blocks of up to 256 elements are added with 8
+// independent partial sums (vectorizable without -ffast-math), and block
+// sums are combined as a binary tree, so the rounding error grows with
+// log(n) rather than n. Along a non-innermost axis whole rows are added
+// elementwise, in blocks of 64 rows combined the same way.
+//
+// Every overload taking a ThreadPool splits the work into pieces whose size
+// does not depend on the pool, so parallel and serial results are
+// bit-identical. Those overloads must not be called from a worker of the
+// same pool (they run inline there instead of blocking it).
+
+namespace utec::algebra
+{
+
+    namespace detail
+    {
+        constexpr size_t reduce_block = 256;    // Elements per leaf of a pairwise sum
+        constexpr size_t reduce_row_block = 64; // Rows per leaf of a row-wise pairwise sum
+        constexpr size_t reduce_chunk = 64;     // Leaves per parallel task of a full sum
+        constexpr size_t parallel_threshold = size_t{1} << 16;
+
+        // Sum of p[0..n), n <= reduce_block
+        template <typename T>
+        T block_sum(const T *p, size_t n)
+        {
+            T acc[8] = {};
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                for (size_t j = 0; j < 8; ++j)
+                    acc[j] += p[i + j];
+            }
+            T tail = 0;
+            for (; i < n; ++i)
+                tail += p[i];
+            return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7])) + tail;
+        }
+
+        // Pairwise combination of a stream of partial sums: partials are
+        // merged like a binary counter, so the k-th level holds the sum of
+        // 2^k consecutive inputs
+        template <typename T>
+        class PairwiseSum
+        {
+        public:
+            void add(T value)
+            {
+                size_t level = 0;
+                for (uint64_t c = count_++; c & 1; c >>= 1, ++level)
+                    value = levels_[level] + value;
+                levels_[level] = value;
+            }
+
+            T result() const
+            {
+                T total = 0;
+                bool any = false;
+                for (size_t level = 0; level < 64; ++level)
+                {
+                    if ((count_ >> level) & 1)
+                    {
+                        total = any ? levels_[level] + total : levels_[level];
+                        any = true;
+                    }
+                }
+                return total;
+            }
+
+        private:
+            std::array<T, 64> levels_{};
+            uint64_t count_ = 0;
+        };
+
+        // Pairwise sum of a contiguous range of at most reduce_chunk blocks
+        template <typename T>
+        T chunk_sum(const T *p, size_t n)
+        {
+            PairwiseSum<T> acc;
+            for (size_t i = 0; i < n; i += reduce_block)
+                acc.add(block_sum(p + i, std::min(reduce_block, n - i)));
+            return acc.result();
+        }
+
+        // Runs fn(i) for i in [0, tasks), on the pool when there is one and
+        // the caller is not one of its workers
+        template <typename Fn>
+        void run_tasks(utec::parallel::ThreadPool *pool, size_t tasks, Fn &&fn)
+        {
+            if (pool == nullptr || tasks < 2 || pool->size() < 2 ||
+                utec::parallel::ThreadPool::current_worker() >= 0)
+            {
+                for (size_t i = 0; i < tasks; ++i)
+                    fn(i);
+                return;
+            }
+            std::vector<std::future<void>> done;
+            done.reserve(tasks);
+            for (size_t i = 0; i < tasks; ++i)
+                done.push_back(pool->enqueue([&fn, i]
+                                             { fn(i); }));
+            utec::parallel::wait_all(done);
+        }
+
+        // Pairwise sum of p[0..n). Chunks of reduce_chunk blocks are
+        // complete subtrees, so they can be summed independently.
+        template <typename T>
+        T contiguous_sum(const T *p, size_t n, utec::parallel::ThreadPool *pool = nullptr)
+        {
+            const size_t chunk = reduce_chunk * reduce_block;
+            if (n <= chunk)
+                return chunk_sum(p, n);
+            const size_t chunks = (n + chunk - 1) / chunk;
+            std::vector<T> partial(chunks);
+            run_tasks(n >= parallel_threshold ? pool : nullptr, chunks, [&](size_t c)
+                      { partial[c] = chunk_sum(p + c * chunk, std::min(chunk, n - c * chunk)); });
+            PairwiseSum<T> acc;
+            for (T s : partial)
+                acc.add(s);
+            return acc.result();
+        }
+
+        // out[0..width) = sum over r < rows of p[r * stride + 0..width),
+        // pairwise over blocks of reduce_row_block rows
+        template <typename T>
+        void row_sum(const T *p, size_t rows, size_t stride, size_t width, T *out)
+        {
+            auto add_rows = [&](const T *first, size_t count, T *dst)
+            {
+                std::copy(first, first + width, dst);
+                for (size_t r = 1; r < count; ++r)
+                {
+                    const T *row = first + r * stride;
+                    for (size_t j = 0; j < width; ++j)
+                        dst[j] += row[j];
+                }
+            };
+            if (rows <= reduce_row_block)
+            {
+                add_rows(p, rows, out);
+                return;
+            }
+
+            // Binary counter of partial row vectors, as in PairwiseSum
+            std::vector<T> levels, block(width);
+            uint64_t count = 0;
+            for (size_t r = 0; r < rows; r += reduce_row_block)
+            {
+                add_rows(p + r * stride, std::min(reduce_row_block, rows - r), block.data());
+                size_t level = 0;
+                for (uint64_t c = count++; c & 1; c >>= 1, ++level)
+                {
+                    const T *held = levels.data() + level * width;
+                    for (size_t j = 0; j < width; ++j)
+                        block[j] = held[j] + block[j];
+                }
+                if (levels.size() < (level + 1) * width)
+                    levels.resize((level + 1) * width);
+                std::copy(block.begin(), block.end(), levels.begin() + level * width);
+            }
+            bool any = false;
+            for (size_t level = 0; level < 64; ++level)
+            {
+                if (!((count >> level) & 1))
+                    continue;
+                const T *held = levels.data() + level * width;
+                for (size_t j = 0; j < width; ++j)
+                    out[j] = any ? held[j] + out[j] : held[j];
+                any = true;
+            }
+        }
+
+        template <typename T>
+        void row_max(const T *p, size_t rows, size_t stride, size_t width, T *out)
+        {
+            std::copy(p, p + width, out);
+            for (size_t r = 1; r < rows; ++r)
+            {
+                const T *row = p + r * stride;
+                for (size_t j = 0; j < width; ++j)
+                    out[j] = row[j] > out[j] ? row[j] : out[j];
+            }
+        }
+
+        template <typename T>
+        void row_argmax(const T *p, size_t rows, size_t stride, size_t width, size_t *out)
+        {
+            std::vector<T> best(p, p + width);
+            std::fill(out, out + width, size_t{0});
+            for (size_t r = 1; r < rows; ++r)
+            {
+                const T *row = p + r * stride;
+                for (size_t j = 0; j < width; ++j)
+                {
+                    const bool better = row[j] > best[j];
+                    best[j] = better ? row[j] : best[j];
+                    out[j] = better ? r : out[j];
+                }
+            }
+        }
+
+        template <typename T>
+        T contiguous_max(const T *p, size_t n)
+        {
+            if (n < 8)
+                return *std::max_element(p, p + n);
+            T acc[8];
+            std::copy(p, p + 8, acc);
+            size_t i = 8;
+            for (; i + 8 <= n; i += 8)
+            {
+                for (size_t j = 0; j < 8; ++j)
+                    acc[j] = p[i + j] > acc[j] ? p[i + j] : acc[j];
+            }
+            for (; i < n; ++i)
+                acc[0] = p[i] > acc[0] ? p[i] : acc[0];
+            return *std::max_element(acc, acc + 8);
+        }
+
+        // Reduction along `axis` viewed as [outer, n, inner] (row-major)
+        struct AxisLayout
+        {
+            size_t outer = 1, n = 1, inner = 1;
+        };
+
+        template <size_t Rank>
+        AxisLayout axis_layout(const std::array<size_t, Rank> &shape, size_t axis)
+        {
+            if (axis >= Rank)
+            {
+                throw std::out_of_range("Axis " + std::to_string(axis) + " out of range for rank " +
+                                        std::to_string(Rank));
+            }
+            AxisLayout layout;
+            for (size_t d = 0; d < axis; ++d)
+                layout.outer *= shape[d];
+            layout.n = shape[axis];
+            for (size_t d = axis + 1; d < Rank; ++d)
+                layout.inner *= shape[d];
+            return layout;
+        }
+
+        // Splits the outer x inner outputs into pool-independent pieces and
+        // calls rows(o, c0, c1) for each outer index o and column range
+        template <typename Fn>
+        void for_each_axis_slice(const AxisLayout &layout, utec::parallel::ThreadPool *pool, Fn &&rows)
+        {
+            const size_t work = layout.outer * layout.n * layout.inner;
+            if (work < parallel_threshold)
+                pool = nullptr;
+            if (layout.inner == 1 || layout.outer > 1)
+            {
+                const size_t per_task = std::max<size_t>(1, parallel_threshold / std::max<size_t>(1, layout.n * layout.inner));
+                const size_t tasks = (layout.outer + per_task - 1) / per_task;
+                run_tasks(pool, tasks, [&](size_t t)
+                          {
+                    const size_t end = std::min(layout.outer, (t + 1) * per_task);
+                    for (size_t o = t * per_task; o < end; ++o)
+                        rows(o, size_t{0}, layout.inner); });
+                return;
+            }
+            // A single wide reduction: split the columns
+            const size_t cols = 256;
+            const size_t tasks = (layout.inner + cols - 1) / cols;
+            run_tasks(pool, tasks, [&](size_t t)
+                      { rows(size_t{0}, t * cols, std::min(layout.inner, (t + 1) * cols)); });
+        }
+
+        template <typename Out, size_t OutRank, typename B>
+        void check_output(const AxisLayout &layout, const Tensor<Out, OutRank, B> &out)
+        {
+            if (out.size() != layout.outer * layout.inner)
+            {
+                throw std::invalid_argument("Reduction output has " + std::to_string(out.size()) +
+                                            " elements, expected " +
+                                            std::to_string(layout.outer * layout.inner));
+            }
+        }
+
+        template <size_t Rank>
+        std::array<size_t, Rank> reduced_shape(std::array<size_t, Rank> shape, size_t axis)
+        {
+            axis_layout(shape, axis);
+            shape[axis] = 1;
+            return shape;
+        }
+
+        template <typename T, size_t Rank, typename A>
+        void require_elements(const Tensor<T, Rank, A> &x, size_t axis)
+        {
+            if (x.shape()[axis] == 0)
+                throw std::invalid_argument("Cannot take max/argmax along an empty axis");
+        }
+
+        template <typename T, size_t Rank, size_t OutRank, typename A, typename B>
+        void sum_axis(const Tensor<T, Rank, A> &x, size_t axis, Tensor<T, OutRank, B> &out,
+                      utec::parallel::ThreadPool *pool)
+        {
+            const auto layout = axis_layout(x.shape(), axis);
+            check_output(layout, out);
+            const T *p = x.data();
+            T *o = out.data();
+            if (layout.n == 0)
+            {
+                // Empty sum: the row kernels would read the first (missing) row
+                std::fill(o, o + out.size(), T(0));
+                return;
+            }
+            if (layout.outer == 1 && layout.inner == 1)
+            {
+                o[0] = contiguous_sum(p, layout.n, pool);
+                return;
+            }
+            for_each_axis_slice(layout, pool, [&](size_t outer, size_t c0, size_t c1)
+                                {
+                const T *base = p + outer * layout.n * layout.inner;
+                if (layout.inner == 1)
+                    o[outer] = contiguous_sum(base, layout.n);
+                else
+                    row_sum(base + c0, layout.n, layout.inner, c1 - c0, o + outer * layout.inner + c0); });
+        }
+
+        template <typename T, size_t Rank, size_t OutRank, typename A, typename B>
+        void max_axis(const Tensor<T, Rank, A> &x, size_t axis, Tensor<T, OutRank, B> &out,
+                      utec::parallel::ThreadPool *pool)
+        {
+            const auto layout = axis_layout(x.shape(), axis);
+            check_output(layout, out);
+            require_elements(x, axis);
+            const T *p = x.data();
+            T *o = out.data();
+            for_each_axis_slice(layout, pool, [&](size_t outer, size_t c0, size_t c1)
+                                {
+                const T *base = p + outer * layout.n * layout.inner;
+                if (layout.inner == 1)
+                    o[outer] = contiguous_max(base, layout.n);
+                else
+                    row_max(base + c0, layout.n, layout.inner, c1 - c0, o + outer * layout.inner + c0); });
+        }
+
+        template <typename T, size_t Rank, size_t OutRank, typename A, typename B>
+        void argmax_axis(const Tensor<T, Rank, A> &x, size_t axis, Tensor<size_t, OutRank, B> &out,
+                         utec::parallel::ThreadPool *pool);
+
+        template <typename T, size_t Rank>
+        Tensor<T, Rank> mean_from_sum(Tensor<T, Rank> out, size_t n)
+        {
+            if (n > 0)
+                out *= static_cast<T>(1) / static_cast<T>(n);
+            return out;
+        }
+    } // namespace detail
+
+    // Index of the first maximum of p[0..n), n > 0
+    template <typename T>
+    size_t argmax(const T *p, size_t n)
+    {
+        if (n >= 64)
+        {
+            // Long rows: a vectorized max, then the first element equal to it
+            const T best = detail::contiguous_max(p, n);
+            const T *hit = std::find(p, p + n, best);
+            if (hit != p + n)
+                return static_cast<size_t>(hit - p);
+            // Only reachable with NaNs; fall through to the exact scan
+        }
+        size_t arg = 0;
+        T best = p[0];
+        for (size_t j = 1; j < n; ++j)
+        {
+            // Branch-free select keeps short rows (class scores) cheap
+            const bool better = p[j] > best;
+            best = better ? p[j] : best;
+            arg = better ? j : arg;
+        }
+        return arg;
+    }
+
+    namespace detail
+    {
+        template <typename T, size_t Rank, size_t OutRank, typename A, typename B>
+        void argmax_axis(const Tensor<T, Rank, A> &x, size_t axis, Tensor<size_t, OutRank, B> &out,
+                         utec::parallel::ThreadPool *pool)
+        {
+            const auto layout = axis_layout(x.shape(), axis);
+            check_output(layout, out);
+            require_elements(x, axis);
+            const T *p = x.data();
+            size_t *o = out.data();
+            for_each_axis_slice(layout, pool, [&](size_t outer, size_t c0, size_t c1)
+                                {
+                const T *base = p + outer * layout.n * layout.inner;
+                if (layout.inner == 1)
+                    o[outer] = utec::algebra::argmax(base, layout.n);
+                else
+                    row_argmax(base + c0, layout.n, layout.inner, c1 - c0, o + outer * layout.inner + c0); });
+        }
+    } // namespace detail
+
+    // ---- Whole-tensor reductions ----
+
+    template <typename T, size_t Rank, typename A>
+    T sum(const Tensor<T, Rank, A> &x)
+    {
+        return detail::contiguous_sum(x.data(), x.size());
+    }
+
+    template <typename T, size_t Rank, typename A>
+    T sum(const Tensor<T, Rank, A> &x, utec::parallel::ThreadPool &pool)
+    {
+        return detail::contiguous_sum(x.data(), x.size(), &pool);
+    }
+
+    // Sum of an expression without materializing it: blocks are evaluated
+    // into a stack buffer and summed exactly like sum(Tensor(e))
+    template <TensorExpression E>
+    typename E::value_type sum(const E &e)
+    {
+        using T = typename E::value_type;
+        if (!e.dense())
+            return sum(Tensor<T, E::rank>(e));
+        const size_t n = e.size();
+        const size_t chunk = detail::reduce_chunk * detail::reduce_block;
+        T buf[detail::reduce_block];
+        detail::PairwiseSum<T> chunks;
+        for (size_t c = 0; c < n; c += chunk)
+        {
+            detail::PairwiseSum<T> blocks;
+            const size_t end = std::min(n, c + chunk);
+            for (size_t b = c; b < end; b += detail::reduce_block)
+            {
+                const size_t m = std::min(detail::reduce_block, end - b);
+                for (size_t i = 0; i < m; ++i)
+                    buf[i] = e.flat(b + i);
+                blocks.add(detail::block_sum(buf, m));
+            }
+            if (n <= chunk)
+                return blocks.result();
+            chunks.add(blocks.result());
+        }
+        return chunks.result();
+    }
+
+    template <typename T, size_t Rank, typename A>
+    T mean(const Tensor<T, Rank, A> &x)
+    {
+        return x.size() == 0 ? T(0) : sum(x) / static_cast<T>(x.size());
+    }
+
+    template <typename T, size_t Rank, typename A>
+    T mean(const Tensor<T, Rank, A> &x, utec::parallel::ThreadPool &pool)
+    {
+        return x.size() == 0 ? T(0) : sum(x, pool) / static_cast<T>(x.size());
+    }
+
+    template <typename T, size_t Rank, typename A>
+    T max(const Tensor<T, Rank, A> &x)
+    {
+        if (x.size() == 0)
+            throw std::invalid_argument("max of an empty tensor");
+        return detail::contiguous_max(x.data(), x.size());
+    }
+
+    // ---- Reductions along one axis ----
+    //
+    // The *_into forms write into any tensor with the right number of
+    // elements (e.g. a rank-1 bias gradient for sum_into(grad, 0, db)).
+
+    template <typename T, size_t Rank, size_t OutRank, typename A, typename B>
+    void sum_into(const Tensor<T, Rank, A> &x, size_t axis, Tensor<T, OutRank, B> &out)
+    {
+        detail::sum_axis(x, axis, out, nullptr);
+    }
+
+    template <typename T, size_t Rank, size_t OutRank, typename A, typename B>
+    void sum_into(const Tensor<T, Rank, A> &x, size_t axis, Tensor<T, OutRank, B> &out, utec::parallel::ThreadPool &pool)
+    {
+        detail::sum_axis(x, axis, out, &pool);
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<T, Rank> sum(const Tensor<T, Rank, A> &x, size_t axis)
+    {
+        Tensor<T, Rank> out(detail::reduced_shape(x.shape(), axis));
+        detail::sum_axis(x, axis, out, nullptr);
+        return out;
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<T, Rank> sum(const Tensor<T, Rank, A> &x, size_t axis, utec::parallel::ThreadPool &pool)
+    {
+        Tensor<T, Rank> out(detail::reduced_shape(x.shape(), axis));
+        detail::sum_axis(x, axis, out, &pool);
+        return out;
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<T, Rank> mean(const Tensor<T, Rank, A> &x, size_t axis)
+    {
+        Tensor<T, Rank> total = sum(x, axis);
+        return detail::mean_from_sum(std::move(total), x.shape()[axis]);
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<T, Rank> mean(const Tensor<T, Rank, A> &x, size_t axis, utec::parallel::ThreadPool &pool)
+    {
+        Tensor<T, Rank> total = sum(x, axis, pool);
+        return detail::mean_from_sum(std::move(total), x.shape()[axis]);
+    }
+
+    template <typename T, size_t Rank, size_t OutRank, typename A, typename B>
+    void max_into(const Tensor<T, Rank, A> &x, size_t axis, Tensor<T, OutRank, B> &out)
+    {
+        detail::max_axis(x, axis, out, nullptr);
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<T, Rank> max(const Tensor<T, Rank, A> &x, size_t axis)
+    {
+        Tensor<T, Rank> out(detail::reduced_shape(x.shape(), axis));
+        detail::max_axis(x, axis, out, nullptr);
+        return out;
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<T, Rank> max(const Tensor<T, Rank, A> &x, size_t axis, utec::parallel::ThreadPool &pool)
+    {
+        Tensor<T, Rank> out(detail::reduced_shape(x.shape(), axis));
+        detail::max_axis(x, axis, out, &pool);
+        return out;
+    }
+
+    // Index of the first maximum along `axis`
+    template <typename T, size_t Rank, size_t OutRank, typename A, typename B>
+    void argmax_into(const Tensor<T, Rank, A> &x, size_t axis, Tensor<size_t, OutRank, B> &out)
+    {
+        detail::argmax_axis(x, axis, out, nullptr);
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<size_t, Rank> argmax(const Tensor<T, Rank, A> &x, size_t axis)
+    {
+        Tensor<size_t, Rank> out(detail::reduced_shape(x.shape(), axis));
+        detail::argmax_axis(x, axis, out, nullptr);
+        return out;
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<size_t, Rank> argmax(const Tensor<T, Rank, A> &x, size_t axis, utec::parallel::ThreadPool &pool)
+    {
+        Tensor<size_t, Rank> out(detail::reduced_shape(x.shape(), axis));
+        detail::argmax_axis(x, axis, out, &pool);
+        return out;
+    }
+
+} // namespace utec::algebra
+
+#endif // UTEC_ALGEBRA_REDUCE_H
@@ -0,0 +1,202 @@
+#ifndef UTEC_ALGEBRA_STORAGE_H
+#define UTEC_ALGEBRA_STORAGE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "Allocator.h"
+#include "../profiling/Profiler.h"
+
+namespace utec::algebra
+{
+
+    // Elements a Tensor keeps inside the object before it touches its
+    // allocator. 256 bytes holds a batch-1 activation of a 64-wide layer, so
+    // single-state inference runs without any heap traffic.
+    constexpr size_t default_inline_bytes = 256;
+
+    // AlignedAllocator with an explicit in-object capacity of N elements
+    // (see SmallTensor); larger tensors still spill to the heap
+    template <typename T, size_t N>
+    class SmallBufferAllocator : public AlignedAllocator<T>
+    {
+    public:
+        static constexpr size_t inline_capacity = N;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = SmallBufferAllocator<U, N>;
+        };
+
+        SmallBufferAllocator() noexcept = default;
+        template <typename U>
+        SmallBufferAllocator(const SmallBufferAllocator<U, N> &) noexcept {}
+    };
+
+    template <typename T, typename U, size_t N>
+    bool operator==(const SmallBufferAllocator<T, N> &, const SmallBufferAllocator<U, N> &) noexcept
+    {
+        return true;
+    }
+
+    namespace detail
+    {
+        template <typename Alloc, typename = void>
+        struct inline_capacity_of
+        {
+            static constexpr size_t value = default_inline_bytes / sizeof(typename Alloc::value_type);
+        };
+
+        template <typename Alloc>
+        struct inline_capacity_of<Alloc, std::void_t<decltype(Alloc::inline_capacity)>>
+        {
+            static constexpr size_t value = Alloc::inline_capacity;
+        };
+
+        // Contiguous element buffer of a Tensor: the first inline_capacity
+        // elements live inside the object, larger sizes come from Alloc.
+        //
+        // Same value semantics as the std::vector it replaces: elements are
+        // zero-initialized when first exposed, resize() keeps the prefix and
+        // never shrinks the allocation, copy-assignment reuses it when it is
+        // large enough. A move steals a heap buffer but copies an inline one,
+        // so data() pointers do not survive moving a small tensor.
+        template <typename T, typename Alloc>
+        class TensorStorage
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Tensor elements must be trivially copyable");
+            using Traits = std::allocator_traits<Alloc>;
+
+        public:
+            static constexpr size_t inline_capacity = inline_capacity_of<Alloc>::value;
+
+            TensorStorage() noexcept = default;
+
+            TensorStorage(const TensorStorage &other) : TensorStorage()
+            {
+                assign_copy(other);
+            }
+
+            TensorStorage(TensorStorage &&other) noexcept : TensorStorage()
+            {
+                steal(other);
+            }
+
+            TensorStorage &operator=(const TensorStorage &other)
+            {
+                if (this != &other)
+                    assign_copy(other);
+                return *this;
+            }
+
+            TensorStorage &operator=(TensorStorage &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    release();
+                    steal(other);
+                }
+                return *this;
+            }
+
+            ~TensorStorage() { release(); }
+
+            T *data() noexcept { return data_; }
+            const T *data() const noexcept { return data_; }
+            size_t size() const noexcept { return size_; }
+            size_t capacity() const noexcept { return capacity_; }
+            bool is_inline() const noexcept { return data_ == inline_; }
+
+            T &operator[](size_t i) noexcept { return data_[i]; }
+            const T &operator[](size_t i) const noexcept { return data_[i]; }
+
+            T *begin() noexcept { return data_; }
+            T *end() noexcept { return data_ + size_; }
+            const T *begin() const noexcept { return data_; }
+            const T *end() const noexcept { return data_ + size_; }
+
+            // Keeps the first min(size, n) elements, zeroes the rest
+            void resize(size_t n)
+            {
+                if (n > capacity_)
+                    grow(n);
+                if (n > size_)
+                    std::fill(data_ + size_, data_ + n, T{});
+                size_ = n;
+            }
+
+        private:
+            void grow(size_t n)
+            {
+                // Exact size: tensors are resized to shapes, not appended to
+                Alloc alloc;
+                T *fresh = Traits::allocate(alloc, n);
+                UTEC_PROFILE_ALLOC(n * sizeof(T));
+                const size_t kept = size_;
+                if (kept > 0)
+                    std::memcpy(fresh, data_, kept * sizeof(T));
+                release();
+                data_ = fresh;
+                size_ = kept;
+                capacity_ = n;
+            }
+
+            void assign_copy(const TensorStorage &other)
+            {
+                if (other.size_ > capacity_)
+                {
+                    // Nothing worth preserving: drop the old buffer first
+                    size_ = 0;
+                    grow(other.size_);
+                }
+                if (other.size_ > 0)
+                    std::memcpy(data_, other.data_, other.size_ * sizeof(T));
+                size_ = other.size_;
+            }
+
+            // Takes other's contents; this storage must be empty and inline
+            void steal(TensorStorage &other) noexcept
+            {
+                if (other.is_inline())
+                {
+                    if (other.size_ > 0)
+                        std::memcpy(inline_, other.inline_, other.size_ * sizeof(T));
+                    size_ = other.size_;
+                }
+                else
+                {
+                    data_ = other.data_;
+                    size_ = other.size_;
+                    capacity_ = other.capacity_;
+                    other.data_ = other.inline_;
+                    other.capacity_ = inline_capacity;
+                }
+                other.size_ = 0;
+            }
+
+            void release() noexcept
+            {
+                if (!is_inline())
+                {
+                    Alloc alloc;
+                    Traits::deallocate(alloc, data_, capacity_);
+                }
+                data_ = inline_;
+                capacity_ = inline_capacity;
+                size_ = 0;
+            }
+
+            T *data_ = inline_;
+            size_t size_ = 0;
+            size_t capacity_ = inline_capacity;
+            alignas(cache_line) T inline_[inline_capacity > 0 ? inline_capacity : 1];
+        };
+    } // namespace detail
+
+} // namespace utec::algebra
+
+#endif // UTEC_ALGEBRA_STORAGE_H
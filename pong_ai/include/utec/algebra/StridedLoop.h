@@ -0,0 +1,134 @@
+#ifndef UTEC_ALGEBRA_STRIDEDLOOP_H
+#define UTEC_ALGEBRA_STRIDEDLOOP_H
+
+#include <array>
+#include <cstddef>
+
+namespace utec::algebra::detail
+{
+
+    // Row-major element strides of a contiguous tensor, seen from a result
+    // of the same rank: dimensions the tensor broadcasts (extent 1) get
+    // stride 0, so walking the result walks the tensor along with it.
+    template <size_t Rank>
+    std::array<size_t, Rank> broadcast_strides(const std::array<size_t, Rank> &shape)
+    {
+        std::array<size_t, Rank> strides{};
+        size_t stride = 1;
+        for (size_t d = Rank; d-- > 0;)
+        {
+            strides[d] = shape[d] == 1 ? 0 : stride;
+            stride *= shape[d];
+        }
+        return strides;
+    }
+
+    // Iteration space shared by N strided operands over one result shape.
+    //
+    // Dimensions of extent 1 are dropped and neighbouring dimensions that
+    // are contiguous for every operand are merged, so an elementwise op on
+    // same-shape tensors becomes a single run and a [rows, cols] + [1, cols]
+    // bias broadcast becomes `rows` runs of `cols` contiguous elements.
+    // for_each_run() walks the outer dimensions with incremental offsets
+    // and hands each innermost run to the caller's kernel, which can pick a
+    // contiguous or stride-0 loop from the run's inner strides.
+    template <size_t Rank, size_t N>
+    class StridedLoop
+    {
+    public:
+        using Offsets = std::array<size_t, N>;
+
+        StridedLoop(const std::array<size_t, Rank> &shape,
+                    const std::array<std::array<size_t, Rank>, N> &strides)
+        {
+            for (size_t d = 0; d < Rank; ++d)
+            {
+                if (shape[d] == 0)
+                {
+                    empty_ = true;
+                    return;
+                }
+                if (shape[d] == 1)
+                    continue;
+                if (dims_ > 0 && mergeable(strides, d, shape[d]))
+                {
+                    // Fold dimension d into the previous kept one
+                    extent_[dims_ - 1] *= shape[d];
+                    for (size_t k = 0; k < N; ++k)
+                        strides_[k][dims_ - 1] = strides[k][d];
+                    continue;
+                }
+                extent_[dims_] = shape[d];
+                for (size_t k = 0; k < N; ++k)
+                    strides_[k][dims_] = strides[k][d];
+                ++dims_;
+            }
+        }
+
+        // Dimensions left after dropping and merging (0 for a single element)
+        size_t dims() const noexcept { return dims_; }
+
+        // kernel(offsets, n, inner_strides): operand k's elements for this run
+        // are at offsets[k] + i * inner_strides[k], i < n
+        template <typename Kernel>
+        void for_each_run(Kernel &&kernel) const
+        {
+            if (empty_)
+                return;
+            Offsets offsets{};
+            if (dims_ == 0)
+            {
+                kernel(offsets, size_t{1}, Offsets{});
+                return;
+            }
+
+            const size_t inner = dims_ - 1;
+            Offsets inner_strides;
+            for (size_t k = 0; k < N; ++k)
+                inner_strides[k] = strides_[k][inner];
+
+            std::array<size_t, Rank> idx{};
+            while (true)
+            {
+                kernel(offsets, extent_[inner], inner_strides);
+
+                // Odometer over the outer dimensions
+                size_t d = inner;
+                while (d-- > 0)
+                {
+                    for (size_t k = 0; k < N; ++k)
+                        offsets[k] += strides_[k][d];
+                    if (++idx[d] < extent_[d])
+                        break;
+                    for (size_t k = 0; k < N; ++k)
+                        offsets[k] -= strides_[k][d] * extent_[d];
+                    idx[d] = 0;
+                }
+                if (d == static_cast<size_t>(-1))
+                    return;
+            }
+        }
+
+    private:
+        // Dimension d can be folded into the previous kept dimension p when,
+        // for every operand, one step along p equals `extent` steps along d
+        bool mergeable(const std::array<std::array<size_t, Rank>, N> &strides, size_t d, size_t extent) const
+        {
+            const size_t p = dims_ - 1;
+            for (size_t k = 0; k < N; ++k)
+            {
+                if (strides_[k][p] != strides[k][d] * extent)
+                    return false;
+            }
+            return true;
+        }
+
+        std::array<size_t, Rank> extent_{};
+        std::array<std::array<size_t, Rank>, N> strides_{};
+        size_t dims_ = 0;
+        bool empty_ = false;
+    };
+
+} // namespace utec::algebra::detail
+
+#endif // UTEC_ALGEBRA_STRIDEDLOOP_H
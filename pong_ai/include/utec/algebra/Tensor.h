@@ -9,17 +9,270 @@
 #include <algorithm>
 #include <numeric>
 #include <iostream>
+#include <concepts>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include "Allocator.h"
+#include "Storage.h"
+#include "StridedLoop.h"
+#include "../profiling/Profiler.h"
 
 namespace utec::algebra
 {
 
-    template <typename T, size_t Rank>
+    // Alloc provides the storage (see Allocator.h); the default is 64-byte
+    // aligned. Tensors with different allocators mix freely in expressions.
+    template <typename T, size_t Rank, typename Alloc = AlignedAllocator<T>>
+    class Tensor;
+
+    // Lazy elementwise expressions.
+    //
+    // `a + b * c` builds a small tree of expression nodes instead of two
+    // temporary tensors; the tree is evaluated in a single loop when it is
+    // assigned to a Tensor (or when a Tensor is constructed from it). Nodes
+    // hold non-owning views of their tensor operands, so an expression must
+    // not outlive them: keep `auto` results local, or convert to a Tensor.
+    // Operands that are Tensor rvalues are not captured at all; their buffer
+    // is reused for the result instead (see the rvalue overloads below).
+    struct ExprTag
+    {
+    };
+
+    namespace detail
+    {
+        template <typename E>
+        struct is_tensor : std::false_type
+        {
+        };
+
+        template <typename T, size_t Rank, typename A>
+        struct is_tensor<Tensor<T, Rank, A>> : std::true_type
+        {
+        };
+    } // namespace detail
+
+    template <typename E>
+    concept TensorExpression = std::is_base_of_v<ExprTag, std::remove_cvref_t<E>>;
+
+    // Anything that can appear in an elementwise expression
+    template <typename E>
+    concept TensorOperand = TensorExpression<E> || detail::is_tensor<std::remove_cvref_t<E>>::value;
+
+    namespace detail
+    {
+        // Leaf node: the buffer and shape of a tensor operand
+        template <typename T, size_t Rank>
+        class TensorLeaf
+        {
+        public:
+            using value_type = T;
+            static constexpr size_t rank = Rank;
+            static constexpr size_t leaves = 1;
+
+            TensorLeaf(const T *data, const std::array<size_t, Rank> &shape) : data_(data), shape_(shape) {}
+
+            const std::array<size_t, Rank> &shape() const noexcept { return shape_; }
+            bool dense() const noexcept { return true; }
+
+            T flat(size_t i) const noexcept { return data_[i]; }
+
+            // Element at a multi-index of the (possibly larger) result shape;
+            // dimensions of extent 1 are broadcast
+            T at(const std::array<size_t, Rank> &idx) const noexcept
+            {
+                size_t offset = 0;
+                for (size_t d = 0; d < Rank; ++d)
+                    offset = offset * shape_[d] + (shape_[d] == 1 ? 0 : idx[d]);
+                return data_[offset];
+            }
+
+            // Strided evaluation (see Tensor::assign): leaves are numbered
+            // left to right, K is this leaf's number
+            template <size_t K, size_t N>
+            void gather(std::array<const T *, N> &data, std::array<std::array<size_t, Rank>, N> &shapes) const
+            {
+                data[K] = data_;
+                shapes[K] = shape_;
+            }
+
+            template <size_t K, size_t N>
+            T load(const std::array<const T *, N> &row, size_t i) const noexcept
+            {
+                return row[K][i];
+            }
+
+        private:
+            const T *data_;
+            std::array<size_t, Rank> shape_;
+        };
+
+        template <typename T, size_t Rank, typename A>
+        TensorLeaf<T, Rank> as_operand(const Tensor<T, Rank, A> &t)
+        {
+            return TensorLeaf<T, Rank>(t.data(), t.shape());
+        }
+
+        template <TensorExpression E>
+        const E &as_operand(const E &e)
+        {
+            return e;
+        }
+
+        template <typename E>
+        using operand_t = std::remove_cvref_t<decltype(as_operand(std::declval<const E &>()))>;
+
+        template <size_t Rank>
+        std::array<size_t, Rank> broadcast_shape(const std::array<size_t, Rank> &a,
+                                                 const std::array<size_t, Rank> &b)
+        {
+            std::array<size_t, Rank> result;
+            for (size_t i = 0; i < Rank; ++i)
+            {
+                if (a[i] == b[i] || b[i] == 1)
+                    result[i] = a[i];
+                else if (a[i] == 1)
+                    result[i] = b[i];
+                else
+                    throw std::invalid_argument("Incompatible shapes for broadcasting");
+            }
+            return result;
+        }
+
+        template <size_t Rank>
+        void check_bounds(const std::array<size_t, Rank> &idx, const std::array<size_t, Rank> &shape)
+        {
+            for (size_t i = 0; i < Rank; ++i)
+            {
+                if (idx[i] >= shape[i])
+                {
+                    throw std::out_of_range("Index " + std::to_string(idx[i]) +
+                                            " out of range for dimension " +
+                                            std::to_string(i) + " (size " +
+                                            std::to_string(shape[i]) + ")");
+                }
+            }
+        }
+    } // namespace detail
+
+    // Shared interface of the expression nodes: bounds-checked element access,
+    // like Tensor::operator()
+    template <typename Derived, typename T, size_t Rank>
+    class ExprBase : public ExprTag
+    {
+    public:
+        using value_type = T;
+        static constexpr size_t rank = Rank;
+
+        template <typename... Idxs>
+        T operator()(Idxs... idxs) const
+        {
+            static_assert(sizeof...(Idxs) == Rank, "Incorrect number of indices");
+            std::array<size_t, Rank> idx = {static_cast<size_t>(idxs)...};
+            const auto &self = static_cast<const Derived &>(*this);
+            detail::check_bounds(idx, self.shape());
+            return self.at(idx);
+        }
+
+        size_t size() const noexcept
+        {
+            const auto &shape = static_cast<const Derived &>(*this).shape();
+            return std::accumulate(shape.begin(), shape.end(), size_t{1}, std::multiplies<size_t>());
+        }
+    };
+
+    // op(l, r) elementwise, with broadcasting
+    template <typename Op, typename L, typename R>
+    class BinaryExpr : public ExprBase<BinaryExpr<Op, L, R>, typename L::value_type, L::rank>
+    {
+    public:
+        using value_type = typename L::value_type;
+        static constexpr size_t rank = L::rank;
+        static_assert(std::is_same_v<value_type, typename R::value_type>, "Operands must share the element type");
+        static_assert(rank == R::rank, "Operands must have the same rank");
+        static constexpr size_t leaves = L::leaves + R::leaves;
+
+        BinaryExpr(const L &l, const R &r)
+            : l_(l), r_(r), shape_(detail::broadcast_shape(l.shape(), r.shape())),
+              dense_(l.dense() && r.dense() && l.shape() == shape_ && r.shape() == shape_)
+        {
+        }
+
+        const std::array<size_t, rank> &shape() const noexcept { return shape_; }
+
+        // True when every leaf has exactly this node's shape, so elements can
+        // be addressed by flat index
+        bool dense() const noexcept { return dense_; }
+
+        value_type flat(size_t i) const { return Op{}(l_.flat(i), r_.flat(i)); }
+        value_type at(const std::array<size_t, rank> &idx) const { return Op{}(l_.at(idx), r_.at(idx)); }
+
+        template <size_t K, size_t N>
+        void gather(std::array<const value_type *, N> &data, std::array<std::array<size_t, rank>, N> &shapes) const
+        {
+            l_.template gather<K>(data, shapes);
+            r_.template gather<K + L::leaves>(data, shapes);
+        }
+
+        template <size_t K, size_t N>
+        value_type load(const std::array<const value_type *, N> &row, size_t i) const
+        {
+            return Op{}(l_.template load<K>(row, i), r_.template load<K + L::leaves>(row, i));
+        }
+
+    private:
+        L l_;
+        R r_;
+        std::array<size_t, rank> shape_;
+        bool dense_;
+    };
+
+    // op(e, scalar) elementwise
+    template <typename Op, typename E>
+    class ScalarExpr : public ExprBase<ScalarExpr<Op, E>, typename E::value_type, E::rank>
+    {
+    public:
+        using value_type = typename E::value_type;
+        static constexpr size_t rank = E::rank;
+        static constexpr size_t leaves = E::leaves;
+
+        ScalarExpr(const E &e, value_type scalar) : e_(e), scalar_(scalar) {}
+
+        const std::array<size_t, rank> &shape() const noexcept { return e_.shape(); }
+        bool dense() const noexcept { return e_.dense(); }
+
+        value_type flat(size_t i) const { return Op{}(e_.flat(i), scalar_); }
+        value_type at(const std::array<size_t, rank> &idx) const { return Op{}(e_.at(idx), scalar_); }
+
+        template <size_t K, size_t N>
+        void gather(std::array<const value_type *, N> &data, std::array<std::array<size_t, rank>, N> &shapes) const
+        {
+            e_.template gather<K>(data, shapes);
+        }
+
+        template <size_t K, size_t N>
+        value_type load(const std::array<const value_type *, N> &row, size_t i) const
+        {
+            return Op{}(e_.template load<K>(row, i), scalar_);
+        }
+
+    private:
+        E e_;
+        value_type scalar_;
+    };
+
+    template <typename T, size_t Rank, typename Alloc>
     class Tensor
     {
+    public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        static constexpr size_t rank = Rank;
+
     private:
         std::array<size_t, Rank> shape_;
         std::array<size_t, Rank> strides_;
-        std::vector<T> data_;
+        detail::TensorStorage<T, Alloc> data_; // Inline when small, see Storage.h
 
         void compute_strides() noexcept
         {
@@ -94,6 +347,72 @@ namespace utec::algebra
             compute_strides();
         }
 
+        // Evaluates an expression into a new tensor
+        template <TensorExpression E>
+            requires(E::rank == Rank && std::is_same_v<typename E::value_type, T>)
+        Tensor(const E &e) : Tensor(e.shape())
+        {
+            assign(e);
+        }
+
+        // Copies the elements of a tensor stored with another allocator
+        template <typename OtherAlloc>
+            requires(!std::is_same_v<OtherAlloc, Alloc>)
+        explicit Tensor(const Tensor<T, Rank, OtherAlloc> &other) : Tensor(other.shape())
+        {
+            std::copy(other.data(), other.data() + other.size(), data_.data());
+        }
+
+        Tensor(const Tensor &) = default;
+        Tensor(Tensor &&) noexcept = default;
+        Tensor &operator=(const Tensor &) = default;
+        Tensor &operator=(Tensor &&) noexcept = default;
+
+        // Evaluates in place when the shape already matches (no allocation);
+        // otherwise into a fresh buffer, since the expression may read from
+        // this tensor with broadcasting
+        template <TensorExpression E>
+            requires(E::rank == Rank && std::is_same_v<typename E::value_type, T>)
+        Tensor &operator=(const E &e)
+        {
+            if (e.shape() == shape_)
+            {
+                assign(e);
+            }
+            else
+            {
+                *this = Tensor(e);
+            }
+            return *this;
+        }
+
+        // Compound assignment: `other` may broadcast into this tensor but not
+        // change its shape
+        template <TensorOperand E>
+        Tensor &operator+=(const E &other)
+        {
+            return compound(detail::as_operand(other), std::plus<T>());
+        }
+
+        template <TensorOperand E>
+        Tensor &operator-=(const E &other)
+        {
+            return compound(detail::as_operand(other), std::minus<T>());
+        }
+
+        template <TensorOperand E>
+        Tensor &operator*=(const E &other)
+        {
+            return compound(detail::as_operand(other), std::multiplies<T>());
+        }
+
+        Tensor &operator*=(const T &scalar) noexcept
+        {
+            for (auto &v : data_)
+                v *= scalar;
+            return *this;
+        }
+
         // Access operators
         template <typename... Idxs>
         T &operator()(Idxs... idxs)
@@ -115,6 +434,22 @@ namespace utec::algebra
             return shape_;
         }
 
+        size_t size() const noexcept
+        {
+            return data_.size();
+        }
+
+        // Raw contiguous storage (row-major), used by the kernels in nn/
+        T *data() noexcept
+        {
+            return data_.data();
+        }
+
+        const T *data() const noexcept
+        {
+            return data_.data();
+        }
+
         void reshape(const std::array<size_t, Rank> &new_shape)
         {
             size_t new_size = 1;
@@ -138,39 +473,31 @@ namespace utec::algebra
             reshape(std::array<size_t, Rank>{static_cast<size_t>(dims)...});
         }
 
-        // Bulk modification
-        void fill(const T &value) noexcept
-        {
-            std::fill(data_.begin(), data_.end(), value);
-        }
-
-        // Arithmetic operations
-        Tensor operator+(const Tensor &other) const
+        // Change the shape (and element count), reusing the current allocation
+        // when it is large enough. Existing element values are not preserved
+        // in any meaningful order.
+        void resize(const std::array<size_t, Rank> &new_shape)
         {
-            return binary_operation(other, [](T a, T b)
-                                    { return a + b; });
-        }
-
-        Tensor operator-(const Tensor &other) const
-        {
-            return binary_operation(other, [](T a, T b)
-                                    { return a - b; });
+            size_t new_size = 1;
+            for (size_t dim : new_shape)
+            {
+                new_size *= dim;
+            }
+            data_.resize(new_size);
+            shape_ = new_shape;
+            compute_strides();
         }
 
-        Tensor operator*(const Tensor &other) const
+        // True while the elements live inside the object (no heap buffer)
+        bool is_inline() const noexcept
         {
-            return binary_operation(other, [](T a, T b)
-                                    { return a * b; });
+            return data_.is_inline();
         }
 
-        Tensor operator*(const T &scalar) const
+        // Bulk modification
+        void fill(const T &value) noexcept
         {
-            Tensor result(shape_);
-            for (size_t i = 0; i < data_.size(); ++i)
-            {
-                result.data_[i] = data_[i] * scalar;
-            }
-            return result;
+            std::fill(data_.begin(), data_.end(), value);
         }
 
         // Transpose (only for rank 2)
@@ -189,68 +516,159 @@ namespace utec::algebra
         }
 
     private:
-        template <typename Op>
-        Tensor binary_operation(const Tensor &other, Op op) const
+        // Writes e into this tensor, whose shape must already be e.shape().
+        // Reading from this tensor at the element being written is fine, so
+        // `a = a * b` needs no temporary.
+        template <typename E>
+        void assign(const E &e)
         {
-            // Check if shapes are broadcast-compatible
-            std::array<size_t, Rank> result_shape;
-            for (size_t i = 0; i < Rank; ++i)
+            T *out = data_.data();
+            const size_t n = data_.size();
+            if (e.dense())
             {
-                if (shape_[i] == other.shape_[i])
-                {
-                    result_shape[i] = shape_[i];
-                }
-                else if (shape_[i] == 1)
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = e.flat(i);
+                return;
+            }
+
+            // Broadcasting: operand 0 is the output, 1..L the leaves
+            constexpr size_t L = E::leaves;
+            std::array<const T *, L> data;
+            std::array<std::array<size_t, Rank>, L> shapes;
+            e.template gather<0>(data, shapes);
+            std::array<std::array<size_t, Rank>, L + 1> strides;
+            strides[0] = detail::broadcast_strides(shape_);
+            for (size_t k = 0; k < L; ++k)
+                strides[k + 1] = detail::broadcast_strides(shapes[k]);
+
+            // Leaves with inner stride 0 are splatted into a short buffer per
+            // chunk, so every run goes through the same contiguous kernel
+            constexpr size_t chunk = 256;
+            T splat[L][chunk];
+            detail::StridedLoop<Rank, L + 1> loop(shape_, strides);
+            loop.for_each_run([&](const auto &offsets, size_t count, const auto &inner)
+                              {
+                std::array<const T *, L> row;
+                bool contiguous = true;
+                for (size_t k = 0; k < L; ++k)
                 {
-                    result_shape[i] = other.shape_[i];
+                    row[k] = data[k] + offsets[k + 1];
+                    contiguous = contiguous && inner[k + 1] == 1;
                 }
-                else if (other.shape_[i] == 1)
+                T *dst = out + offsets[0];
+                if (contiguous || count == 1)
                 {
-                    result_shape[i] = shape_[i];
+                    for (size_t i = 0; i < count; ++i)
+                        dst[i] = e.template load<0>(row, i);
+                    return;
                 }
-                else
+                for (size_t start = 0; start < count; start += chunk)
                 {
-                    throw std::invalid_argument("Incompatible shapes for broadcasting");
-                }
+                    const size_t m = std::min(chunk, count - start);
+                    std::array<const T *, L> part;
+                    for (size_t k = 0; k < L; ++k)
+                    {
+                        if (inner[k + 1] == 0)
+                        {
+                            std::fill_n(splat[k], m, *row[k]);
+                            part[k] = splat[k];
+                        }
+                        else
+                        {
+                            part[k] = row[k] + start;
+                        }
+                    }
+                    for (size_t i = 0; i < m; ++i)
+                        dst[start + i] = e.template load<0>(part, i);
+                } });
+        }
+
+        template <typename E, typename Op>
+        Tensor &compound(const E &other, Op)
+        {
+            BinaryExpr<Op, detail::TensorLeaf<T, Rank>, E> e(detail::as_operand(*this), other);
+            if (e.shape() != shape_)
+            {
+                throw std::invalid_argument("Compound assignment cannot change the tensor's shape");
             }
+            assign(e);
+            return *this;
+        }
+    };
 
-            Tensor result(result_shape);
-            std::array<size_t, Rank> indices;
-            std::fill(indices.begin(), indices.end(), 0);
+    // Tensor with room for N elements inside the object (beyond the default
+    // 256 bytes); bigger shapes still work, they just allocate
+    template <typename T, size_t Rank, size_t N>
+    using SmallTensor = Tensor<T, Rank, SmallBufferAllocator<T, N>>;
 
-            // Iterate through all elements in result tensor
-            for (size_t i = 0; i < result.data_.size(); ++i)
-            {
-                // Calculate element from this tensor
-                std::array<size_t, Rank> this_indices;
-                for (size_t j = 0; j < Rank; ++j)
-                {
-                    this_indices[j] = (shape_[j] == 1) ? 0 : indices[j];
-                }
-                T val1 = data_[flat_index(this_indices)];
+    namespace detail
+    {
+        template <typename Op, typename L, typename R>
+        auto make_binary(const L &l, const R &r)
+        {
+            return BinaryExpr<Op, operand_t<L>, operand_t<R>>(as_operand(l), as_operand(r));
+        }
 
-                // Calculate element from other tensor
-                std::array<size_t, Rank> other_indices;
-                for (size_t j = 0; j < Rank; ++j)
-                {
-                    other_indices[j] = (other.shape_[j] == 1) ? 0 : indices[j];
-                }
-                T val2 = other.data_[other.flat_index(other_indices)];
+        // Evaluates op(l, r) into the buffer of the dying tensor `dst` (one of
+        // the operands) when the result has its shape
+        template <typename Op, typename T, size_t Rank, typename A, typename L, typename R>
+        Tensor<T, Rank, A> reuse(Tensor<T, Rank, A> &dst, const L &l, const R &r)
+        {
+            auto e = make_binary<Op>(l, r);
+            if (e.shape() != dst.shape())
+                return Tensor<T, Rank, A>(e);
+            dst = e;
+            return std::move(dst);
+        }
+    } // namespace detail
 
-                result.data_[i] = op(val1, val2);
+#define UTEC_TENSOR_BINARY_OPERATOR(op, functor)                                            \
+    template <TensorOperand L, TensorOperand R>                                             \
+    auto operator op(const L &l, const R &r)                                                \
+    {                                                                                       \
+        return detail::make_binary<functor<typename L::value_type>>(l, r);                  \
+    }                                                                                       \
+    template <typename T, size_t Rank, typename A, TensorOperand R>                         \
+    Tensor<T, Rank, A> operator op(Tensor<T, Rank, A> &&l, const R &r)                      \
+    {                                                                                       \
+        return detail::reuse<functor<T>>(l, l, r);                                          \
+    }                                                                                       \
+    template <TensorOperand L, typename T, size_t Rank, typename A>                         \
+    Tensor<T, Rank, A> operator op(const L &l, Tensor<T, Rank, A> &&r)                      \
+    {                                                                                       \
+        return detail::reuse<functor<T>>(r, l, r);                                          \
+    }                                                                                       \
+    template <typename T, size_t Rank, typename A, typename B>                              \
+    Tensor<T, Rank, A> operator op(Tensor<T, Rank, A> &&l, Tensor<T, Rank, B> &&r)          \
+    {                                                                                       \
+        return detail::reuse<functor<T>>(l, l, r);                                          \
+    }
 
-                // Update indices for next element
-                for (int j = Rank - 1; j >= 0; --j)
-                {
-                    if (++indices[j] < result_shape[j])
-                        break;
-                    indices[j] = 0;
-                }
-            }
+    UTEC_TENSOR_BINARY_OPERATOR(+, std::plus)
+    UTEC_TENSOR_BINARY_OPERATOR(-, std::minus)
+    UTEC_TENSOR_BINARY_OPERATOR(*, std::multiplies)
 
-            return result;
-        }
-    };
+#undef UTEC_TENSOR_BINARY_OPERATOR
+
+    template <TensorOperand E>
+    auto operator*(const E &e, const std::type_identity_t<typename E::value_type> &scalar)
+    {
+        using T = typename E::value_type;
+        return ScalarExpr<std::multiplies<T>, detail::operand_t<E>>(detail::as_operand(e), scalar);
+    }
+
+    template <TensorOperand E>
+    auto operator*(const std::type_identity_t<typename E::value_type> &scalar, const E &e)
+    {
+        return e * scalar;
+    }
+
+    template <typename T, size_t Rank, typename A>
+    Tensor<T, Rank, A> operator*(Tensor<T, Rank, A> &&t, const std::type_identity_t<T> &scalar)
+    {
+        t *= scalar;
+        return std::move(t);
+    }
 
 } // namespace utec::algebra
 
@@ -0,0 +1,107 @@
+#ifndef UTEC_IO_ASYNCLOGGER_H
+#define UTEC_IO_ASYNCLOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "../parallel/SpscQueue.h"
+
+namespace utec::io
+{
+
+    // Moves formatting and I/O of log rows off the calling thread.
+    //
+    // The producer (one thread, e.g. the training loop) hands plain rows over a
+    // lock-free SPSC queue; a background thread runs the formatter, which is
+    // where the ostream/file writes happen. log() only blocks when the queue is
+    // full, i.e. when the sink has fallen `capacity` rows behind.
+    template <typename Row>
+    class AsyncLogger
+    {
+    public:
+        using Formatter = std::function<void(const Row &)>;
+
+        explicit AsyncLogger(Formatter formatter, size_t capacity = 1024)
+            : queue_(capacity), format_(std::move(formatter))
+        {
+            worker_ = std::thread([this]
+                                  { run(); });
+        }
+
+        ~AsyncLogger()
+        {
+            stop_.store(true, std::memory_order_release);
+            wake();
+            worker_.join();
+        }
+
+        AsyncLogger(const AsyncLogger &) = delete;
+        AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+        void log(Row row)
+        {
+            while (!queue_.try_push(std::move(row)))
+            {
+                // Sink is behind: give the writer a chance to catch up
+                wake();
+                std::this_thread::yield();
+            }
+            ++pushed_;
+            wake();
+        }
+
+        // Blocks until every row logged so far has been formatted
+        void flush()
+        {
+            uint64_t done = processed_.load(std::memory_order_acquire);
+            while (done < pushed_)
+            {
+                processed_.wait(done, std::memory_order_acquire);
+                done = processed_.load(std::memory_order_acquire);
+            }
+        }
+
+    private:
+        void wake()
+        {
+            signal_.fetch_add(1, std::memory_order_release);
+            signal_.notify_one();
+        }
+
+        void run()
+        {
+            Row row;
+            while (true)
+            {
+                uint64_t seen = signal_.load(std::memory_order_acquire);
+                uint64_t count = 0;
+                while (queue_.try_pop(row))
+                {
+                    format_(row);
+                    ++count;
+                }
+                if (count > 0)
+                {
+                    processed_.fetch_add(count, std::memory_order_release);
+                    processed_.notify_all();
+                    continue;
+                }
+                if (stop_.load(std::memory_order_acquire))
+                    break;
+                signal_.wait(seen, std::memory_order_acquire);
+            }
+        }
+
+        utec::parallel::SpscQueue<Row> queue_;
+        Formatter format_;
+        uint64_t pushed_ = 0; // producer thread only
+        std::atomic<uint64_t> processed_{0};
+        std::atomic<uint64_t> signal_{0};
+        std::atomic<bool> stop_{false};
+        std::thread worker_;
+    };
+
+} // namespace utec::io
+
+#endif // UTEC_IO_ASYNCLOGGER_H
@@ -0,0 +1,205 @@
+#ifndef UTEC_IO_CHECKPOINTER_H
+#define UTEC_IO_CHECKPOINTER_H
+
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define UTEC_IO_HAS_FSYNC 1
+#endif
+
+namespace utec::io
+{
+
+    // Writes a parameter vector as text (one value per line, the format of
+    // trained_params.txt) so that readers never observe a partial file: the
+    // data goes to `path.tmp`, is fsync'ed, then renamed over `path`.
+    template <typename T>
+    bool write_params_atomically(const std::string &path, const std::vector<T> &params)
+    {
+        std::string text;
+        text.reserve(params.size() * 12);
+        char buf[64];
+        for (const T &p : params)
+        {
+            auto res = std::to_chars(buf, buf + sizeof(buf), p);
+            text.append(buf, res.ptr);
+            text.push_back('\n');
+        }
+
+        const std::string tmp = path + ".tmp";
+        std::FILE *file = std::fopen(tmp.c_str(), "wb");
+        if (!file)
+            return false;
+        bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        ok = std::fflush(file) == 0 && ok;
+#ifdef UTEC_IO_HAS_FSYNC
+        ok = ::fsync(::fileno(file)) == 0 && ok;
+#endif
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0)
+        {
+            std::remove(tmp.c_str());
+            return false;
+        }
+
+#ifdef UTEC_IO_HAS_FSYNC
+        // Persist the rename itself
+        size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+        int fd = ::open(dir.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            ::fsync(fd);
+            ::close(fd);
+        }
+#endif
+        return true;
+    }
+
+    // Reads a file written by write_params_atomically. Returns false (and
+    // leaves params untouched) if it cannot be opened or a line is not a
+    // number.
+    template <typename T>
+    bool read_params(const std::string &path, std::vector<T> &params)
+    {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+            return false;
+        std::string text;
+        char buf[4096];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), file)) > 0)
+            text.append(buf, n);
+        std::fclose(file);
+
+        std::vector<T> values;
+        const char *p = text.data();
+        const char *end = p + text.size();
+        while (p < end)
+        {
+            if (*p == '\n' || *p == '\r' || *p == ' ')
+            {
+                ++p;
+                continue;
+            }
+            T value{};
+            auto res = std::from_chars(p, end, value);
+            if (res.ec != std::errc())
+                return false;
+            values.push_back(value);
+            p = res.ptr;
+        }
+        params = std::move(values);
+        return true;
+    }
+
+    // Periodic, crash-safe checkpointing off the training thread.
+    //
+    // snapshot() only copies the parameters into a staging buffer (the lock is
+    // held for that copy, never for I/O) and returns. A background thread picks
+    // up the most recent snapshot and writes it with write_params_atomically.
+    // If snapshots arrive faster than the disk can take them, intermediate
+    // ones are skipped: only the latest state is worth persisting.
+    template <typename T>
+    class AsyncCheckpointer
+    {
+    public:
+        explicit AsyncCheckpointer(std::string path) : path_(std::move(path))
+        {
+            worker_ = std::thread([this]
+                                  { run(); });
+        }
+
+        ~AsyncCheckpointer()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+            worker_.join();
+        }
+
+        AsyncCheckpointer(const AsyncCheckpointer &) = delete;
+        AsyncCheckpointer &operator=(const AsyncCheckpointer &) = delete;
+
+        void snapshot(const std::vector<T> &params)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                staging_.assign(params.begin(), params.end());
+                ++requested_;
+            }
+            cv_.notify_all();
+        }
+
+        // Blocks until the latest snapshot is on disk. Throws if it failed.
+        void flush()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]
+                     { return completed_ == requested_; });
+            if (failed_)
+            {
+                throw std::runtime_error("Could not write checkpoint: " + path_);
+            }
+        }
+
+        uint64_t checkpoints_written() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return written_;
+        }
+
+        const std::string &path() const { return path_; }
+
+    private:
+        void run()
+        {
+            std::vector<T> writing;
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                cv_.wait(lock, [this]
+                         { return stop_ || completed_ != requested_; });
+                if (completed_ == requested_)
+                    break; // stop requested and nothing pending
+
+                uint64_t version = requested_;
+                writing.swap(staging_);
+                lock.unlock();
+                bool ok = write_params_atomically(path_, writing);
+                lock.lock();
+
+                failed_ = !ok;
+                written_ += ok;
+                completed_ = version;
+                cv_.notify_all();
+            }
+        }
+
+        std::string path_;
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::vector<T> staging_;
+        uint64_t requested_ = 0;
+        uint64_t completed_ = 0;
+        uint64_t written_ = 0;
+        bool failed_ = false;
+        bool stop_ = false;
+        std::thread worker_;
+    };
+
+} // namespace utec::io
+
+#endif // UTEC_IO_CHECKPOINTER_H
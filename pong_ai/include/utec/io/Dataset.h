@@ -0,0 +1,93 @@
+#ifndef UTEC_IO_DATASET_H
+#define UTEC_IO_DATASET_H
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../algebra/Tensor.h"
+
+namespace utec::io
+{
+
+    // Function to read CSV files into vectors
+    inline std::vector<std::vector<float>> read_input_csv(const std::string &filename)
+    {
+        std::vector<std::vector<float>> data;
+        std::ifstream file(filename);
+
+        if (!file)
+        {
+            std::cerr << "Error: Could not open input file: " << filename << "\n";
+            return data;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty())
+                continue;
+
+            std::vector<float> row;
+            std::stringstream ss(line);
+            std::string value;
+
+            while (std::getline(ss, value, ','))
+            {
+                try
+                {
+                    row.push_back(std::stof(value));
+                }
+                catch (...)
+                {
+                    std::cerr << "Warning: Invalid float value in input CSV: '" << value << "'\n";
+                    row.clear();
+                    break;
+                }
+            }
+
+            // Verify exactly 3 values per row (ball_x, ball_y, paddle_y)
+            if (row.size() == 3)
+            {
+                data.push_back(row);
+            }
+            else if (!row.empty())
+            {
+                std::cerr << "Warning: Expected 3 values per row, got " << row.size() << "\n";
+            }
+        }
+
+        if (data.empty())
+        {
+            std::cerr << "Error: No valid data found in input file\n";
+        }
+        else
+        {
+            std::cout << "Successfully loaded " << data.size() << " input samples\n";
+            std::cout << "First sample: "
+                      << data[0][0] << ", "
+                      << data[0][1] << ", "
+                      << data[0][2] << "\n";
+        }
+
+        return data;
+    }
+
+    // Rows of read_input_csv as a [samples, 3] tensor
+    inline utec::algebra::Tensor<float, 2> to_tensor(const std::vector<std::vector<float>> &rows)
+    {
+        utec::algebra::Tensor<float, 2> X(rows.size(), 3);
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                X(i, j) = rows[i][j];
+            }
+        }
+        return X;
+    }
+
+} // namespace utec::io
+
+#endif // UTEC_IO_DATASET_H
@@ -0,0 +1,849 @@
+#ifndef UTEC_IO_POLICYSERVER_H
+#define UTEC_IO_POLICYSERVER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../agent/PongAgent.h"
+#include "Checkpointer.h"
+
+// Local policy service: one process holds the network, any number of
+// processes on the same host ask it for actions (POSIX only).
+//
+//     PolicyServer<float> server(std::move(model), {"/tmp/pong_policy.sock"});
+//
+//     PolicyClient policy("/tmp/pong_policy.sock");   // in each game process
+//     int action = policy.act(state);
+//     std::vector<int> actions = policy.act_batch(states);
+//
+// Control goes over a Unix domain socket. A connecting client is given one
+// of max_clients channels of a POSIX shared-memory segment, and closing the
+// socket (or exiting) gives it back. The socket also takes
+// "RELOAD <params file>", which hot-swaps the weights under running
+// requests (PongAgent::establecer_parametros), and "STATS".
+//
+// A channel is a single-producer/single-consumer ring of request slots: the
+// client writes states into a slot and advances `submitted`, the server
+// writes the actions into the same slot and advances `completed`. The
+// serving thread drains every channel into one batch and runs a single
+// forward pass, so clients asking at the same time share one GEMM instead
+// of running one GEMV each. Idle sides sleep on futexes inside the segment
+// (Linux; other systems poll with short sleeps).
+
+namespace utec::io
+{
+
+    struct PolicyServerConfig
+    {
+        std::string socket_path = "/tmp/pong_policy.sock";
+        size_t max_clients = 16;
+        size_t max_batch = 512; // States per forward pass
+    };
+
+    struct PolicyServerStats
+    {
+        uint64_t requests = 0;       // Request slots answered
+        uint64_t states = 0;         // States answered
+        uint64_t batches = 0;        // Forward passes
+        size_t max_batch_states = 0; // Largest forward pass
+        uint64_t protocol_errors = 0; // Channels closed for a malformed request
+    };
+
+    namespace detail
+    {
+        constexpr uint32_t policy_magic = 0x504F4C31; // "POL1"
+        constexpr size_t policy_slot_states = 64;    // States per request slot
+        constexpr uint32_t policy_ring_slots = 8;    // Requests in flight per client
+
+        static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                      "shared-memory channels need address-free atomics");
+
+        // Sleeps while word == expected, at most timeout_ns (< 1 s). Shared
+        // (not PRIVATE) futex: waiter and waker may be different processes.
+        inline void futex_wait(std::atomic<uint32_t> &word, uint32_t expected, long timeout_ns)
+        {
+#if defined(__linux__)
+            timespec timeout{0, timeout_ns};
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+            if (word.load() == expected)
+                std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(timeout_ns, 100000L)));
+#endif
+        }
+
+        inline void futex_wake(std::atomic<uint32_t> &word)
+        {
+#if defined(__linux__)
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#else
+            (void)word;
+#endif
+        }
+
+        // a has reached b on a wrapping 32-bit sequence
+        inline bool seq_reached(uint32_t a, uint32_t b)
+        {
+            return static_cast<int32_t>(a - b) >= 0;
+        }
+
+        struct PolicySlot
+        {
+            uint32_t count;
+            float states[policy_slot_states][3];
+            int8_t actions[policy_slot_states];
+        };
+
+        enum ChannelState : uint32_t
+        {
+            channel_free = 0,    // Unassigned
+            channel_active = 1,  // Owned by a connected client
+            channel_closing = 2, // Client gone; the serving thread frees it
+            channel_faulted = 3, // Protocol error; the control thread drops the client
+        };
+
+        struct alignas(64) PolicyChannel
+        {
+            std::atomic<uint32_t> state{channel_free};
+            alignas(64) std::atomic<uint32_t> submitted{0}; // Written by the client
+            std::atomic<uint32_t> client_waiting{0};
+            alignas(64) std::atomic<uint32_t> completed{0}; // Written by the server
+            PolicySlot slots[policy_ring_slots];
+        };
+
+        struct alignas(64) PolicySegmentHeader
+        {
+            uint32_t magic = policy_magic;
+            uint32_t max_clients = 0;
+            std::atomic<uint32_t> shutdown{0};
+            alignas(64) std::atomic<uint32_t> doorbell{0}; // Bumped by clients on submit
+            std::atomic<uint32_t> server_waiting{0};
+        };
+
+        inline std::runtime_error system_error(const std::string &what)
+        {
+            return std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        // Mapping of the shared segment: header followed by the channels
+        class PolicySegment
+        {
+        public:
+            PolicySegment() = default;
+            PolicySegment(const PolicySegment &) = delete;
+            PolicySegment &operator=(const PolicySegment &) = delete;
+
+            ~PolicySegment()
+            {
+                if (base_ != nullptr)
+                    munmap(base_, bytes_);
+            }
+
+            static size_t bytes_for(size_t clients)
+            {
+                return sizeof(PolicySegmentHeader) + clients * sizeof(PolicyChannel);
+            }
+
+            void create(const std::string &name, size_t clients)
+            {
+                const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+                if (fd < 0)
+                    throw system_error("shm_open " + name);
+                bytes_ = bytes_for(clients);
+                if (ftruncate(fd, static_cast<off_t>(bytes_)) != 0)
+                {
+                    ::close(fd);
+                    shm_unlink(name.c_str());
+                    throw system_error("ftruncate " + name);
+                }
+                map(fd, name);
+                auto *header = new (base_) PolicySegmentHeader();
+                header->max_clients = static_cast<uint32_t>(clients);
+                for (size_t i = 0; i < clients; ++i)
+                    new (&channel(i)) PolicyChannel();
+            }
+
+            void open(const std::string &name)
+            {
+                const int fd = shm_open(name.c_str(), O_RDWR, 0);
+                if (fd < 0)
+                    throw system_error("shm_open " + name);
+                struct stat info;
+                if (fstat(fd, &info) != 0)
+                {
+                    ::close(fd);
+                    throw system_error("fstat " + name);
+                }
+                bytes_ = static_cast<size_t>(info.st_size);
+                if (bytes_ < sizeof(PolicySegmentHeader))
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Not a policy segment: " + name);
+                }
+                map(fd, name);
+                if (header().magic != policy_magic || bytes_ < bytes_for(header().max_clients))
+                    throw std::runtime_error("Not a policy segment: " + name);
+            }
+
+            PolicySegmentHeader &header() const
+            {
+                return *reinterpret_cast<PolicySegmentHeader *>(base_);
+            }
+
+            PolicyChannel &channel(size_t i) const
+            {
+                return reinterpret_cast<PolicyChannel *>(static_cast<char *>(base_) + sizeof(PolicySegmentHeader))[i];
+            }
+
+        private:
+            void map(int fd, const std::string &name)
+            {
+                void *p = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                ::close(fd);
+                if (p == MAP_FAILED)
+                    throw system_error("mmap " + name);
+                base_ = p;
+            }
+
+            void *base_ = nullptr;
+            size_t bytes_ = 0;
+        };
+
+        inline sockaddr_un socket_address(const std::string &path)
+        {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (path.empty() || path.size() >= sizeof(addr.sun_path))
+                throw std::invalid_argument("Invalid Unix socket path: " + path);
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+            return addr;
+        }
+
+        // Connected stream socket, or -1
+        inline int connect_unix(const std::string &path)
+        {
+            const sockaddr_un addr = socket_address(path);
+            const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0)
+                return -1;
+            if (::connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0)
+            {
+                ::close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        // MSG_NOSIGNAL: a peer that went away is an error, not a SIGPIPE
+        inline bool send_line(int fd, const std::string &line)
+        {
+            const std::string text = line + "\n";
+            size_t sent = 0;
+            while (sent < text.size())
+            {
+                const ssize_t n = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    return false;
+                sent += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        // Blocking; false on EOF or error
+        inline bool receive_line(int fd, std::string &line)
+        {
+            line.clear();
+            char c;
+            while (true)
+            {
+                const ssize_t n = ::recv(fd, &c, 1, 0);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    return false;
+                if (c == '\n')
+                    return true;
+                line.push_back(c);
+            }
+        }
+    } // namespace detail
+
+    // Serves one model to every PolicyClient of socket_path, on two threads
+    // of its own (control and serving) until stop() or destruction.
+    template <typename T>
+    class PolicyServer
+    {
+    public:
+        PolicyServer(std::unique_ptr<utec::neural_network::ILayer<T>> model, PolicyServerConfig config = {})
+            : agent_(std::move(model)), config_(std::move(config))
+        {
+            if (config_.max_clients == 0 || config_.max_batch < detail::policy_slot_states)
+                throw std::invalid_argument("PolicyServer needs a client and a batch of at least one slot");
+
+            static std::atomic<uint32_t> instances{0};
+            segment_name_ = "/utec_policy_" + std::to_string(::getpid()) + "_" + std::to_string(instances++);
+            segment_.create(segment_name_, config_.max_clients);
+            try
+            {
+                listen_fd_ = listen_unix(config_.socket_path);
+            }
+            catch (...)
+            {
+                shm_unlink(segment_name_.c_str());
+                throw;
+            }
+
+            batch_.reserve(config_.max_batch);
+            actions_.resize(config_.max_batch);
+            serve_thread_ = std::thread([this]
+                                        { serve(); });
+            control_thread_ = std::thread([this]
+                                          { control(); });
+        }
+
+        ~PolicyServer() { stop(); }
+
+        PolicyServer(const PolicyServer &) = delete;
+        PolicyServer &operator=(const PolicyServer &) = delete;
+
+        // Stops serving; clients waiting for an answer get an exception
+        void stop()
+        {
+            if (stop_.exchange(true))
+                return;
+            auto &header = segment_.header();
+            header.shutdown.store(1);
+            header.doorbell.fetch_add(1);
+            detail::futex_wake(header.doorbell);
+            serve_thread_.join();
+            control_thread_.join();
+            for (size_t i = 0; i < config_.max_clients; ++i)
+                detail::futex_wake(segment_.channel(i).completed);
+            ::close(listen_fd_);
+            ::unlink(config_.socket_path.c_str());
+            // Mapped clients keep their view; the name is gone for new ones
+            shm_unlink(segment_name_.c_str());
+        }
+
+        // Hot swap without pausing the clients (see PongAgent)
+        void reload(const std::vector<T> &params)
+        {
+            agent_.establecer_parametros(params);
+        }
+
+        uint64_t model_version() const { return agent_.model_version(); }
+
+        PolicyServerStats stats() const
+        {
+            PolicyServerStats s;
+            s.requests = requests_.load();
+            s.states = states_.load();
+            s.batches = batches_.load();
+            s.max_batch_states = max_batch_states_.load();
+            s.protocol_errors = protocol_errors_.load();
+            return s;
+        }
+
+        size_t connected_clients() const { return connected_.load(); }
+        const std::string &socket_path() const { return config_.socket_path; }
+
+    private:
+        // A request slot taking part in the current batch
+        struct Pending
+        {
+            detail::PolicyChannel *channel;
+            uint32_t seq;
+            size_t offset;
+            uint32_t count;
+        };
+
+        // Connection of one client on the control socket
+        struct Connection
+        {
+            int fd;
+            size_t channel;
+            std::string buffer;
+        };
+
+        static int listen_unix(const std::string &path)
+        {
+            const sockaddr_un addr = detail::socket_address(path);
+            // A leftover socket file of a dead server is replaced; a live one is not
+            const int probe = detail::connect_unix(path);
+            if (probe >= 0)
+            {
+                ::close(probe);
+                throw std::runtime_error("Policy server already running at " + path);
+            }
+            ::unlink(path.c_str());
+
+            const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0)
+                throw detail::system_error("socket");
+            if (::bind(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(fd, 64) != 0)
+            {
+                ::close(fd);
+                throw detail::system_error("bind " + path);
+            }
+            return fd;
+        }
+
+        // ---- Serving thread -------------------------------------------------
+
+        void serve()
+        {
+            while (!stop_.load())
+            {
+                gather();
+                if (pending_.empty())
+                {
+                    idle_wait();
+                    continue;
+                }
+                agent_.act_batch(batch_.data(), batch_.size(), actions_.data());
+                answer();
+            }
+        }
+
+        // Collects submitted requests of every channel, starting at a
+        // rotating channel so a full batch does not always favor the first
+        void gather()
+        {
+            batch_.clear();
+            pending_.clear();
+            const size_t clients = config_.max_clients;
+            for (size_t n = 0; n < clients; ++n)
+            {
+                auto &channel = segment_.channel((first_channel_ + n) % clients);
+                const uint32_t state = channel.state.load(std::memory_order_acquire);
+                if (state == detail::channel_closing)
+                {
+                    // Nothing of the old client is in flight any more
+                    channel.state.store(detail::channel_free, std::memory_order_release);
+                    continue;
+                }
+                if (state != detail::channel_active)
+                    continue;
+
+                // submitted and slot.count come from client memory: a client
+                // can have at most a full ring in flight, each slot non-empty
+                const uint32_t submitted = channel.submitted.load(std::memory_order_acquire);
+                const uint32_t completed = channel.completed.load(std::memory_order_relaxed);
+                const uint32_t in_flight = submitted - completed;
+                if (in_flight > detail::policy_ring_slots)
+                {
+                    fault(channel);
+                    continue;
+                }
+                const size_t pending_before = pending_.size(), batch_before = batch_.size();
+                for (uint32_t k = 0; k < in_flight; ++k)
+                {
+                    const uint32_t seq = completed + k;
+                    const auto &slot = channel.slots[seq % detail::policy_ring_slots];
+                    const uint32_t count = slot.count;
+                    if (count == 0 || count > detail::policy_slot_states)
+                    {
+                        // Drop what this channel already added to the batch
+                        pending_.resize(pending_before);
+                        batch_.resize(batch_before);
+                        fault(channel);
+                        break;
+                    }
+                    if (batch_.size() + count > config_.max_batch)
+                    {
+                        first_channel_ = (first_channel_ + n) % clients;
+                        return;
+                    }
+                    pending_.push_back({&channel, seq, batch_.size(), count});
+                    for (uint32_t i = 0; i < count; ++i)
+                        batch_.push_back({slot.states[i][0], slot.states[i][1], slot.states[i][2]});
+                }
+            }
+            first_channel_ = (first_channel_ + 1) % clients;
+        }
+
+        // Stops serving a channel that broke the protocol. The control thread
+        // closes its connection; a waiting client sees the state and throws.
+        void fault(detail::PolicyChannel &channel)
+        {
+            uint32_t expected = detail::channel_active;
+            if (!channel.state.compare_exchange_strong(expected, detail::channel_faulted, std::memory_order_acq_rel))
+                return; // Already released by the control thread
+            ++protocol_errors_;
+            detail::futex_wake(channel.completed);
+        }
+
+        // Writes the actions back, in submission order within each channel
+        void answer()
+        {
+            // Count the batch first, so a client that sees its answer also
+            // sees it in stats()
+            requests_ += pending_.size();
+            states_ += batch_.size();
+            ++batches_;
+            if (batch_.size() > max_batch_states_.load())
+                max_batch_states_.store(batch_.size());
+            for (const Pending &p : pending_)
+            {
+                auto &slot = p.channel->slots[p.seq % detail::policy_ring_slots];
+                for (uint32_t i = 0; i < p.count; ++i)
+                    slot.actions[i] = static_cast<int8_t>(actions_[p.offset + i]);
+                p.channel->completed.store(p.seq + 1);
+                if (p.channel->client_waiting.load())
+                    detail::futex_wake(p.channel->completed);
+            }
+        }
+
+        bool has_work() const
+        {
+            for (size_t i = 0; i < config_.max_clients; ++i)
+            {
+                const auto &channel = segment_.channel(i);
+                const uint32_t state = channel.state.load();
+                if (state == detail::channel_closing ||
+                    (state == detail::channel_active && channel.submitted.load() != channel.completed.load()))
+                    return true;
+            }
+            return false;
+        }
+
+        // Sleeps until a client rings the doorbell. server_waiting is set
+        // before the last look at the channels, so a submit after that look
+        // sees it and wakes us.
+        void idle_wait()
+        {
+            auto &header = segment_.header();
+            const uint32_t ring = header.doorbell.load();
+            header.server_waiting.store(1);
+            if (!has_work() && !stop_.load())
+                detail::futex_wait(header.doorbell, ring, 10'000'000);
+            header.server_waiting.store(0);
+        }
+
+        // ---- Control thread -------------------------------------------------
+
+        void control()
+        {
+            std::vector<Connection> connections;
+            std::vector<pollfd> fds;
+            while (!stop_.load())
+            {
+                fds.assign(1, {listen_fd_, POLLIN, 0});
+                for (const auto &c : connections)
+                    fds.push_back({c.fd, POLLIN, 0});
+                const int ready = ::poll(fds.data(), fds.size(), 50);
+                drop_faulted(connections, fds);
+                if (ready <= 0)
+                    continue;
+
+                // Served before accepting, so indices still match fds
+                for (size_t i = connections.size(); i-- > 0;)
+                {
+                    if (fds[i + 1].revents == 0)
+                        continue;
+                    if (!handle_input(connections[i]))
+                    {
+                        release(connections[i]);
+                        connections.erase(connections.begin() + static_cast<std::ptrdiff_t>(i));
+                    }
+                }
+                if (fds[0].revents & POLLIN)
+                    accept_client(connections);
+            }
+            for (auto &c : connections)
+                release(c);
+        }
+
+        // Disconnects clients whose channel the serving thread faulted
+        void drop_faulted(std::vector<Connection> &connections, std::vector<pollfd> &fds)
+        {
+            for (size_t i = connections.size(); i-- > 0;)
+            {
+                if (segment_.channel(connections[i].channel).state.load(std::memory_order_acquire) !=
+                    detail::channel_faulted)
+                    continue;
+                release(connections[i]);
+                connections.erase(connections.begin() + static_cast<std::ptrdiff_t>(i));
+                fds.erase(fds.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            }
+        }
+
+        void accept_client(std::vector<Connection> &connections)
+        {
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0)
+                return;
+            for (size_t i = 0; i < config_.max_clients; ++i)
+            {
+                auto &channel = segment_.channel(i);
+                if (channel.state.load(std::memory_order_acquire) != detail::channel_free ||
+                    std::any_of(connections.begin(), connections.end(),
+                                [i](const Connection &c)
+                                { return c.channel == i; }))
+                    continue;
+                // Free channels are not touched by the serving thread
+                channel.submitted.store(0);
+                channel.completed.store(0);
+                channel.client_waiting.store(0);
+                channel.state.store(detail::channel_active, std::memory_order_release);
+                if (!detail::send_line(fd, "ATTACH " + std::to_string(i) + " " + segment_name_))
+                {
+                    channel.state.store(detail::channel_closing);
+                    ::close(fd);
+                    return;
+                }
+                connections.push_back({fd, i, {}});
+                ++connected_;
+                return;
+            }
+            detail::send_line(fd, "FULL");
+            ::close(fd);
+        }
+
+        // Reads and answers complete command lines; false once the client is gone
+        bool handle_input(Connection &c)
+        {
+            char buf[512];
+            const ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+            if (n < 0 && errno == EINTR)
+                return true;
+            if (n <= 0)
+                return false;
+            c.buffer.append(buf, static_cast<size_t>(n));
+            size_t eol;
+            while ((eol = c.buffer.find('\n')) != std::string::npos)
+            {
+                const std::string line = c.buffer.substr(0, eol);
+                c.buffer.erase(0, eol + 1);
+                if (!detail::send_line(c.fd, command(line)))
+                    return false;
+            }
+            return c.buffer.size() <= 4096;
+        }
+
+        std::string command(const std::string &line)
+        {
+            if (line.rfind("RELOAD ", 0) == 0)
+            {
+                std::vector<T> params;
+                if (!read_params(line.substr(7), params))
+                    return "ERROR cannot read " + line.substr(7);
+                if (params.size() != agent_.obtener_parametros().size())
+                    return "ERROR expected " + std::to_string(agent_.obtener_parametros().size()) + " parameters";
+                reload(params);
+                return "OK " + std::to_string(model_version());
+            }
+            if (line == "STATS")
+            {
+                const PolicyServerStats s = stats();
+                return "STATS " + std::to_string(s.requests) + " " + std::to_string(s.states) + " " +
+                       std::to_string(s.batches);
+            }
+            return "ERROR unknown command";
+        }
+
+        // The serving thread frees the channel once it sees it closing
+        void release(Connection &c)
+        {
+            ::close(c.fd);
+            segment_.channel(c.channel).state.store(detail::channel_closing, std::memory_order_release);
+            segment_.header().doorbell.fetch_add(1);
+            detail::futex_wake(segment_.header().doorbell);
+            --connected_;
+        }
+
+        utec::nn::PongAgent<T> agent_;
+        PolicyServerConfig config_;
+        std::string segment_name_;
+        detail::PolicySegment segment_;
+        int listen_fd_ = -1;
+
+        // Serving thread only
+        std::vector<utec::nn::State> batch_;
+        std::vector<int> actions_;
+        std::vector<Pending> pending_;
+        size_t first_channel_ = 0;
+
+        std::atomic<bool> stop_{false};
+        std::atomic<uint64_t> requests_{0}, states_{0}, batches_{0};
+        std::atomic<size_t> max_batch_states_{0};
+        std::atomic<uint64_t> protocol_errors_{0};
+        std::atomic<size_t> connected_{0};
+        std::thread serve_thread_, control_thread_;
+    };
+
+    // Connection to a PolicyServer. Calls from several threads of one client
+    // are serialized; give each thread its own client to overlap them.
+    class PolicyClient
+    {
+    public:
+        explicit PolicyClient(const std::string &socket_path)
+        {
+            fd_ = detail::connect_unix(socket_path);
+            if (fd_ < 0)
+                throw detail::system_error("connect " + socket_path);
+            std::string reply;
+            if (!detail::receive_line(fd_, reply) || reply.rfind("ATTACH ", 0) != 0)
+            {
+                ::close(fd_);
+                throw std::runtime_error(reply == "FULL" ? "Policy server has no free channel"
+                                                         : "Policy server handshake failed");
+            }
+            const size_t space = reply.find(' ', 7);
+            try
+            {
+                const size_t index = std::stoul(reply.substr(7, space - 7));
+                segment_.open(reply.substr(space + 1));
+                if (index >= segment_.header().max_clients)
+                    throw std::runtime_error("Policy server sent an invalid channel");
+                channel_ = &segment_.channel(index);
+            }
+            catch (...)
+            {
+                ::close(fd_);
+                throw;
+            }
+            next_seq_ = channel_->submitted.load();
+        }
+
+        ~PolicyClient()
+        {
+            // The server releases the channel when it sees the socket close
+            ::close(fd_);
+        }
+
+        PolicyClient(const PolicyClient &) = delete;
+        PolicyClient &operator=(const PolicyClient &) = delete;
+
+        int act(const utec::nn::State &state)
+        {
+            int action;
+            act_batch(&state, 1, &action);
+            return action;
+        }
+
+        // Splits the states into request slots and keeps up to the whole ring
+        // in flight, so the server can batch them in one pass
+        void act_batch(const utec::nn::State *states, size_t count, int *actions)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t sent = 0, received = 0;
+            uint32_t collect = next_seq_;
+            while (received < count)
+            {
+                bool submitted = false;
+                while (sent < count && next_seq_ - collect < detail::policy_ring_slots)
+                {
+                    auto &slot = channel_->slots[next_seq_ % detail::policy_ring_slots];
+                    const size_t n = std::min(detail::policy_slot_states, count - sent);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        slot.states[i][0] = states[sent + i].ball_x;
+                        slot.states[i][1] = states[sent + i].ball_y;
+                        slot.states[i][2] = states[sent + i].paddle_y;
+                    }
+                    slot.count = static_cast<uint32_t>(n);
+                    channel_->submitted.store(++next_seq_, std::memory_order_release);
+                    sent += n;
+                    submitted = true;
+                }
+                if (submitted)
+                    ring_doorbell();
+
+                wait_completed(collect + 1);
+                const auto &slot = channel_->slots[collect % detail::policy_ring_slots];
+                for (uint32_t i = 0; i < slot.count; ++i)
+                    actions[received + i] = slot.actions[i];
+                received += slot.count;
+                ++collect;
+            }
+        }
+
+        std::vector<int> act_batch(const std::vector<utec::nn::State> &states)
+        {
+            std::vector<int> actions(states.size());
+            act_batch(states.data(), states.size(), actions.data());
+            return actions;
+        }
+
+        // Asks the server to hot-swap its weights from a parameter file (a
+        // path the server can read). False if the server rejected it.
+        bool reload(const std::string &params_path)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::string reply;
+            return detail::send_line(fd_, "RELOAD " + params_path) && detail::receive_line(fd_, reply) &&
+                   reply.rfind("OK ", 0) == 0;
+        }
+
+    private:
+        void ring_doorbell()
+        {
+            auto &header = segment_.header();
+            header.doorbell.fetch_add(1);
+            if (header.server_waiting.load())
+                detail::futex_wake(header.doorbell);
+        }
+
+        // Spins briefly (the server usually answers within microseconds),
+        // then sleeps on the completion counter
+        void wait_completed(uint32_t target)
+        {
+            for (int spin = 0; spin < 64; ++spin)
+            {
+                if (detail::seq_reached(channel_->completed.load(std::memory_order_acquire), target))
+                    return;
+                std::this_thread::yield();
+            }
+            while (true)
+            {
+                if (segment_.header().shutdown.load())
+                    throw std::runtime_error("Policy server stopped");
+                if (channel_->state.load(std::memory_order_acquire) != detail::channel_active)
+                    throw std::runtime_error("Policy server closed the channel");
+                channel_->client_waiting.store(1);
+                const uint32_t seen = channel_->completed.load();
+                if (!detail::seq_reached(seen, target))
+                    detail::futex_wait(channel_->completed, seen, 50'000'000);
+                channel_->client_waiting.store(0);
+                if (detail::seq_reached(channel_->completed.load(std::memory_order_acquire), target))
+                    return;
+            }
+        }
+
+        int fd_ = -1;
+        detail::PolicySegment segment_;
+        detail::PolicyChannel *channel_ = nullptr;
+        uint32_t next_seq_ = 0;
+        std::mutex mutex_;
+    };
+
+} // namespace utec::io
+
+#endif // UTEC_IO_POLICYSERVER_H
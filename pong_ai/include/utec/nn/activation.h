@@ -3,6 +3,8 @@
 
 #include "layer.h"
 #include "../algebra/Tensor.h"
+#include <stdexcept>
+#include <string>
 
 using namespace utec::algebra;
 
@@ -10,7 +12,7 @@ namespace utec::neural_network
 {
 
     template <typename T>
-    class ReLU : public ILayer<T>
+    class ReLU final : public ILayer<T>
     {
     private:
         Tensor<T, 2> mask; // Mask for backpropagation
@@ -18,43 +20,75 @@ namespace utec::neural_network
     public:
         Tensor<T, 2> forward(const Tensor<T, 2> &x) override
         {
-            auto shape = x.shape();
-            mask = Tensor<T, 2>(shape);
-            Tensor<T, 2> output(shape);
+            Tensor<T, 2> output;
+            forward_into(x, output);
+            return output;
+        }
 
-            for (size_t i = 0; i < x.shape()[0]; i++)
+        void forward_into(const Tensor<T, 2> &x, Tensor<T, 2> &out,
+                          bool /*input_is_retained*/ = false) override
+        {
+            UTEC_PROFILE_SCOPE(scope, "ReLU", "forward");
+            mask.resize(x.shape());
+            out.resize(x.shape());
+            const T *xp = x.data();
+            T *m = mask.data();
+            T *o = out.data();
+            for (size_t i = 0; i < x.size(); i++)
             {
-                for (size_t j = 0; j < x.shape()[1]; j++)
-                {
-                    T val = x(i, j);
-                    if (val > 0)
-                    {
-                        output(i, j) = val;
-                        mask(i, j) = 1;
-                    }
-                    else
-                    {
-                        output(i, j) = 0;
-                        mask(i, j) = 0;
-                    }
-                }
+                bool active = xp[i] > 0;
+                o[i] = active ? xp[i] : 0;
+                m[i] = active ? 1 : 0;
             }
-            return output;
         }
 
-        Tensor<T, 2> backward(const Tensor<T, 2> &grad) override
+        void infer_into(const Tensor<T, 2> &x, Tensor<T, 2> &out) override
         {
-            Tensor<T, 2> output(grad.shape());
-            for (size_t i = 0; i < grad.shape()[0]; i++)
+            UTEC_PROFILE_SCOPE(scope, "ReLU", "infer");
+            out.resize(x.shape());
+            const T *xp = x.data();
+            T *o = out.data();
+            for (size_t i = 0; i < x.size(); i++)
             {
-                for (size_t j = 0; j < grad.shape()[1]; j++)
-                {
-                    output(i, j) = grad(i, j) * mask(i, j);
-                }
+                o[i] = xp[i] > 0 ? xp[i] : 0;
             }
+        }
+
+        Tensor<T, 2> backward(const Tensor<T, 2> &grad) override
+        {
+            Tensor<T, 2> output;
+            backward_into(grad, output);
             return output;
         }
 
+        void backward_into(const Tensor<T, 2> &grad, Tensor<T, 2> &dx) override
+        {
+            // Also catches a backward without forward (or after release_cache)
+            if (grad.shape() != mask.shape())
+            {
+                throw std::invalid_argument("Gradient shape mismatch: expected [" +
+                                            std::to_string(mask.shape()[0]) + ", " +
+                                            std::to_string(mask.shape()[1]) + "], got [" +
+                                            std::to_string(grad.shape()[0]) + ", " +
+                                            std::to_string(grad.shape()[1]) + "]");
+            }
+            UTEC_PROFILE_SCOPE(scope, "ReLU", "backward");
+            UTEC_PROFILE_FLOPS(scope, grad.size());
+            dx.resize(grad.shape());
+            const T *g = grad.data();
+            const T *m = mask.data();
+            T *d = dx.data();
+            for (size_t i = 0; i < grad.size(); i++)
+            {
+                d[i] = g[i] * m[i];
+            }
+        }
+
+        void release_cache() override
+        {
+            mask = Tensor<T, 2>();
+        }
+
         void update(T /*lr*/) override
         {
             // ReLU has no parameters to update
@@ -63,6 +97,11 @@ namespace utec::neural_network
         size_t contar_parametros() const override { return 0; }
         std::vector<T> obtener_parametros() const override { return {}; }
         void establecer_parametros(const std::vector<T> &) override {}
+
+        std::unique_ptr<ILayer<T>> clone() const override
+        {
+            return std::make_unique<ReLU<T>>();
+        }
     };
 
 } // namespace utec::neural_network
@@ -3,9 +3,14 @@
 
 #include "layer.h"
 #include "../algebra/Tensor.h"
+#include "../algebra/Reduce.h"
+#include "../random/Philox.h"
+#include <atomic>
 #include <cmath>
-#include <cstdlib>
+#include <cstdint>
 #include <iostream>
+#include <algorithm>
+#include <mutex>
 
 using namespace utec::algebra;
 
@@ -13,14 +18,54 @@ namespace utec::neural_network
 {
 
     template <typename T>
-    class Dense : public ILayer<T>
+    class Dense final : public ILayer<T>
     {
     private:
-        utec::algebra::Tensor<T, 2> W;      // Weights [in_feats, out_feats]
-        utec::algebra::Tensor<T, 2> dW;     // Weight gradients
+        // W and dW rows are padded to padded_leading_dim(out_feats), so the
+        // kernels stepping from row to row do not alias in cache on
+        // power-of-two widths. Columns past out_feats stay zero.
+        utec::algebra::Tensor<T, 2> W;      // Weights [in_feats, ld]
+        utec::algebra::Tensor<T, 2> dW;     // Weight gradients [in_feats, ld]
+        size_t ld = 0;                      // Row stride of W and dW
         utec::algebra::Tensor<T, 1> b;      // Biases [out_feats]
         utec::algebra::Tensor<T, 1> db;     // Bias gradients
         utec::algebra::Tensor<T, 2> last_x; // Last input cache
+        const utec::algebra::Tensor<T, 2> *input_ref = nullptr; // Retained input (ExecutionPlan)
+
+        // Inference copy of W in column panels (see pack_weights). Rebuilt
+        // lazily by the first infer_into after the weights change.
+        static constexpr size_t line = std::max<size_t>(1, utec::algebra::cache_line / sizeof(T));
+        static constexpr size_t wide_panel = 4 * line;
+        static constexpr uint64_t never_packed = ~uint64_t{0};
+        utec::algebra::Tensor<T, 1> packed;
+        size_t panel = wide_panel;
+        uint64_t weights_version = 0;                  // Bumped by every write to W
+        std::atomic<uint64_t> packed_version{never_packed}; // weights_version packed
+        std::mutex pack_mutex;
+
+        // He-scaled uniform initialization for ReLU: U(-1, 1) * sqrt(2 / in)
+        void init_weights(size_t in_feats, size_t out_feats, utec::random::Philox &rng)
+        {
+            utec::algebra::Tensor<T, 2> weights(in_feats, out_feats);
+            T stddev = static_cast<T>(std::sqrt(2.0 / in_feats));
+            rng.fill_uniform(weights.data(), weights.size(), -stddev, stddev);
+            set_weights(weights);
+        }
+
+        // Copies dense [in, out] weights into the padded layout
+        void set_weights(const utec::algebra::Tensor<T, 2> &weights)
+        {
+            const size_t in_feats = weights.shape()[0];
+            const size_t out_feats = weights.shape()[1];
+            ld = utec::algebra::padded_leading_dim<T>(out_feats);
+            W = utec::algebra::Tensor<T, 2>(in_feats, ld);
+            W.fill(0);
+            for (size_t k = 0; k < in_feats; ++k)
+                std::copy(weights.data() + k * out_feats, weights.data() + (k + 1) * out_feats, W.data() + k * ld);
+            dW = utec::algebra::Tensor<T, 2>(W.shape());
+        }
+
+        size_t out_features() const { return b.shape()[0]; }
 
     public:
         // Constructor for the Dense layer
@@ -33,23 +78,15 @@ namespace utec::neural_network
             // Check if the provided weights tensor is effectively empty (dimensions are zero)
             if (weights.shape()[0] == 0 || weights.shape()[1] == 0)
             {
-                W = utec::algebra::Tensor<T, 2>(in_feats, out_feats);
-                // He initialization for ReLU activation
-                T stddev = std::sqrt(2.0 / in_feats);
-                for (size_t i = 0; i < in_feats; i++)
-                {
-                    for (size_t j = 0; j < out_feats; j++)
-                    {
-                        // Generate random float between -1 and 1
-                        T val = static_cast<T>(rand()) / RAND_MAX;
-                        W(i, j) = (val * 2 - 1) * stddev;
-                    }
-                }
+                // Each layer draws from its own Philox stream of the global seed
+                utec::random::Philox rng(utec::random::global_seed(),
+                                         utec::random::next_stream<utec::random::LayerStreams>());
+                init_weights(in_feats, out_feats, rng);
             }
             else
             {
                 // Use the provided weights
-                W = weights;
+                set_weights(weights);
             }
 
             if (biases.shape()[0] == 0)
@@ -63,85 +100,180 @@ namespace utec::neural_network
                 b = biases;
             }
 
-            // Initialize gradients for weights and biases with the same shape
-            dW = utec::algebra::Tensor<T, 2>(W.shape());
+            // Initialize the bias gradients with the same shape
+            db = utec::algebra::Tensor<T, 1>(b.shape());
+        }
+
+        // Random weights from an explicit generator (reproducible regardless of
+        // how many other layers were built before, or on which thread)
+        Dense(size_t in_feats, size_t out_feats, utec::random::Philox &rng)
+        {
+            init_weights(in_feats, out_feats, rng);
+            b = utec::algebra::Tensor<T, 1>(out_feats);
+            b.fill(0);
             db = utec::algebra::Tensor<T, 1>(b.shape());
         }
 
         // Performs the forward pass of the dense layer: output = input * W + b
         utec::algebra::Tensor<T, 2> forward(const utec::algebra::Tensor<T, 2> &x) override
         {
-            // Debugging output for forward pass
+            utec::algebra::Tensor<T, 2> output;
+            forward_into(x, output);
+            return output;
+        }
 
-            // Store the input for use in the backward pass
-            last_x = x;
+        void forward_into(const utec::algebra::Tensor<T, 2> &x, utec::algebra::Tensor<T, 2> &out,
+                          bool input_is_retained = false) override
+        {
+            check_input(x);
+            UTEC_PROFILE_SCOPE(scope, "Dense", "forward");
+            UTEC_PROFILE_FLOPS(scope, 2 * x.shape()[0] * W.shape()[0] * out_features());
 
-            // Verify input dimensions match the weights
-            if (x.shape()[1] != W.shape()[0])
+            // Store the input (or a reference to it) for use in the backward pass
+            if (input_is_retained)
             {
-                throw std::invalid_argument("Input features mismatch: expected " +
-                                            std::to_string(W.shape()[0]) +
-                                            ", got " + std::to_string(x.shape()[1]));
+                input_ref = &x;
             }
-
-            // Perform matrix multiplication: output = x * W
-            utec::algebra::Tensor<T, 2> output = matmul(x, W);
-
-            // Add bias to each row of the output
-            for (size_t i = 0; i < output.shape()[0]; i++)
+            else
             {
-                for (size_t j = 0; j < output.shape()[1]; j++)
-                {
-                    output(i, j) += b(j);
-                }
+                last_x = x;
+                input_ref = nullptr;
             }
-            return output;
+            affine_into(x, out);
+        }
+
+        // Inference: GEMV per row over the packed weights, no zero-skip
+        // branch. Caches nothing, so concurrent calls on one layer are safe
+        // as long as nobody writes the weights meanwhile.
+        void infer_into(const utec::algebra::Tensor<T, 2> &x, utec::algebra::Tensor<T, 2> &out) override
+        {
+            check_input(x);
+            UTEC_PROFILE_SCOPE(scope, "Dense", "infer");
+            UTEC_PROFILE_FLOPS(scope, 2 * x.shape()[0] * W.shape()[0] * out_features());
+            const T *panels = packed_weights();
+            out.resize({x.shape()[0], out_features()});
+            if (panel == wide_panel)
+                packed_gemm<wide_panel>(x, panels, out);
+            else
+                packed_gemm<line>(x, panels, out);
         }
 
         // Performs the backward pass of the dense layer
         utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2> &grad) override
         {
-            // Calculate gradient with respect to weights (dW)
-            utec::algebra::Tensor<T, 2> last_xT = last_x.transpose_2d();
-            dW = matmul(last_xT, grad);
+            utec::algebra::Tensor<T, 2> d_input;
+            backward_into(grad, d_input);
+            return d_input;
+        }
 
-            // Calculate gradient with respect to biases (db)
-            for (size_t j = 0; j < grad.shape()[1]; j++)
+        void backward_into(const utec::algebra::Tensor<T, 2> &grad, utec::algebra::Tensor<T, 2> &dx) override
+        {
+            const utec::algebra::Tensor<T, 2> &x = input_ref ? *input_ref : last_x;
+            check_grad(grad, x);
+            const size_t batch = grad.shape()[0];
+            const size_t in_feats = W.shape()[0];
+            const size_t out_feats = out_features();
+            UTEC_PROFILE_SCOPE(scope, "Dense", "backward");
+            UTEC_PROFILE_FLOPS(scope, 4 * batch * in_feats * out_feats + batch * out_feats);
+            const T *g = grad.data();
+            const T *xp = x.data();
+            const T *w = W.data();
+
+            // dW = x^T * grad, accumulated row by row so the inner loop is contiguous
+            dW.fill(0);
+            T *dw = dW.data();
+            for (size_t i = 0; i < batch; i++)
             {
-                db(j) = 0; // Reset db for summation
-                for (size_t i = 0; i < grad.shape()[0]; i++)
+                const T *g_row = g + i * out_feats;
+                for (size_t k = 0; k < in_feats; k++)
                 {
-                    db(j) += grad(i, j);
+                    T xv = xp[i * in_feats + k];
+                    if (xv == static_cast<T>(0))
+                        continue;
+                    T *dw_row = dw + k * ld;
+                    for (size_t j = 0; j < out_feats; j++)
+                    {
+                        dw_row[j] += xv * g_row[j];
+                    }
                 }
             }
 
-            // Calculate gradient with respect to input (d_input)
-            utec::algebra::Tensor<T, 2> WT = W.transpose_2d();
-            return matmul(grad, WT);
-        }
+            // db = column sums of grad
+            utec::algebra::sum_into(grad, 0, db);
 
-        // Updates the weights and biases using the learning rate
-        void update(T lr) override
-        {
-            // Update weights
-            for (size_t i = 0; i < W.shape()[0]; i++)
+            // d_input = grad * W^T, computed as row dot products (no transpose copy)
+            dx.resize({batch, in_feats});
+            T *d = dx.data();
+            for (size_t i = 0; i < batch; i++)
             {
-                for (size_t j = 0; j < W.shape()[1]; j++)
+                const T *g_row = g + i * out_feats;
+                for (size_t k = 0; k < in_feats; k++)
                 {
-                    W(i, j) -= lr * dW(i, j);
+                    const T *w_row = w + k * ld;
+                    T acc = 0;
+                    for (size_t j = 0; j < out_feats; j++)
+                    {
+                        acc += g_row[j] * w_row[j];
+                    }
+                    d[i * in_feats + k] = acc;
                 }
             }
+        }
 
-            // Update biases
-            for (size_t j = 0; j < b.shape()[0]; j++)
+        size_t output_features(size_t in_feats) const override
+        {
+            if (in_feats != W.shape()[0])
             {
-                b(j) -= lr * db(j);
+                throw std::invalid_argument("Input features mismatch: expected " +
+                                            std::to_string(W.shape()[0]) +
+                                            ", got " + std::to_string(in_feats));
             }
+            return out_features();
+        }
+
+        bool borrows_input() const override { return true; }
+
+        void release_cache() override
+        {
+            last_x = utec::algebra::Tensor<T, 2>();
+            input_ref = nullptr;
+        }
+
+        // Updates the weights and biases using the learning rate
+        void update(T lr) override
+        {
+            UTEC_PROFILE_SCOPE(scope, "Dense", "update");
+            UTEC_PROFILE_FLOPS(scope, 2 * contar_parametros());
+            // One fused pass per tensor, no temporaries
+            W -= dW * lr;
+            b -= db * lr;
+            ++weights_version;
+        }
+
+        void apply_weight_decay(T lambda) override
+        {
+            W -= W * lambda;
+            b -= b * lambda;
+            ++weights_version;
+        }
+
+        // Parameters only: gradients and the packed copy are rebuilt
+        std::unique_ptr<ILayer<T>> clone() const override
+        {
+            utec::algebra::Tensor<T, 2> weights(W.shape()[0], out_features());
+            for (size_t k = 0; k < W.shape()[0]; ++k)
+                std::copy(W.data() + k * ld, W.data() + k * ld + out_features(), weights.data() + k * out_features());
+            return std::make_unique<Dense<T>>(W.shape()[0], out_features(), weights, b);
+        }
+
+        void prepare_inference() override
+        {
+            packed_weights();
         }
 
         size_t contar_parametros() const override
         {
-            return W.shape()[0] * W.shape()[1] + b.shape()[0];
+            return W.shape()[0] * out_features() + b.shape()[0];
         }
 
         std::vector<T> obtener_parametros() const override
@@ -152,7 +284,7 @@ namespace utec::neural_network
             // Añadir pesos
             for (size_t i = 0; i < W.shape()[0]; ++i)
             {
-                for (size_t j = 0; j < W.shape()[1]; ++j)
+                for (size_t j = 0; j < out_features(); ++j)
                 {
                     params.push_back(W(i, j));
                 }
@@ -173,7 +305,7 @@ namespace utec::neural_network
             // Actualizar pesos
             for (size_t i = 0; i < W.shape()[0]; ++i)
             {
-                for (size_t j = 0; j < W.shape()[1]; ++j)
+                for (size_t j = 0; j < out_features(); ++j)
                 {
                     W(i, j) = params[idx++];
                 }
@@ -184,35 +316,141 @@ namespace utec::neural_network
             {
                 b(i) = params[idx++];
             }
+            ++weights_version;
         }
 
     private:
-        // matrix multiplication
-        utec::algebra::Tensor<T, 2> matmul(const utec::algebra::Tensor<T, 2> &a,
-                                           const utec::algebra::Tensor<T, 2> &b) const
+        // Returns the packed weights, repacking first if W changed since the
+        // last pack. Double-checked: the common case is one atomic load.
+        const T *packed_weights()
         {
-            // Check for compatible dimensions for multiplication
-            if (a.shape()[1] != b.shape()[0])
+            if (packed_version.load(std::memory_order_acquire) != weights_version)
             {
-                throw std::invalid_argument("Matrix dimensions must agree for multiplication");
+                std::lock_guard<std::mutex> lock(pack_mutex);
+                if (packed_version.load(std::memory_order_relaxed) != weights_version)
+                {
+                    pack_weights();
+                    packed_version.store(weights_version, std::memory_order_release);
+                }
             }
+            return packed.data();
+        }
 
-            utec::algebra::Tensor<T, 2> result(a.shape()[0], b.shape()[1]);
-            for (size_t i = 0; i < a.shape()[0]; i++)
+        // packed[p][k][j] = W[k][p * panel + j]: each panel holds `panel`
+        // output columns for every input, contiguous in k, and the last one
+        // is zero padded. Panels are four cache lines wide, or one for
+        // layers narrower than that (the output head), so padding never
+        // costs more than a line of wasted work per input.
+        void pack_weights()
+        {
+            UTEC_PROFILE_SCOPE(scope, "Dense", "pack");
+            const size_t in_feats = W.shape()[0];
+            const size_t out_feats = out_features();
+            panel = out_feats >= wide_panel ? wide_panel : line;
+            const size_t panels = (out_feats + panel - 1) / panel;
+            packed.resize({panels * in_feats * panel});
+            packed.fill(0);
+            const T *w = W.data();
+            T *dst = packed.data();
+            for (size_t p = 0; p < panels; ++p)
             {
-                for (size_t k = 0; k < a.shape()[1]; k++)
+                const size_t j0 = p * panel;
+                const size_t width = std::min(panel, out_feats - j0);
+                for (size_t k = 0; k < in_feats; ++k)
                 {
-                    // Optimization: check if a(i,k) is zero to skip inner loop
-                    if (a(i, k) == static_cast<T>(0))
+                    std::copy(w + k * ld + j0, w + k * ld + j0 + width,
+                              dst + (p * in_feats + k) * panel);
+                }
+            }
+        }
+
+        // out = x * W + b, panel by panel. The fixed Width lets the compiler
+        // unroll and vectorize the inner axpy completely, and the local
+        // accumulator cannot alias the weights. Every row of the batch runs
+        // over a panel before moving on, so the panel stays in cache.
+        template <size_t Width>
+        void packed_gemm(const utec::algebra::Tensor<T, 2> &x, const T *panels,
+                         utec::algebra::Tensor<T, 2> &out) const
+        {
+            const size_t batch = x.shape()[0];
+            const size_t in_feats = W.shape()[0];
+            const size_t out_feats = out_features();
+            const T *bp = b.data();
+            for (size_t j0 = 0; j0 < out_feats; j0 += Width)
+            {
+                const size_t width = std::min(Width, out_feats - j0);
+                const T *w = panels + j0 * in_feats;
+                for (size_t i = 0; i < batch; ++i)
+                {
+                    const T *xr = x.data() + i * in_feats;
+                    T acc[Width] = {};
+                    std::copy(bp + j0, bp + j0 + width, acc);
+                    for (size_t k = 0; k < in_feats; ++k)
+                    {
+                        const T xv = xr[k];
+                        const T *wk = w + k * Width;
+                        for (size_t j = 0; j < Width; ++j)
+                            acc[j] += xv * wk[j];
+                    }
+                    std::copy(acc, acc + width, out.data() + i * out_feats + j0);
+                }
+            }
+        }
+
+        void check_input(const utec::algebra::Tensor<T, 2> &x) const
+        {
+            // Verify input dimensions match the weights
+            if (x.shape()[1] != W.shape()[0])
+            {
+                throw std::invalid_argument("Input features mismatch: expected " +
+                                            std::to_string(W.shape()[0]) +
+                                            ", got " + std::to_string(x.shape()[1]));
+            }
+        }
+
+        // grad must be [batch of the cached input, out_feats]
+        void check_grad(const utec::algebra::Tensor<T, 2> &grad, const utec::algebra::Tensor<T, 2> &x) const
+        {
+            if (grad.shape()[1] != out_features() || grad.shape()[0] != x.shape()[0])
+            {
+                throw std::invalid_argument("Gradient shape mismatch: expected [" +
+                                            std::to_string(x.shape()[0]) + ", " +
+                                            std::to_string(out_features()) + "], got [" +
+                                            std::to_string(grad.shape()[0]) + ", " +
+                                            std::to_string(grad.shape()[1]) + "]");
+            }
+        }
+
+        // out = x * W + b, written into out's existing storage
+        void affine_into(const utec::algebra::Tensor<T, 2> &x, utec::algebra::Tensor<T, 2> &out) const
+        {
+            const size_t batch = x.shape()[0];
+            const size_t in_feats = W.shape()[0];
+            const size_t out_feats = out_features();
+            out.resize({batch, out_feats});
+
+            const T *xp = x.data();
+            const T *w = W.data();
+            const T *bp = b.data();
+            T *o = out.data();
+            for (size_t i = 0; i < batch; i++)
+            {
+                T *o_row = o + i * out_feats;
+                std::copy(bp, bp + out_feats, o_row);
+                for (size_t k = 0; k < in_feats; k++)
+                {
+                    // Optimization: skip zero inputs (common after ReLU)
+                    T xv = xp[i * in_feats + k];
+                    if (xv == static_cast<T>(0))
                         continue;
 
-                    for (size_t j = 0; j < b.shape()[1]; j++)
+                    const T *w_row = w + k * ld;
+                    for (size_t j = 0; j < out_feats; j++)
                     {
-                        result(i, j) += a(i, k) * b(k, j);
+                        o_row[j] += xv * w_row[j];
                     }
                 }
             }
-            return result;
         }
     };
 
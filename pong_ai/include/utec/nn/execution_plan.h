@@ -0,0 +1,306 @@
+#ifndef UTEC_NN_EXECUTION_PLAN_H
+#define UTEC_NN_EXECUTION_PLAN_H
+
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include "layer.h"
+#include "dense.h"
+#include "activation.h"
+#include "sequential.h"
+#include "../algebra/Tensor.h"
+
+using namespace utec::algebra;
+
+namespace utec::neural_network
+{
+
+    enum class PlanMode
+    {
+        Inference, // activations ping-pong between buffers, nothing cached
+        Training   // inputs needed by backward stay alive until backward
+    };
+
+    // Precomputed schedule for running a stack of layers on a fixed batch size.
+    //
+    // Nested Sequential models are flattened, every activation gets a lifetime
+    // (producing step -> last consumer) and activations whose lifetimes do not
+    // overlap share the same buffer. Buffers are sized once at construction, so
+    // steady-state forward/backward calls do not allocate. Known layer types
+    // (Dense, ReLU) are called through their final type instead of the vtable.
+    //
+    // The plan keeps non-owning pointers to the layers. In training mode the
+    // tensor passed to forward() must stay alive until backward() returns.
+    template <typename T>
+    class ExecutionPlan
+    {
+    private:
+        enum class Kind
+        {
+            Dense,
+            ReLU,
+            Generic
+        };
+
+        struct Step
+        {
+            Kind kind;
+            ILayer<T> *layer;
+            size_t in_features;
+            size_t out_features;
+            size_t out_slot;
+            bool retain_input; // layer keeps a reference to its input until backward
+        };
+
+        std::vector<Step> steps;
+        std::vector<Tensor<T, 2>> slots;
+        std::vector<size_t> slot_elems; // planned capacity of each slot
+        Tensor<T, 2> grad_buffers[2];
+        size_t grad_elems = 0;
+        size_t in_features_;
+        size_t batch_size_;
+        PlanMode mode_;
+
+        static void flatten(ILayer<T> *layer, std::vector<ILayer<T> *> &out)
+        {
+            if (auto *seq = dynamic_cast<Sequential<T> *>(layer))
+            {
+                for (ILayer<T> *child : seq->layer_ptrs())
+                {
+                    flatten(child, out);
+                }
+                return;
+            }
+            out.push_back(layer);
+        }
+
+        void build(const std::vector<ILayer<T> *> &roots)
+        {
+            std::vector<ILayer<T> *> flat;
+            for (ILayer<T> *layer : roots)
+            {
+                flatten(layer, flat);
+            }
+
+            size_t features = in_features_;
+            size_t widest = in_features_;
+            for (ILayer<T> *layer : flat)
+            {
+                Step step;
+                step.layer = layer;
+                if (dynamic_cast<Dense<T> *>(layer))
+                    step.kind = Kind::Dense;
+                else if (dynamic_cast<ReLU<T> *>(layer))
+                    step.kind = Kind::ReLU;
+                else
+                    step.kind = Kind::Generic;
+                step.in_features = features;
+                step.out_features = layer->output_features(features);
+                step.retain_input = mode_ == PlanMode::Training && layer->borrows_input();
+                step.out_slot = 0;
+                features = step.out_features;
+                widest = std::max(widest, features);
+                steps.push_back(step);
+            }
+            assign_slots();
+
+            for (size_t s = 0; s < slots.size(); ++s)
+            {
+                slots[s].resize({1, slot_elems[s]});
+            }
+            if (mode_ == PlanMode::Training)
+            {
+                grad_elems = batch_size_ * widest;
+                grad_buffers[0].resize({1, grad_elems});
+                grad_buffers[1].resize({1, grad_elems});
+            }
+        }
+
+        // Greedy linear-scan assignment of activations to buffers
+        void assign_slots()
+        {
+            const size_t n = steps.size();
+            const size_t end_of_plan = std::numeric_limits<size_t>::max();
+
+            // last_use[i]: last step that reads the output of step i
+            std::vector<size_t> last_use(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (i + 1 == n || steps[i + 1].retain_input)
+                    last_use[i] = end_of_plan;
+                else
+                    last_use[i] = i + 1;
+            }
+
+            std::vector<size_t> busy_until; // per slot, last_use of its current occupant
+            for (size_t i = 0; i < n; ++i)
+            {
+                const size_t needed = batch_size_ * steps[i].out_features;
+                size_t chosen = slots.size();
+                for (size_t s = 0; s < busy_until.size(); ++s)
+                {
+                    if (busy_until[s] >= i)
+                        continue;
+                    // Prefer a free slot that is already large enough
+                    if (chosen == slots.size() ||
+                        (slot_elems[chosen] < needed && slot_elems[s] > slot_elems[chosen]))
+                    {
+                        chosen = s;
+                    }
+                }
+                if (chosen == slots.size())
+                {
+                    slots.emplace_back();
+                    slot_elems.push_back(0);
+                    busy_until.push_back(0);
+                }
+                slot_elems[chosen] = std::max(slot_elems[chosen], needed);
+                busy_until[chosen] = last_use[i];
+                steps[i].out_slot = chosen;
+            }
+        }
+
+        void run_forward(const Step &step, const Tensor<T, 2> &x, Tensor<T, 2> &out)
+        {
+            const bool training = mode_ == PlanMode::Training;
+            switch (step.kind)
+            {
+            case Kind::Dense:
+            {
+                auto *dense = static_cast<Dense<T> *>(step.layer);
+                if (training)
+                    dense->forward_into(x, out, step.retain_input);
+                else
+                    dense->infer_into(x, out);
+                break;
+            }
+            case Kind::ReLU:
+            {
+                auto *relu = static_cast<ReLU<T> *>(step.layer);
+                if (training)
+                    relu->forward_into(x, out);
+                else
+                    relu->infer_into(x, out);
+                break;
+            }
+            case Kind::Generic:
+                if (training)
+                    step.layer->forward_into(x, out, step.retain_input);
+                else
+                    step.layer->infer_into(x, out);
+                break;
+            }
+        }
+
+        void run_backward(const Step &step, const Tensor<T, 2> &grad, Tensor<T, 2> &dx)
+        {
+            switch (step.kind)
+            {
+            case Kind::Dense:
+                static_cast<Dense<T> *>(step.layer)->backward_into(grad, dx);
+                break;
+            case Kind::ReLU:
+                static_cast<ReLU<T> *>(step.layer)->backward_into(grad, dx);
+                break;
+            case Kind::Generic:
+                step.layer->backward_into(grad, dx);
+                break;
+            }
+        }
+
+    public:
+        ExecutionPlan(const std::vector<ILayer<T> *> &layers, size_t in_features,
+                      size_t batch_size, PlanMode mode = PlanMode::Inference)
+            : in_features_(in_features), batch_size_(batch_size), mode_(mode)
+        {
+            build(layers);
+        }
+
+        ExecutionPlan(ILayer<T> &model, size_t in_features, size_t batch_size,
+                      PlanMode mode = PlanMode::Inference)
+            : ExecutionPlan(std::vector<ILayer<T> *>{&model}, in_features, batch_size, mode)
+        {
+        }
+
+        // Runs the planned forward pass. The result lives in a plan buffer and
+        // is overwritten by the next call. Batches up to the planned size reuse
+        // the plan buffers; larger batches are rejected instead of regrowing them.
+        const Tensor<T, 2> &forward(const Tensor<T, 2> &x)
+        {
+            if (x.shape()[1] != in_features_)
+            {
+                throw std::invalid_argument("Input features mismatch: expected " +
+                                            std::to_string(in_features_) +
+                                            ", got " + std::to_string(x.shape()[1]));
+            }
+            if (x.shape()[0] > batch_size_)
+            {
+                throw std::invalid_argument("Batch size exceeds plan: planned " +
+                                            std::to_string(batch_size_) +
+                                            ", got " + std::to_string(x.shape()[0]));
+            }
+            const Tensor<T, 2> *current = &x;
+            for (const Step &step : steps)
+            {
+                Tensor<T, 2> &out = slots[step.out_slot];
+                run_forward(step, *current, out);
+                current = &out;
+            }
+            return *current;
+        }
+
+        // Backpropagates grad through the planned layers and returns the
+        // gradient with respect to the input of the last forward() call.
+        const Tensor<T, 2> &backward(const Tensor<T, 2> &grad)
+        {
+            if (mode_ != PlanMode::Training)
+            {
+                throw std::logic_error("backward requires a plan compiled in training mode");
+            }
+            const Tensor<T, 2> *current = &grad;
+            size_t k = 0;
+            for (auto it = steps.rbegin(); it != steps.rend(); ++it, ++k)
+            {
+                Tensor<T, 2> &dx = grad_buffers[k % 2];
+                run_backward(*it, *current, dx);
+                current = &dx;
+            }
+            return *current;
+        }
+
+        void update(T lr)
+        {
+            for (const Step &step : steps)
+            {
+                if (step.kind == Kind::Dense)
+                    static_cast<Dense<T> *>(step.layer)->update(lr);
+                else if (step.kind == Kind::Generic)
+                    step.layer->update(lr);
+            }
+        }
+
+        PlanMode mode() const noexcept { return mode_; }
+        size_t batch_size() const noexcept { return batch_size_; }
+        size_t step_count() const noexcept { return steps.size(); }
+        size_t buffer_count() const noexcept { return slots.size(); }
+
+        size_t output_features() const noexcept
+        {
+            return steps.empty() ? in_features_ : steps.back().out_features;
+        }
+
+        // Bytes reserved for activations and gradients by this plan
+        size_t planned_bytes() const noexcept
+        {
+            size_t elems = 2 * grad_elems;
+            for (size_t e : slot_elems)
+            {
+                elems += e;
+            }
+            return elems * sizeof(T);
+        }
+    };
+
+} // namespace utec::neural_network
+
+#endif // UTEC_NN_EXECUTION_PLAN_H
@@ -2,6 +2,8 @@
 #define UTEC_NN_LAYER_H
 
 #include "../algebra/Tensor.h"
+#include <memory>
+#include <vector>
 
 using namespace utec::algebra;
 
@@ -21,6 +23,63 @@ namespace utec::neural_network
         virtual size_t contar_parametros() const = 0;
         virtual std::vector<T> obtener_parametros() const = 0;
         virtual void establecer_parametros(const std::vector<T> &) = 0;
+
+        // L2 regularization as weight decay: param -= lambda * param for
+        // every parameter. Layers with tensors override it to skip the copy.
+        virtual void apply_weight_decay(T lambda)
+        {
+            auto params = obtener_parametros();
+            if (params.empty())
+                return;
+            for (auto &param : params)
+            {
+                param -= lambda * param;
+            }
+            establecer_parametros(params);
+        }
+
+        // Hooks used by ExecutionPlan. The defaults fall back to forward/backward,
+        // so layers only override them to avoid the per-call allocations.
+
+        // Number of output features produced for an input with in_feats columns
+        virtual size_t output_features(size_t in_feats) const { return in_feats; }
+
+        // forward() writing into a caller-owned buffer. When input_is_retained is
+        // true the caller guarantees x stays alive and unchanged until the next
+        // backward call, so the layer may keep a reference instead of a copy.
+        virtual void forward_into(const Tensor<T, 2> &x, Tensor<T, 2> &out,
+                                  bool input_is_retained = false)
+        {
+            (void)input_is_retained;
+            out = forward(x);
+        }
+
+        // Forward pass without caching anything for backward
+        virtual void infer_into(const Tensor<T, 2> &x, Tensor<T, 2> &out)
+        {
+            forward_into(x, out);
+        }
+
+        virtual void backward_into(const Tensor<T, 2> &grad, Tensor<T, 2> &dx)
+        {
+            dx = backward(grad);
+        }
+
+        // Whether forward_into keeps a reference to a retained input
+        virtual bool borrows_input() const { return false; }
+
+        // Drops the activations cached for backward (gradient checkpointing)
+        virtual void release_cache() {}
+
+        // Independent copy with the same structure and parameters; gradients
+        // and caches start empty. Layers that cannot be copied return nullptr
+        // (PongAgent then updates their parameters in place).
+        virtual std::unique_ptr<ILayer<T>> clone() const { return nullptr; }
+
+        // Builds whatever infer_into derives from the parameters (packed
+        // weights) now, so the first inference after an update does not pay
+        // for repacking the weights.
+        virtual void prepare_inference() {}
     };
 
 } // namespace utec::neural_network
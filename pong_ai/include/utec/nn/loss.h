@@ -2,6 +2,13 @@
 #define UTEC_NN_LOSS_H
 
 #include "../algebra/Tensor.h"
+#include "../algebra/Reduce.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 using namespace utec::algebra;
 
@@ -22,18 +29,11 @@ namespace utec::neural_network
             last_pred = pred;
             last_target = target;
 
-            T loss = 0;
             size_t batch_size = pred.shape()[0];
             size_t features = pred.shape()[1];
 
-            for (size_t i = 0; i < batch_size; i++)
-            {
-                for (size_t j = 0; j < features; j++)
-                {
-                    T diff = pred(i, j) - target(i, j);
-                    loss += diff * diff;
-                }
-            }
+            // Fused (pred - target)^2 summed pairwise, without a temporary
+            T loss = utec::algebra::sum((pred - target) * (pred - target));
             return loss / (batch_size * features);
         }
 
@@ -41,18 +41,114 @@ namespace utec::neural_network
         {
             size_t batch_size = last_pred.shape()[0];
             size_t features = last_pred.shape()[1];
-            Tensor<T, 2> grad(batch_size, features);
             T scale = static_cast<T>(2) / (batch_size * features);
+            return (last_pred - last_target) * scale;
+        }
+    };
+
+    // Softmax + cross-entropy over raw logits with integer class labels.
+    //
+    // Loss, gradient and (optionally) accuracy are produced in one pass over
+    // the logits: each row is shifted by its max for numerical stability, the
+    // softmax is written straight into the gradient buffer and the label
+    // column is corrected in place. No one-hot targets are materialized and
+    // the prediction is not copied.
+    template <typename T>
+    class SoftmaxCrossEntropyLoss
+    {
+    private:
+        Tensor<T, 2> grad;
+        size_t last_correct = 0;
+        bool track_accuracy;
+
+    public:
+        explicit SoftmaxCrossEntropyLoss(bool compute_accuracy = true)
+            : track_accuracy(compute_accuracy) {}
+
+        // Mean loss over the batch. labels[i] is the class index of row i.
+        template <typename Label>
+        T forward(const Tensor<T, 2> &logits, const std::vector<Label> &labels)
+        {
+            static_assert(std::is_integral_v<Label>, "labels must be integer class ids");
+            const size_t batch = logits.shape()[0];
+            const size_t classes = logits.shape()[1];
+            if (labels.size() != batch)
+            {
+                throw std::invalid_argument("Expected " + std::to_string(batch) +
+                                            " labels, got " + std::to_string(labels.size()));
+            }
+
+            grad.resize(logits.shape());
+            const T *z = logits.data();
+            T *g = grad.data();
+            const T inv_batch = static_cast<T>(1) / static_cast<T>(batch);
+            T loss = 0;
+            size_t correct = 0;
 
-            for (size_t i = 0; i < batch_size; i++)
+            for (size_t i = 0; i < batch; i++)
             {
-                for (size_t j = 0; j < features; j++)
+                const T *z_row = z + i * classes;
+                T *g_row = g + i * classes;
+                const size_t label = static_cast<size_t>(labels[i]);
+                if (label >= classes)
                 {
-                    grad(i, j) = scale * (last_pred(i, j) - last_target(i, j));
+                    throw std::out_of_range("Label " + std::to_string(labels[i]) +
+                                            " out of range for " + std::to_string(classes) +
+                                            " classes");
                 }
+
+                // The row max doubles as the argmax for accuracy
+                size_t arg = 0;
+                T max_val = z_row[0];
+                for (size_t j = 1; j < classes; j++)
+                {
+                    if (z_row[j] > max_val)
+                    {
+                        max_val = z_row[j];
+                        arg = j;
+                    }
+                }
+                correct += (arg == label);
+
+                T sum = 0;
+                for (size_t j = 0; j < classes; j++)
+                {
+                    T e = std::exp(z_row[j] - max_val);
+                    g_row[j] = e;
+                    sum += e;
+                }
+
+                // -log softmax(z)[label] = log(sum) - (z[label] - max)
+                loss += std::log(sum) - (z_row[label] - max_val);
+
+                const T scale = inv_batch / sum;
+                for (size_t j = 0; j < classes; j++)
+                {
+                    g_row[j] *= scale;
+                }
+                g_row[label] -= inv_batch;
             }
+
+            last_correct = track_accuracy ? correct : 0;
+            return loss * inv_batch;
+        }
+
+        // Gradient of the mean loss with respect to the logits
+        const Tensor<T, 2> &backward() const
+        {
             return grad;
         }
+
+        // Percentage of rows whose argmax matched the label in the last forward
+        T accuracy() const
+        {
+            if (!track_accuracy)
+            {
+                throw std::logic_error("Accuracy tracking is disabled for this loss");
+            }
+            const size_t batch = grad.shape()[0];
+            return batch == 0 ? 0 : static_cast<T>(last_correct) * 100 / static_cast<T>(batch);
+        }
     };
 
 } // namespace utec::neural_network
@@ -0,0 +1,127 @@
+#ifndef UTEC_NN_METRICS_H
+#define UTEC_NN_METRICS_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include "../algebra/Tensor.h"
+#include "../algebra/Reduce.h"
+
+using namespace utec::algebra;
+
+namespace utec::neural_network
+{
+
+    // Accuracy and confusion matrix for a classifier, computed from the raw
+    // network output in one pass (row argmax + histogram update).
+    class ClassificationMetrics
+    {
+    private:
+        size_t num_classes;
+        std::vector<size_t> confusion; // [true_class * num_classes + predicted]
+        size_t samples = 0;
+        size_t correct = 0;
+
+    public:
+        explicit ClassificationMetrics(size_t classes)
+            : num_classes(classes), confusion(classes * classes, 0) {}
+
+        void reset()
+        {
+            std::fill(confusion.begin(), confusion.end(), 0);
+            samples = 0;
+            correct = 0;
+        }
+
+        template <typename T, typename Label>
+        void update(const Tensor<T, 2> &output, const std::vector<Label> &labels)
+        {
+            static_assert(std::is_integral_v<Label>, "labels must be integer class ids");
+            const size_t batch = output.shape()[0];
+            const size_t classes = output.shape()[1];
+            if (classes != num_classes || labels.size() != batch)
+            {
+                throw std::invalid_argument("Metrics expect [" + std::to_string(labels.size()) +
+                                            ", " + std::to_string(num_classes) +
+                                            "] outputs, got [" + std::to_string(batch) + ", " +
+                                            std::to_string(classes) + "]");
+            }
+
+            // Validated up front so a bad label leaves the counts untouched
+            for (size_t i = 0; i < batch; i++)
+            {
+                if (static_cast<size_t>(labels[i]) >= num_classes)
+                {
+                    throw std::out_of_range("Label out of range: " + std::to_string(labels[i]));
+                }
+            }
+
+            const T *o = output.data();
+            size_t *cm = confusion.data();
+            size_t hits = 0;
+            for (size_t i = 0; i < batch; i++)
+            {
+                const size_t arg = utec::algebra::argmax(o + i * classes, classes);
+                const size_t truth = static_cast<size_t>(labels[i]);
+                cm[truth * num_classes + arg]++;
+                hits += (truth == arg);
+            }
+            samples += batch;
+            correct += hits;
+        }
+
+        size_t classes() const { return num_classes; }
+        size_t total() const { return samples; }
+
+        size_t count(size_t true_class, size_t predicted) const
+        {
+            return confusion.at(true_class * num_classes + predicted);
+        }
+
+        // Percentage of correctly classified samples
+        double accuracy() const
+        {
+            return samples == 0 ? 0.0 : 100.0 * static_cast<double>(correct) / samples;
+        }
+
+        // Percentage of samples of class c that were predicted as c
+        double recall(size_t c) const
+        {
+            size_t row = 0;
+            for (size_t p = 0; p < num_classes; ++p)
+                row += count(c, p);
+            return row == 0 ? 0.0 : 100.0 * count(c, c) / row;
+        }
+
+        // Percentage of predictions of class c that were correct
+        double precision(size_t c) const
+        {
+            size_t col = 0;
+            for (size_t t = 0; t < num_classes; ++t)
+                col += count(t, c);
+            return col == 0 ? 0.0 : 100.0 * count(c, c) / col;
+        }
+
+        void print_confusion(std::ostream &os, const std::vector<std::string> &names = {}) const
+        {
+            auto name = [&](size_t c)
+            { return c < names.size() ? names[c] : std::to_string(c); };
+            os << "true\\pred";
+            for (size_t p = 0; p < num_classes; ++p)
+                os << "\t" << name(p);
+            os << "\n";
+            for (size_t t = 0; t < num_classes; ++t)
+            {
+                os << name(t);
+                for (size_t p = 0; p < num_classes; ++p)
+                    os << "\t" << count(t, p);
+                os << "\n";
+            }
+        }
+    };
+
+} // namespace utec::neural_network
+
+#endif // UTEC_NN_METRICS_H
@@ -7,6 +7,7 @@
 #include "layer.h"
 #include "loss.h"
 #include "sequential.h" // Incluir Sequential
+#include "execution_plan.h"
 #include "../algebra/Tensor.h"
 
 using namespace utec::algebra;
@@ -37,6 +38,7 @@ namespace utec::neural_network
         Tensor<T, 2> forward(const Tensor<T, 2> &x)
         {
             validate_architecture();
+            UTEC_PROFILE_SCOPE(scope, "NeuralNetwork", "forward");
             Tensor<T, 2> output = x;
             for (auto &layer : layers)
             {
@@ -48,6 +50,7 @@ namespace utec::neural_network
         void backward(const Tensor<T, 2> &grad)
         {
             validate_architecture();
+            UTEC_PROFILE_SCOPE(scope, "NeuralNetwork", "backward");
             Tensor<T, 2> current_grad = grad;
             for (auto it = layers.rbegin(); it != layers.rend(); ++it)
             {
@@ -57,12 +60,21 @@ namespace utec::neural_network
 
         void optimizer(T lr)
         {
+            UTEC_PROFILE_SCOPE(scope, "NeuralNetwork", "optimizer");
             for (auto &layer : layers)
             {
                 layer->update(lr);
             }
         }
 
+        void apply_weight_decay(T lambda)
+        {
+            for (auto &layer : layers)
+            {
+                layer->apply_weight_decay(lambda);
+            }
+        }
+
         T train(const Tensor<T, 2> &X, const Tensor<T, 2> &Y, size_t epochs, T lr)
         {
             validate_architecture();
@@ -84,6 +96,20 @@ namespace utec::neural_network
             return final_loss;
         }
 
+        // Builds a reusable execution plan over the current layers. The plan keeps
+        // non-owning pointers, so it must not outlive this network.
+        ExecutionPlan<T> compile(size_t in_features, size_t batch_size,
+                                 PlanMode mode = PlanMode::Inference) const
+        {
+            validate_architecture();
+            std::vector<ILayer<T> *> ptrs;
+            for (const auto &layer : layers)
+            {
+                ptrs.push_back(layer.get());
+            }
+            return ExecutionPlan<T>(ptrs, in_features, batch_size, mode);
+        }
+
         // Nuevos métodos para manejo de parámetros
         size_t contar_parametros() const
         {
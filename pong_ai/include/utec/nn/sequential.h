@@ -3,6 +3,10 @@
 #define UTEC_NN_SEQUENTIAL_H
 
 #include "layer.h"
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
 
 using namespace utec::algebra;
 
@@ -15,14 +19,96 @@ namespace utec::neural_network
     private:
         std::vector<std::unique_ptr<ILayer<T>>> layers;
 
+        // Gradient checkpointing state
+        size_t segment_length = 0;            // layers per segment, 0 = disabled
+        std::vector<Tensor<T, 2>> boundaries; // input of each segment
+        Tensor<T, 2> scratch[2];              // ping-pong buffers for the interior
+
+        size_t segment_count() const
+        {
+            return (layers.size() + segment_length - 1) / segment_length;
+        }
+
+        Tensor<T, 2> checkpointed_forward(const Tensor<T, 2> &x)
+        {
+            boundaries.resize(segment_count());
+            const Tensor<T, 2> *current = &x;
+            size_t k = 0;
+            for (size_t s = 0; s < boundaries.size(); ++s)
+            {
+                boundaries[s] = *current;
+                current = &boundaries[s];
+                size_t last = std::min(layers.size(), (s + 1) * segment_length);
+                for (size_t l = s * segment_length; l < last; ++l, ++k)
+                {
+                    // Interior activations are not kept: nothing is cached here
+                    layers[l]->infer_into(*current, scratch[k % 2]);
+                    current = &scratch[k % 2];
+                }
+            }
+            return *current;
+        }
+
+        Tensor<T, 2> checkpointed_backward(const Tensor<T, 2> &grad)
+        {
+            if (boundaries.size() != segment_count())
+            {
+                throw std::logic_error("backward called without a checkpointed forward pass");
+            }
+            Tensor<T, 2> current_grad = grad;
+            for (size_t s = boundaries.size(); s-- > 0;)
+            {
+                size_t first = s * segment_length;
+                size_t last = std::min(layers.size(), first + segment_length);
+
+                // Recompute the segment from its boundary, caching for backward
+                const Tensor<T, 2> *current = &boundaries[s];
+                for (size_t l = first, k = 0; l < last; ++l, ++k)
+                {
+                    layers[l]->forward_into(*current, scratch[k % 2]);
+                    current = &scratch[k % 2];
+                }
+                for (size_t l = last; l-- > first;)
+                {
+                    current_grad = layers[l]->backward(current_grad);
+                }
+                // Only one segment holds activations at a time
+                for (size_t l = first; l < last; ++l)
+                {
+                    layers[l]->release_cache();
+                }
+            }
+            return current_grad;
+        }
+
     public:
         void add_layer(std::unique_ptr<ILayer<T>> layer)
         {
             layers.push_back(std::move(layer));
         }
 
+        // Gradient checkpointing: forward keeps only the input of every segment of
+        // `length` layers and backward recomputes each segment before
+        // backpropagating through it. Training memory then grows with the number
+        // of segments plus one segment instead of with the depth. 0 disables it;
+        // a length around sqrt(depth) is the usual memory/compute trade-off.
+        void set_checkpointing(size_t length)
+        {
+            segment_length = length;
+            boundaries.clear();
+        }
+
+        size_t checkpoint_segment_length() const
+        {
+            return segment_length;
+        }
+
         Tensor<T, 2> forward(const Tensor<T, 2> &x) override
         {
+            if (segment_length > 0 && !layers.empty())
+            {
+                return checkpointed_forward(x);
+            }
             Tensor<T, 2> output = x;
             for (auto &layer : layers)
             {
@@ -33,6 +119,10 @@ namespace utec::neural_network
 
         Tensor<T, 2> backward(const Tensor<T, 2> &grad) override
         {
+            if (segment_length > 0 && !layers.empty())
+            {
+                return checkpointed_backward(grad);
+            }
             Tensor<T, 2> current_grad = grad;
             for (auto it = layers.rbegin(); it != layers.rend(); ++it)
             {
@@ -41,6 +131,45 @@ namespace utec::neural_network
             return current_grad;
         }
 
+        void infer_into(const Tensor<T, 2> &x, Tensor<T, 2> &out) override
+        {
+            if (layers.empty())
+            {
+                out = x;
+                return;
+            }
+            // Alternate between out and a local buffer so the last layer lands in out
+            Tensor<T, 2> tmp;
+            const Tensor<T, 2> *current = &x;
+            for (size_t i = 0; i < layers.size(); ++i)
+            {
+                Tensor<T, 2> &dst = ((layers.size() - 1 - i) % 2 == 0) ? out : tmp;
+                layers[i]->infer_into(*current, dst);
+                current = &dst;
+            }
+        }
+
+        size_t output_features(size_t in_feats) const override
+        {
+            for (const auto &layer : layers)
+            {
+                in_feats = layer->output_features(in_feats);
+            }
+            return in_feats;
+        }
+
+        // Non-owning view of the layers, in forward order (used by ExecutionPlan)
+        std::vector<ILayer<T> *> layer_ptrs() const
+        {
+            std::vector<ILayer<T> *> ptrs;
+            ptrs.reserve(layers.size());
+            for (const auto &layer : layers)
+            {
+                ptrs.push_back(layer.get());
+            }
+            return ptrs;
+        }
+
         void update(T lr) override
         {
             for (auto &layer : layers)
@@ -49,6 +178,37 @@ namespace utec::neural_network
             }
         }
 
+        void apply_weight_decay(T lambda) override
+        {
+            for (auto &layer : layers)
+            {
+                layer->apply_weight_decay(lambda);
+            }
+        }
+
+        // Deep copy, or nullptr if any layer cannot be cloned
+        std::unique_ptr<ILayer<T>> clone() const override
+        {
+            auto copy = std::make_unique<Sequential<T>>();
+            for (const auto &layer : layers)
+            {
+                auto layer_copy = layer->clone();
+                if (!layer_copy)
+                    return nullptr;
+                copy->add_layer(std::move(layer_copy));
+            }
+            copy->set_checkpointing(segment_length);
+            return copy;
+        }
+
+        void prepare_inference() override
+        {
+            for (auto &layer : layers)
+            {
+                layer->prepare_inference();
+            }
+        }
+
         // Nuevas implementaciones requeridas
         size_t contar_parametros() const override
         {
@@ -0,0 +1,228 @@
+#ifndef UTEC_NN_TRAINER_H
+#define UTEC_NN_TRAINER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "neural_network.h"
+#include "dense.h"
+#include "activation.h"
+#include "loss.h"
+#include "metrics.h"
+#include "sequential.h"
+#include "../algebra/Tensor.h"
+
+using namespace utec::algebra;
+
+namespace utec::neural_network
+{
+
+    // Hyperparameters of one training run (the defaults are the values
+    // train.cpp has always used).
+    struct TrainConfig
+    {
+        std::vector<size_t> hidden = {64, 32}; // Hidden layer widths
+        float learning_rate = 0.01f;
+        float l2_lambda = 0.001f;
+        float prune_ratio = 0.1f;
+        size_t epochs = 1000;
+
+        // e.g. "64x32 lr=0.01 l2=0.001 prune=0.1"
+        std::string describe() const
+        {
+            std::ostringstream os;
+            os << hidden_string() << " lr=" << learning_rate << " l2=" << l2_lambda
+               << " prune=" << prune_ratio;
+            return os.str();
+        }
+
+        std::string hidden_string() const
+        {
+            std::string s;
+            for (size_t i = 0; i < hidden.size(); ++i)
+                s += (i ? "x" : "") + std::to_string(hidden[i]);
+            return s.empty() ? "linear" : s;
+        }
+    };
+
+    // Dense/ReLU stack: in -> hidden... -> out (logits). With the default
+    // config this is the 3-64-32-3 policy train.cpp saves, so its parameter
+    // files load into build_model<float>(TrainConfig{}, 3, 3). Weights come
+    // from rng when given (identical in every process), otherwise from the
+    // per-layer streams of the global seed.
+    template <typename T>
+    std::unique_ptr<Sequential<T>> build_model(const TrainConfig &config, size_t in_features,
+                                               size_t out_features, utec::random::Philox *rng = nullptr)
+    {
+        auto dense = [rng](size_t in, size_t out)
+        {
+            return rng ? std::make_unique<Dense<T>>(in, out, *rng) : std::make_unique<Dense<T>>(in, out);
+        };
+        auto model = std::make_unique<Sequential<T>>();
+        size_t in = in_features;
+        for (size_t width : config.hidden)
+        {
+            if (width == 0)
+            {
+                throw std::invalid_argument("Hidden layer width must be positive");
+            }
+            model->add_layer(dense(in, width));
+            model->add_layer(std::make_unique<ReLU<T>>());
+            in = width;
+        }
+        model->add_layer(dense(in, out_features));
+        return model;
+    }
+
+    template <typename T>
+    NeuralNetwork<T> build_network(const TrainConfig &config, size_t in_features, size_t out_features)
+    {
+        NeuralNetwork<T> net;
+        net.add_layer(build_model<T>(config, in_features, out_features));
+        return net;
+    }
+
+    // L2 regularization applied as weight decay after each update
+    template <typename T>
+    void apply_l2_regularization(NeuralNetwork<T> &net, T lambda)
+    {
+        net.apply_weight_decay(lambda);
+    }
+
+    // Magnitude-based pruning
+    template <typename T>
+    void prune_network(NeuralNetwork<T> &net, T prune_ratio)
+    {
+        auto params = net.obtener_parametros();
+        if (params.empty() || prune_ratio <= 0)
+            return;
+
+        // Calculate threshold based on magnitude
+        std::vector<T> abs_params;
+        abs_params.reserve(params.size());
+        for (auto p : params)
+            abs_params.push_back(std::abs(p));
+        std::sort(abs_params.begin(), abs_params.end());
+        size_t cut = std::min(static_cast<size_t>(prune_ratio * abs_params.size()), abs_params.size() - 1);
+        T threshold = abs_params[cut];
+
+        // Prune parameters below threshold
+        for (auto &p : params)
+        {
+            if (std::abs(p) < threshold)
+                p = 0;
+        }
+
+        net.establecer_parametros(params);
+    }
+
+    // Class id of the correct action for a Pong sample: 0 = down, 1 = stay, 2 = up
+    inline int8_t label_for(float ball_y, float paddle_y)
+    {
+        float diff = ball_y - paddle_y;
+        if (diff > 0.1f)
+            return 0; // down
+        if (diff < -0.1f)
+            return 2; // up
+        return 1;     // stay
+    }
+
+    // Labels never change, so they are derived once at load time.
+    // Columns of X: ball_x, ball_y, paddle_y
+    template <typename T>
+    std::vector<int8_t> derive_labels(const Tensor<T, 2> &X)
+    {
+        std::vector<int8_t> labels(X.shape()[0]);
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            labels[i] = label_for(X(i, 1), X(i, 2));
+        }
+        return labels;
+    }
+
+    // Full-batch classifier training with softmax cross-entropy, L2 decay and
+    // final pruning. Epochs can be run incrementally (step/run), which is what
+    // lets a sweep pause a trial, compare it with others and resume it.
+    //
+    // The dataset is borrowed, not copied: X and labels must outlive the
+    // trainer, and many trainers may share them read-only across threads.
+    template <typename T, typename Label = int8_t>
+    class Trainer
+    {
+    private:
+        TrainConfig config_;
+        const Tensor<T, 2> &X_;
+        const std::vector<Label> &labels_;
+        NeuralNetwork<T> net_;
+        SoftmaxCrossEntropyLoss<T> criterion_;
+        Tensor<T, 2> output_;
+        T last_loss_ = 0;
+        size_t epochs_done_ = 0;
+        size_t num_classes_;
+
+    public:
+        Trainer(const TrainConfig &config, const Tensor<T, 2> &X,
+                const std::vector<Label> &labels, size_t num_classes = 3)
+            : config_(config), X_(X), labels_(labels),
+              net_(build_network<T>(config, X.shape()[1], num_classes)),
+              criterion_(false), num_classes_(num_classes)
+        {
+            if (labels.size() != X.shape()[0])
+            {
+                throw std::invalid_argument("Trainer needs one label per sample");
+            }
+        }
+
+        // One epoch over the whole dataset; returns its loss
+        T step()
+        {
+            output_ = net_.forward(X_);
+            last_loss_ = criterion_.forward(output_, labels_);
+            net_.backward(criterion_.backward());
+            net_.optimizer(static_cast<T>(config_.learning_rate));
+            apply_l2_regularization(net_, static_cast<T>(config_.l2_lambda));
+            ++epochs_done_;
+            return last_loss_;
+        }
+
+        // Runs `epochs` more epochs; returns the last loss
+        T run(size_t epochs)
+        {
+            for (size_t e = 0; e < epochs; ++e)
+                step();
+            return last_loss_;
+        }
+
+        // Fresh forward pass with the current weights, accumulated into metrics
+        void evaluate(ClassificationMetrics &metrics)
+        {
+            metrics.reset();
+            metrics.update(net_.forward(X_), labels_);
+        }
+
+        double evaluate()
+        {
+            ClassificationMetrics metrics(num_classes_);
+            evaluate(metrics);
+            return metrics.accuracy();
+        }
+
+        void prune() { prune_network(net_, static_cast<T>(config_.prune_ratio)); }
+
+        const TrainConfig &config() const { return config_; }
+        size_t epochs_done() const { return epochs_done_; }
+        T last_loss() const { return last_loss_; }
+        // Network output of the last step() (before that step's update)
+        const Tensor<T, 2> &last_output() const { return output_; }
+        const std::vector<Label> &labels() const { return labels_; }
+        NeuralNetwork<T> &network() { return net_; }
+    };
+
+} // namespace utec::neural_network
+
+#endif // UTEC_NN_TRAINER_H
@@ -0,0 +1,310 @@
+#ifndef UTEC_PARALLEL_AFFINITY_H
+#define UTEC_PARALLEL_AFFINITY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define UTEC_HAS_AFFINITY 1
+#endif
+
+namespace utec::parallel
+{
+
+    // Cache line size assumed throughout (x86-64 and most AArch64 cores).
+    // Data written by different threads is aligned to it to avoid false sharing.
+    constexpr size_t cache_line = 64;
+
+    // One logical CPU as seen by the OS
+    struct CpuInfo
+    {
+        int cpu = 0;     // Logical CPU id (what sched_setaffinity takes)
+        int core = 0;    // Physical core id within the package
+        int package = 0; // Socket
+        int node = 0;    // NUMA node
+    };
+
+    // Logical CPUs this process may run on, with their core/socket/NUMA
+    // placement. On Linux it is read from sysfs and restricted to the current
+    // affinity mask (so cgroup/taskset limits are respected); elsewhere it
+    // falls back to hardware_concurrency() CPUs on a single node.
+    class Topology
+    {
+    public:
+        Topology() = default;
+        explicit Topology(std::vector<CpuInfo> cpus) : cpus_(std::move(cpus))
+        {
+            std::sort(cpus_.begin(), cpus_.end(), [](const CpuInfo &a, const CpuInfo &b)
+                      { return a.cpu < b.cpu; });
+        }
+
+        static Topology detect()
+        {
+            std::vector<CpuInfo> cpus;
+#ifdef UTEC_HAS_AFFINITY
+            std::vector<int> ids = parse_cpu_list(read_line("/sys/devices/system/cpu/online"));
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+            std::map<int, int> node_of;
+            for (int node : parse_cpu_list(read_line("/sys/devices/system/node/online")))
+            {
+                std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+                for (int cpu : parse_cpu_list(read_line(path)))
+                    node_of[cpu] = node;
+            }
+
+            for (int id : ids)
+            {
+                // cpu_set_t only covers CPU_SETSIZE ids; the pinning helpers cannot target the rest
+                if (id < 0 || id >= CPU_SETSIZE)
+                    continue;
+                if (have_mask && !CPU_ISSET(id, &allowed))
+                    continue;
+                std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+                CpuInfo info;
+                info.cpu = id;
+                info.core = read_int(base + "core_id", id);
+                info.package = read_int(base + "physical_package_id", 0);
+                auto it = node_of.find(id);
+                info.node = it == node_of.end() ? 0 : it->second;
+                cpus.push_back(info);
+            }
+#endif
+            if (cpus.empty())
+            {
+                unsigned n = std::max(1u, std::thread::hardware_concurrency());
+                for (unsigned i = 0; i < n; ++i)
+                    cpus.push_back({static_cast<int>(i), static_cast<int>(i), 0, 0});
+            }
+            return Topology(std::move(cpus));
+        }
+
+        const std::vector<CpuInfo> &cpus() const { return cpus_; }
+        size_t size() const { return cpus_.size(); }
+
+        size_t num_nodes() const
+        {
+            int max_node = -1;
+            for (const auto &c : cpus_)
+                max_node = std::max(max_node, c.node);
+            return static_cast<size_t>(max_node + 1);
+        }
+
+        // NUMA node of a logical CPU, -1 if unknown
+        int node_of(int cpu) const
+        {
+            for (const auto &c : cpus_)
+                if (c.cpu == cpu)
+                    return c.node;
+            return -1;
+        }
+
+        // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+        static std::vector<int> parse_cpu_list(const std::string &text)
+        {
+            std::vector<int> ids;
+            std::stringstream ss(text);
+            std::string range;
+            while (std::getline(ss, range, ','))
+            {
+                if (range.empty() || range == "\n")
+                    continue;
+                size_t dash = range.find('-');
+                try
+                {
+                    int lo = std::stoi(range.substr(0, dash));
+                    int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+                    for (int i = lo; i <= hi; ++i)
+                        ids.push_back(i);
+                }
+                catch (...)
+                {
+                    // Malformed entry: ignore it
+                }
+            }
+            return ids;
+        }
+
+    private:
+        static std::string read_line(const std::string &path)
+        {
+            std::ifstream in(path);
+            std::string line;
+            std::getline(in, line);
+            return line;
+        }
+
+        static int read_int(const std::string &path, int fallback)
+        {
+            std::ifstream in(path);
+            int value;
+            return (in >> value) ? value : fallback;
+        }
+
+        std::vector<CpuInfo> cpus_;
+    };
+
+    enum class PinPolicy
+    {
+        None,    // Let the OS schedule workers (default)
+        Compact, // Fill one node, then one core (and its SMT siblings), before the next
+        Scatter, // Spread workers round-robin over nodes, then over distinct cores
+        Explicit // Use AffinityOptions::cpus in order
+    };
+
+    struct AffinityOptions
+    {
+        PinPolicy policy = PinPolicy::None;
+        std::vector<int> cpus; // Explicit policy only; worker i -> cpus[i % size]
+    };
+
+    // Logical CPU for each of `workers` threads (-1 = not pinned). With more
+    // workers than CPUs the placement wraps around.
+    inline std::vector<int> plan_placement(const Topology &topo, const AffinityOptions &options, size_t workers)
+    {
+        std::vector<int> plan(workers, -1);
+        if (options.policy == PinPolicy::None || topo.size() == 0)
+            return plan;
+
+        std::vector<int> order;
+        if (options.policy == PinPolicy::Explicit)
+        {
+            if (options.cpus.empty())
+            {
+                throw std::invalid_argument("Explicit pinning needs a CPU list");
+            }
+            order = options.cpus;
+        }
+        else
+        {
+            std::vector<CpuInfo> cpus = topo.cpus();
+            std::sort(cpus.begin(), cpus.end(), [](const CpuInfo &a, const CpuInfo &b)
+                      {
+                if (a.node != b.node) return a.node < b.node;
+                if (a.package != b.package) return a.package < b.package;
+                if (a.core != b.core) return a.core < b.core;
+                return a.cpu < b.cpu; });
+
+            if (options.policy == PinPolicy::Compact)
+            {
+                for (const auto &c : cpus)
+                    order.push_back(c.cpu);
+            }
+            else
+            {
+                // Per node: first SMT thread of every core, then the second, ...
+                std::map<int, std::vector<int>> per_node;
+                std::map<std::pair<int, int>, int> seen; // (package, core) -> threads so far
+                std::map<int, std::vector<std::pair<int, int>>> ranked; // node -> (smt rank, cpu)
+                for (const auto &c : cpus)
+                {
+                    int rank = seen[{c.package, c.core}]++;
+                    ranked[c.node].push_back({rank, c.cpu});
+                }
+                for (auto &[node, list] : ranked)
+                {
+                    std::stable_sort(list.begin(), list.end(), [](const auto &a, const auto &b)
+                                     { return a.first < b.first; });
+                    for (const auto &entry : list)
+                        per_node[node].push_back(entry.second);
+                }
+                // Round-robin over nodes
+                for (size_t i = 0; order.size() < cpus.size(); ++i)
+                {
+                    for (auto &[node, list] : per_node)
+                    {
+                        if (i < list.size())
+                            order.push_back(list[i]);
+                    }
+                }
+            }
+        }
+
+        for (size_t w = 0; w < workers; ++w)
+            plan[w] = order[w % order.size()];
+        return plan;
+    }
+
+    // Pins the calling thread to one logical CPU. Returns false if the
+    // platform has no affinity support or the CPU is not allowed.
+    inline bool pin_current_thread(int cpu)
+    {
+#ifdef UTEC_HAS_AFFINITY
+        if (cpu < 0 || cpu >= CPU_SETSIZE)
+            return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    // CPU the calling thread is running on right now, -1 if unknown
+    inline int current_cpu()
+    {
+#ifdef UTEC_HAS_AFFINITY
+        return sched_getcpu();
+#else
+        return -1;
+#endif
+    }
+
+    // Asks the kernel to place the pages of [data, data + bytes) on a NUMA
+    // node (MPOL_PREFERRED: falls back to other nodes when it is full).
+    // Pages already touched are not moved. Returns false where unsupported.
+    inline bool bind_memory_to_node(void *data, size_t bytes, int node)
+    {
+#if defined(UTEC_HAS_AFFINITY) && defined(SYS_mbind)
+        if (node < 0 || node >= 64 || bytes == 0)
+            return false;
+        const long page = sysconf(_SC_PAGESIZE);
+        uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~static_cast<uintptr_t>(page - 1);
+        uintptr_t end = reinterpret_cast<uintptr_t>(data) + bytes;
+        unsigned long mask = 1ul << node;
+        const int mpol_preferred = 1;
+        return syscall(SYS_mbind, begin, end - begin, mpol_preferred, &mask,
+                       sizeof(mask) * 8, 0u) == 0;
+#else
+        (void)data;
+        (void)bytes;
+        (void)node;
+        return false;
+#endif
+    }
+
+    // Writes one element per page from the calling thread, so that under the
+    // default first-touch policy the pages land on this thread's NUMA node.
+    template <typename T>
+    void first_touch(T *data, size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "first_touch needs plain data");
+        if (count == 0)
+            return;
+        const size_t step = std::max<size_t>(1, 4096 / sizeof(T));
+        volatile T *p = data;
+        for (size_t i = 0; i < count; i += step)
+            p[i] = T{};
+        p[count - 1] = T{};
+    }
+
+} // namespace utec::parallel
+
+#endif // UTEC_PARALLEL_AFFINITY_H
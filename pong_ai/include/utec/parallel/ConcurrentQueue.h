@@ -5,6 +5,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <stdexcept> // For std::runtime_error
+#include "../profiling/Profiler.h"
 
 namespace utec::parallel
 {
@@ -21,6 +22,7 @@ namespace utec::parallel
                 throw std::runtime_error("Cannot push to a stopped queue");
             }
             queue_.push(item);
+            UTEC_PROFILE_COUNTER("queue_depth", queue_.size());
             lock.unlock();
             cond_.notify_one();
         }
@@ -18,10 +18,26 @@ namespace utec::nn
         {
         }
 
+        // Inference goes through the realtime lane, ahead of queued
+        // background work on the same pool
         std::future<int> act_async(const State &state)
         {
-            return pool_.enqueue([this, state]
-                                 { return agent_.act(state); });
+            return pool_.enqueue_with({utec::parallel::Priority::Realtime, std::nullopt},
+                                      [this, state]
+                                      { return agent_.act(state); });
+        }
+
+        // Evaluation, checkpointing and other work that must not delay act_async
+        template <typename F>
+        auto run_background(F &&f) -> std::future<decltype(f())>
+        {
+            return pool_.enqueue_with({utec::parallel::Priority::Background, std::nullopt},
+                                      std::forward<F>(f));
+        }
+
+        utec::parallel::QueueDelayStats queue_stats(utec::parallel::Priority priority) const
+        {
+            return pool_.queue_stats(priority);
         }
 
         int act(const State &state)
@@ -29,6 +45,22 @@ namespace utec::nn
             return agent_.act(state);
         }
 
+        // Hot reload while act_async keeps serving (see PongAgent)
+        void establecer_parametros(const std::vector<T> &params)
+        {
+            agent_.establecer_parametros(params);
+        }
+
+        void publish_model(std::unique_ptr<ILayer<T>> model)
+        {
+            agent_.publish_model(std::move(model));
+        }
+
+        uint64_t model_version() const
+        {
+            return agent_.model_version();
+        }
+
     private:
         PongAgent<T> agent_;
         utec::parallel::ThreadPool pool_;
@@ -0,0 +1,220 @@
+#ifndef UTEC_PARALLEL_PRIORITYTASKQUEUE_H
+#define UTEC_PARALLEL_PRIORITYTASKQUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+#include "../profiling/Profiler.h"
+
+namespace utec::parallel
+{
+
+    enum class Priority
+    {
+        Realtime = 0,  // Latency-critical (inference)
+        Normal = 1,    // Default for enqueue()
+        Background = 2 // Evaluation, checkpointing, batch jobs
+    };
+
+    constexpr size_t num_priorities = 3;
+
+    struct TaskOptions
+    {
+        Priority priority = Priority::Normal;
+        // Tasks with a deadline run before deadline-less ones of the same
+        // class, earliest deadline first
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+    };
+
+    // Queueing delay (enqueue -> start) of one priority class
+    struct QueueDelayStats
+    {
+        static constexpr size_t buckets = 40; // Power-of-two buckets in ns
+
+        uint64_t count = 0;
+        uint64_t missed_deadlines = 0; // Started after their deadline
+        double total_ns = 0;
+        uint64_t max_ns = 0;
+        std::array<uint64_t, buckets> histogram{};
+
+        void record(uint64_t ns)
+        {
+            ++count;
+            total_ns += static_cast<double>(ns);
+            max_ns = std::max(max_ns, ns);
+            size_t b = 0;
+            while (b + 1 < buckets && (uint64_t{1} << (b + 1)) <= ns)
+                ++b;
+            ++histogram[b];
+        }
+
+        double mean_us() const { return count == 0 ? 0.0 : total_ns / count / 1000.0; }
+        double max_us() const { return static_cast<double>(max_ns) / 1000.0; }
+
+        // Upper bound of the bucket holding the p-th percentile (p in [0, 100])
+        double percentile_us(double p) const
+        {
+            if (count == 0)
+                return 0.0;
+            uint64_t rank = static_cast<uint64_t>(p / 100.0 * (count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t b = 0; b < buckets; ++b)
+            {
+                seen += histogram[b];
+                if (seen >= rank)
+                    return std::min(static_cast<double>(uint64_t{1} << (b + 1)), static_cast<double>(max_ns)) / 1000.0;
+            }
+            return max_us();
+        }
+    };
+
+    // Multi-lane task queue for ThreadPool. pop() always serves the highest
+    // priority lane that has work; within a lane, tasks with a deadline go
+    // first in earliest-deadline-first order, then the rest in FIFO order.
+    // Strict priority means sustained realtime load can starve background
+    // work, which is the intended trade-off for inference latency.
+    class PriorityTaskQueue
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Task = std::function<void()>;
+
+        void push(Task task, const TaskOptions &options = {})
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stop_)
+            {
+                throw std::runtime_error("Cannot push to a stopped queue");
+            }
+            Lane &lane = lanes_[static_cast<size_t>(options.priority)];
+            Entry entry{std::move(task), Clock::now(), options.deadline, next_seq_++};
+            if (options.deadline)
+            {
+                lane.by_deadline.push(std::move(entry));
+            }
+            else
+            {
+                lane.fifo.push_back(std::move(entry));
+            }
+            ++size_;
+            UTEC_PROFILE_COUNTER("queue_depth", size_);
+            // Notify under the lock: a task posted from a non-worker thread
+            // (e.g. a timer) may be the last one, and the pool can be torn
+            // down as soon as it runs
+            cond_.notify_one();
+        }
+
+        // Blocks until a task is available; false once shut down
+        bool pop(Task &task)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this]()
+                       { return size_ > 0 || stop_; });
+            if (stop_ || size_ == 0)
+                return false;
+
+            for (size_t p = 0; p < num_priorities; ++p)
+            {
+                Lane &lane = lanes_[p];
+                if (lane.by_deadline.empty() && lane.fifo.empty())
+                    continue;
+
+                Entry entry;
+                if (!lane.by_deadline.empty())
+                {
+                    // priority_queue::top is const; the entry is moved out
+                    // right before it is popped
+                    entry = std::move(const_cast<Entry &>(lane.by_deadline.top()));
+                    lane.by_deadline.pop();
+                }
+                else
+                {
+                    entry = std::move(lane.fifo.front());
+                    lane.fifo.pop_front();
+                }
+                --size_;
+
+                const auto now = Clock::now();
+                QueueDelayStats &st = stats_[p];
+                st.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - entry.enqueued).count()));
+                if (entry.deadline && now > *entry.deadline)
+                    ++st.missed_deadlines;
+
+                task = std::move(entry.task);
+                return true;
+            }
+            return false;
+        }
+
+        void shutdown()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+            cond_.notify_all();
+        }
+
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return size_;
+        }
+
+        QueueDelayStats stats(Priority priority) const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_[static_cast<size_t>(priority)];
+        }
+
+        void reset_stats()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_ = {};
+        }
+
+    private:
+        struct Entry
+        {
+            Task task;
+            Clock::time_point enqueued;
+            std::optional<Clock::time_point> deadline;
+            uint64_t seq = 0; // Ties on equal deadlines keep submission order
+        };
+
+        struct LaterDeadline
+        {
+            bool operator()(const Entry &a, const Entry &b) const
+            {
+                if (*a.deadline != *b.deadline)
+                    return *a.deadline > *b.deadline;
+                return a.seq > b.seq;
+            }
+        };
+
+        struct Lane
+        {
+            std::priority_queue<Entry, std::vector<Entry>, LaterDeadline> by_deadline;
+            std::deque<Entry> fifo;
+        };
+
+        std::array<Lane, num_priorities> lanes_;
+        std::array<QueueDelayStats, num_priorities> stats_{};
+        size_t size_ = 0;
+        uint64_t next_seq_ = 0;
+        mutable std::mutex mutex_;
+        std::condition_variable cond_;
+        bool stop_ = false;
+    };
+
+} // namespace utec::parallel
+
+#endif // UTEC_PARALLEL_PRIORITYTASKQUEUE_H
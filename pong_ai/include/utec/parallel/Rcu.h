@@ -0,0 +1,171 @@
+#ifndef UTEC_PARALLEL_RCU_H
+#define UTEC_PARALLEL_RCU_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "Affinity.h"
+
+namespace utec::parallel
+{
+
+    // Read-copy-update cell: one published T that readers use without locks
+    // while a writer replaces it.
+    //
+    //     RcuCell<Model> cell(std::make_unique<Model>(...));
+    //     {
+    //         auto model = cell.read();     // wait-free, never sees a torn T
+    //         model->infer(...);
+    //     }                                 // snapshot released here
+    //     auto old = cell.exchange(std::move(next)); // old is ours again
+    //
+    // A reader announces itself on one of two counters (the current phase)
+    // before loading the pointer. exchange() swaps the pointer and then
+    // flips the phase twice, each time waiting for the counter it left to
+    // drain; after both flips no reader can still hold the previous value,
+    // which is handed back to the writer for reuse or destruction.
+    // Counters are striped by thread so readers on different cores do not
+    // share a cache line.
+    //
+    // A thread must not call exchange() while it holds a snapshot of the
+    // same cell: the grace period would wait for itself forever.
+    template <typename T>
+    class RcuCell
+    {
+        struct Version
+        {
+            std::unique_ptr<T> value;
+            uint64_t number;
+        };
+
+        static constexpr size_t stripes = 16;
+
+        struct alignas(cache_line) ReaderCount
+        {
+            std::atomic<size_t> count[2] = {0, 0};
+        };
+
+    public:
+        // Read-side critical section; the value stays alive while it exists
+        class Snapshot
+        {
+        public:
+            Snapshot(Snapshot &&other) noexcept
+                : cell_(std::exchange(other.cell_, nullptr)), version_(other.version_),
+                  stripe_(other.stripe_), phase_(other.phase_) {}
+
+            Snapshot(const Snapshot &) = delete;
+            Snapshot &operator=(const Snapshot &) = delete;
+            Snapshot &operator=(Snapshot &&) = delete;
+
+            ~Snapshot()
+            {
+                if (cell_ != nullptr)
+                    cell_->readers_[stripe_].count[phase_].fetch_sub(1, std::memory_order_release);
+            }
+
+            T &operator*() const noexcept { return *version_->value; }
+            T *operator->() const noexcept { return version_->value.get(); }
+            T *get() const noexcept { return version_->value.get(); }
+
+            // Publication this snapshot belongs to (1 for the initial value)
+            uint64_t version() const noexcept { return version_->number; }
+
+        private:
+            friend class RcuCell;
+            Snapshot(const RcuCell *cell, const Version *version, size_t stripe, unsigned phase) noexcept
+                : cell_(cell), version_(version), stripe_(stripe), phase_(phase) {}
+
+            const RcuCell *cell_;
+            const Version *version_;
+            size_t stripe_;
+            unsigned phase_;
+        };
+
+        explicit RcuCell(std::unique_ptr<T> initial)
+        {
+            if (!initial)
+                throw std::invalid_argument("RcuCell needs an initial value");
+            current_.store(new Version{std::move(initial), 1});
+        }
+
+        RcuCell(const RcuCell &) = delete;
+        RcuCell &operator=(const RcuCell &) = delete;
+
+        // No snapshot may outlive the cell
+        ~RcuCell() { delete current_.load(); }
+
+        Snapshot read() const noexcept
+        {
+            const size_t stripe = reader_stripe();
+            const unsigned phase = phase_.load() & 1;
+            readers_[stripe].count[phase].fetch_add(1);
+            // Loaded after announcing: a writer that swapped before this load
+            // is not waiting for us, one that swaps after it will be
+            return Snapshot(this, current_.load(), stripe, phase);
+        }
+
+        // Publishes next and returns the previous value once no reader can
+        // still see it. Writers are serialized; readers never wait.
+        std::unique_ptr<T> exchange(std::unique_ptr<T> next)
+        {
+            if (!next)
+                throw std::invalid_argument("RcuCell cannot publish an empty value");
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            Version *fresh = new Version{std::move(next), current_.load()->number + 1};
+            Version *old = current_.exchange(fresh);
+            synchronize();
+            std::unique_ptr<T> value = std::move(old->value);
+            delete old;
+            return value;
+        }
+
+        // Publishes next and destroys the previous value
+        void publish(std::unique_ptr<T> next)
+        {
+            exchange(std::move(next));
+        }
+
+        uint64_t version() const noexcept
+        {
+            return read().version();
+        }
+
+    private:
+        // Grace period: every reader that started before the pointer swap
+        // has finished. Two flips, because a reader may have read the phase
+        // just before the first one and announced itself after its wait.
+        void synchronize()
+        {
+            for (int flip = 0; flip < 2; ++flip)
+            {
+                const unsigned drained = phase_.fetch_add(1) & 1;
+                for (size_t s = 0; s < stripes; ++s)
+                {
+                    while (readers_[s].count[drained].load() != 0)
+                        std::this_thread::yield();
+                }
+            }
+        }
+
+        static size_t reader_stripe() noexcept
+        {
+            thread_local const size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id()) % stripes;
+            return stripe;
+        }
+
+        std::atomic<Version *> current_{nullptr};
+        std::atomic<unsigned> phase_{0};
+        mutable ReaderCount readers_[stripes];
+        std::mutex writer_mutex_;
+    };
+
+} // namespace utec::parallel
+
+#endif
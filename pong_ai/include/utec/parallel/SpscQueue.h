@@ -0,0 +1,90 @@
+#ifndef UTEC_PARALLEL_SPSCQUEUE_H
+#define UTEC_PARALLEL_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Affinity.h"
+
+namespace utec::parallel
+{
+
+    // Bounded lock-free queue for exactly one producer and one consumer thread.
+    // Capacity is rounded up to a power of two. try_push/try_pop never block;
+    // head and tail live on separate cache lines to avoid false sharing.
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        explicit SpscQueue(size_t capacity)
+        {
+            if (capacity == 0)
+            {
+                throw std::invalid_argument("SpscQueue capacity must be positive");
+            }
+            size_t cap = 1;
+            while (cap < capacity)
+                cap <<= 1;
+            buffer_.resize(cap);
+            mask_ = cap - 1;
+        }
+
+        // Producer side. Returns false when the queue is full; the item is only
+        // moved from once the push succeeds, so a failed push can be retried.
+        bool try_push(const T &item) { return push(item); }
+        bool try_push(T &&item) { return push(std::move(item)); }
+
+        // Consumer side. Returns false when the queue is empty.
+        bool try_pop(T &item)
+        {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_cache_)
+            {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_)
+                    return false;
+            }
+            item = std::move(buffer_[head & mask_]);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t capacity() const { return mask_ + 1; }
+
+        // Approximate when called concurrently
+        size_t size() const
+        {
+            return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+        }
+
+        bool empty() const { return size() == 0; }
+
+    private:
+        template <typename U>
+        bool push(U &&item)
+        {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_cache_ > mask_)
+            {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (tail - head_cache_ > mask_)
+                    return false;
+            }
+            buffer_[tail & mask_] = std::forward<U>(item);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::vector<T> buffer_;
+        size_t mask_ = 0;
+        alignas(cache_line) std::atomic<size_t> head_{0}; // next slot to read
+        size_t tail_cache_ = 0;                           // consumer's view of tail_
+        alignas(cache_line) std::atomic<size_t> tail_{0}; // next slot to write
+        size_t head_cache_ = 0;                           // producer's view of head_
+    };
+
+} // namespace utec::parallel
+
+#endif
@@ -0,0 +1,463 @@
+#ifndef UTEC_PARALLEL_TASK_H
+#define UTEC_PARALLEL_TASK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <semaphore>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+
+// Coroutine layer over ThreadPool.
+//
+//     Task<int> rollout(ThreadPool &pool)
+//     {
+//         co_await pool.schedule();              // hop onto a worker
+//         co_await sleep_for(pool, 5ms);         // suspend, no thread blocked
+//         co_return 42;
+//     }
+//     int r = sync_wait(rollout(pool));          // from a non-worker thread
+//
+// Tasks are lazy: nothing runs until the task is awaited (or passed to
+// sync_wait/when_all). A suspended coroutine holds no thread, so a pool can
+// drive many more concurrent pipelines than it has workers.
+
+namespace utec::parallel
+{
+
+    template <typename T = void>
+    class Task;
+
+    namespace detail
+    {
+        // Resumes whoever awaited the task once it finishes (symmetric
+        // transfer, so long await chains do not grow the stack)
+        struct TaskFinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+            {
+                auto continuation = h.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        struct PromiseBase
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr error;
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            TaskFinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+
+            void rethrow_if_failed() const
+            {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        };
+
+        template <typename T>
+        struct Promise : PromiseBase
+        {
+            std::optional<T> value;
+
+            Task<T> get_return_object() noexcept;
+
+            template <typename U>
+            void return_value(U &&v)
+            {
+                value.emplace(std::forward<U>(v));
+            }
+
+            T take()
+            {
+                rethrow_if_failed();
+                return std::move(*value);
+            }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase
+        {
+            Task<void> get_return_object() noexcept;
+            void return_void() const noexcept {}
+            void take() const { rethrow_if_failed(); }
+        };
+    } // namespace detail
+
+    // Lazily started coroutine producing a T. Move-only; owns its frame.
+    template <typename T>
+    class [[nodiscard]] Task
+    {
+    public:
+        using promise_type = detail::Promise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        Task() = default;
+        explicit Task(handle_type h) : handle_(h) {}
+        Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    handle_.destroy();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        ~Task()
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        bool done() const { return !handle_ || handle_.done(); }
+
+        // Awaiting starts the task; the awaiter resumes when it completes,
+        // on whichever thread finished it
+        auto operator co_await() noexcept
+        {
+            struct Awaiter
+            {
+                handle_type h;
+
+                bool await_ready() const noexcept { return !h || h.done(); }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    h.promise().continuation = awaiting;
+                    return h;
+                }
+                T await_resume() { return h.promise().take(); }
+            };
+            return Awaiter{handle_};
+        }
+
+    private:
+        handle_type handle_;
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        Task<T> Promise<T>::get_return_object() noexcept
+        {
+            return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> Promise<void>::get_return_object() noexcept
+        {
+            return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+        }
+
+        // Minimal eager-resumable coroutine used by sync_wait and when_all.
+        // `on_final` runs once the body is done and the frame is suspended.
+        struct Detached
+        {
+            struct promise_type
+            {
+                std::function<std::coroutine_handle<>()> on_final;
+
+                Detached get_return_object() noexcept
+                {
+                    return Detached{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+                std::suspend_always initial_suspend() const noexcept { return {}; }
+
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept { return false; }
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+                    {
+                        auto next = h.promise().on_final();
+                        return next ? next : std::noop_coroutine();
+                    }
+                    void await_resume() const noexcept {}
+                };
+                FinalAwaiter final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+                void unhandled_exception() const noexcept { std::terminate(); } // bodies catch
+            };
+
+            explicit Detached(std::coroutine_handle<promise_type> h) : handle(h) {}
+            Detached(Detached &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+            Detached(const Detached &) = delete;
+            ~Detached()
+            {
+                if (handle)
+                    handle.destroy();
+            }
+
+            std::coroutine_handle<promise_type> handle;
+        };
+
+        // Awaits `task`, storing its result or exception
+        template <typename T>
+        Detached await_into(Task<T> &task, std::optional<T> &out, std::exception_ptr &error)
+        {
+            try
+            {
+                out.emplace(co_await task);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        inline Detached await_into(Task<void> &task, std::optional<bool> &out, std::exception_ptr &error)
+        {
+            try
+            {
+                co_await task;
+                out.emplace(true);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        template <typename T>
+        using Slot = std::optional<std::conditional_t<std::is_void_v<T>, bool, T>>;
+
+        // Starts every child and suspends the awaiting coroutine until the
+        // last one finishes. The count starts at n + 1 so that children
+        // finishing synchronously while we are still launching cannot resume
+        // the parent early; the final decrement decides who resumes it.
+        struct WhenAllAwaiter
+        {
+            std::vector<Detached> &children;
+            std::atomic<size_t> &remaining;
+            std::coroutine_handle<> &parent;
+
+            bool await_ready() const noexcept { return children.empty(); }
+            bool await_suspend(std::coroutine_handle<> h)
+            {
+                parent = h;
+                remaining.store(children.size() + 1, std::memory_order_relaxed);
+                for (auto &child : children)
+                    child.handle.resume();
+                return remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+            }
+            void await_resume() const noexcept {}
+        };
+
+        template <typename T>
+        Task<void> when_all_impl(std::vector<Task<T>> &tasks, std::vector<Slot<T>> &results)
+        {
+            std::vector<std::exception_ptr> errors(tasks.size());
+            std::vector<Detached> children;
+            children.reserve(tasks.size());
+            std::atomic<size_t> remaining{0};
+            std::coroutine_handle<> parent;
+            for (size_t i = 0; i < tasks.size(); ++i)
+            {
+                children.push_back(await_into(tasks[i], results[i], errors[i]));
+                children.back().handle.promise().on_final = [&remaining, &parent]() -> std::coroutine_handle<>
+                {
+                    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        return parent;
+                    return {};
+                };
+            }
+            co_await WhenAllAwaiter{children, remaining, parent};
+            for (auto &e : errors)
+            {
+                if (e)
+                    std::rethrow_exception(e);
+            }
+        }
+    } // namespace detail
+
+    // Runs all tasks concurrently (each one runs inline until its first
+    // suspension, e.g. co_await pool.schedule()) and completes when all are
+    // done. Results keep the input order; the first stored exception is
+    // rethrown after every task has finished.
+    template <typename T>
+    Task<std::vector<T>> when_all(std::vector<Task<T>> tasks)
+    {
+        std::vector<detail::Slot<T>> results(tasks.size());
+        co_await detail::when_all_impl(tasks, results);
+        std::vector<T> values;
+        values.reserve(results.size());
+        for (auto &r : results)
+            values.push_back(std::move(*r));
+        co_return values;
+    }
+
+    inline Task<void> when_all(std::vector<Task<void>> tasks)
+    {
+        std::vector<detail::Slot<void>> results(tasks.size());
+        co_await detail::when_all_impl(tasks, results);
+    }
+
+    // Blocks the calling thread until the task completes and returns its
+    // result. Never call it from a worker of the pool the task runs on.
+    template <typename T>
+    T sync_wait(Task<T> task)
+    {
+        std::binary_semaphore done{0};
+        detail::Slot<T> result;
+        std::exception_ptr error;
+        detail::Detached waiter = detail::await_into(task, result, error);
+        waiter.handle.promise().on_final = [&done]() -> std::coroutine_handle<>
+        {
+            done.release();
+            return {};
+        };
+        waiter.handle.resume();
+        done.acquire();
+        if (error)
+            std::rethrow_exception(error);
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*result);
+    }
+
+    namespace detail
+    {
+        // One background thread that fires timers for sleep_for. Expired
+        // timers post the sleeping coroutine back to its pool, so the timer
+        // thread never runs user code. Timers of a pool that has been
+        // destroyed in the meantime are dropped without resuming anything.
+        class TimerService
+        {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            static TimerService &instance()
+            {
+                static TimerService service;
+                return service;
+            }
+
+            void schedule_at(Clock::time_point when, std::function<void()> fire)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    timers_.push({when, seq_++, std::move(fire)});
+                }
+                cond_.notify_one();
+            }
+
+            ~TimerService()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                }
+                cond_.notify_one();
+                thread_.join();
+            }
+
+        private:
+            struct Timer
+            {
+                Clock::time_point when;
+                uint64_t seq;
+                std::function<void()> fire;
+                bool operator>(const Timer &other) const
+                {
+                    return when != other.when ? when > other.when : seq > other.seq;
+                }
+            };
+
+            TimerService() : thread_([this]
+                                     { run(); }) {}
+
+            void run()
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (!stop_)
+                {
+                    if (timers_.empty())
+                    {
+                        cond_.wait(lock);
+                        continue;
+                    }
+                    auto when = timers_.top().when;
+                    if (Clock::now() < when)
+                    {
+                        cond_.wait_until(lock, when);
+                        continue;
+                    }
+                    auto fire = std::move(const_cast<Timer &>(timers_.top()).fire);
+                    timers_.pop();
+                    lock.unlock();
+                    try
+                    {
+                        fire();
+                    }
+                    catch (...)
+                    {
+                        // The pool no longer takes work; an exception here
+                        // would terminate the process
+                    }
+                    lock.lock();
+                }
+            }
+
+            std::mutex mutex_;
+            std::condition_variable cond_;
+            std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+            uint64_t seq_ = 0;
+            bool stop_ = false;
+            std::thread thread_;
+        };
+    } // namespace detail
+
+    // Suspends the coroutine for `duration` without holding a thread, then
+    // resumes it on a worker of `pool`
+    template <typename Rep, typename Period>
+    auto sleep_for(ThreadPool &pool, std::chrono::duration<Rep, Period> duration,
+                   const TaskOptions &options = {})
+    {
+        struct Awaiter
+        {
+            ThreadPool &pool;
+            std::chrono::steady_clock::time_point when;
+            TaskOptions options;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                detail::TimerService::instance().schedule_at(when, [pool = &pool, lifetime = pool.lifetime(), h, opts = options]
+                                                             {
+                    // Holding the mutex keeps the pool alive while posting
+                    std::lock_guard<std::mutex> lock(lifetime->mutex);
+                    if (lifetime->alive)
+                        pool->post(opts, [h]
+                                   { h.resume(); }); });
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{pool, std::chrono::steady_clock::now() + duration, options};
+    }
+
+    // Gives other queued work a turn: re-queues the coroutine at the back of
+    // its class
+    inline ThreadPool::ScheduleAwaiter yield(ThreadPool &pool, const TaskOptions &options = {})
+    {
+        return pool.schedule(options);
+    }
+
+} // namespace utec::parallel
+
+#endif // UTEC_PARALLEL_TASK_H
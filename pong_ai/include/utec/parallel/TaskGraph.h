@@ -0,0 +1,326 @@
+#ifndef UTEC_PARALLEL_TASKGRAPH_H
+#define UTEC_PARALLEL_TASKGRAPH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+#include "../profiling/Profiler.h"
+
+// Static dependency graph executed on a ThreadPool.
+//
+//     TaskGraph step;
+//     auto fwd_a = step.emplace([&] { forward(shard_a); }, "fwd_a");
+//     auto fwd_b = step.emplace([&] { forward(shard_b); }, "fwd_b");
+//     auto reduce = step.emplace([&] { reduce_gradients(); }, "reduce");
+//     auto update = step.emplace([&] { apply_update(); }, "update");
+//     reduce.succeed(fwd_a).succeed(fwd_b);
+//     reduce.precede(update);
+//
+//     for (size_t epoch = 0; epoch < epochs; ++epoch)
+//         step.run(pool);
+//
+// The graph is checked and compiled once (on the first run after it was
+// modified); every later run only resets one counter per task. A finishing
+// task decrements its successors' counters and posts the ones that became
+// ready; the first of them runs inline on the same worker, so chains do not
+// go through the queue and no worker ever blocks waiting for a dependency.
+
+namespace utec::parallel
+{
+
+    class TaskGraph
+    {
+    public:
+        // Lightweight reference to a task of this graph, used to wire edges
+        class TaskRef
+        {
+        public:
+            // This task runs before `other`
+            TaskRef &precede(TaskRef other)
+            {
+                graph_->precede(id_, other.id_);
+                return *this;
+            }
+
+            // This task runs after `other`
+            TaskRef &succeed(TaskRef other)
+            {
+                graph_->precede(other.id_, id_);
+                return *this;
+            }
+
+            size_t id() const { return id_; }
+
+        private:
+            friend class TaskGraph;
+            TaskRef(TaskGraph *graph, size_t id) : graph_(graph), id_(id) {}
+
+            TaskGraph *graph_;
+            size_t id_;
+        };
+
+        TaskGraph() = default;
+        TaskGraph(const TaskGraph &) = delete;
+        TaskGraph &operator=(const TaskGraph &) = delete;
+
+        ~TaskGraph()
+        {
+            // A graph must outlive its runs
+            if (running())
+                wait_for_completion();
+        }
+
+        // `name` must outlive the graph (string literals); it labels the task
+        // in profiler traces
+        TaskRef emplace(std::function<void()> work, const char *name = "graph_task",
+                        const TaskOptions &options = {})
+        {
+            ensure_idle();
+            nodes_.push_back(Node{std::move(work), name, options, {}, 0});
+            compiled_ = false;
+            return TaskRef(this, nodes_.size() - 1);
+        }
+
+        void precede(size_t before, size_t after)
+        {
+            ensure_idle();
+            if (before >= nodes_.size() || after >= nodes_.size())
+            {
+                throw std::out_of_range("Task id out of range");
+            }
+            nodes_[before].successors.push_back(after);
+            ++nodes_[after].num_predecessors;
+            compiled_ = false;
+        }
+
+        size_t size() const { return nodes_.size(); }
+
+        size_t num_edges() const
+        {
+            size_t edges = 0;
+            for (const auto &node : nodes_)
+                edges += node.successors.size();
+            return edges;
+        }
+
+        bool running() const { return running_.load(std::memory_order_acquire); }
+
+        // Executes the whole graph and blocks until every task has finished.
+        // Rethrows the first exception thrown by a task; tasks that had not
+        // started when it was thrown are skipped. Must not be called from a
+        // worker of `pool`.
+        void run(ThreadPool &pool)
+        {
+            run_async(pool);
+            wait();
+        }
+
+        // Starts the graph and returns immediately. `on_done` (optional) is
+        // invoked on the thread that finishes the last task, with the first
+        // exception thrown (or nullptr); the graph is already idle by then, so
+        // the continuation may re-run it.
+        void run_async(ThreadPool &pool, std::function<void(std::exception_ptr)> on_done = {})
+        {
+            if (running_.exchange(true, std::memory_order_acq_rel))
+            {
+                throw std::logic_error("TaskGraph is already running");
+            }
+            try
+            {
+                compile();
+            }
+            catch (...)
+            {
+                running_.store(false, std::memory_order_release);
+                throw;
+            }
+
+            pool_ = &pool;
+            on_done_ = std::move(on_done);
+            error_ = nullptr;
+            failed_.store(false, std::memory_order_relaxed);
+            remaining_.store(nodes_.size(), std::memory_order_relaxed);
+            for (size_t i = 0; i < nodes_.size(); ++i)
+                pending_[i].store(nodes_[i].num_predecessors, std::memory_order_relaxed);
+
+            if (nodes_.empty())
+            {
+                complete();
+                return;
+            }
+            // The run cannot finish before the last root is posted, but once it
+            // is, a continuation may already be re-running the graph: read
+            // nothing from `this` after that
+            const size_t roots = roots_.size();
+            for (size_t r = 0; r < roots; ++r)
+                dispatch(roots_[r]);
+        }
+
+        // Blocks until the current run (if any) has finished, then rethrows
+        // its first task exception
+        void wait()
+        {
+            wait_for_completion();
+            if (error_)
+            {
+                std::rethrow_exception(std::exchange(error_, nullptr));
+            }
+        }
+
+    private:
+        static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+        struct Node
+        {
+            std::function<void()> work;
+            const char *name;
+            TaskOptions options;
+            std::vector<size_t> successors;
+            size_t num_predecessors;
+        };
+
+        void ensure_idle() const
+        {
+            if (running())
+            {
+                throw std::logic_error("Cannot modify a running TaskGraph");
+            }
+        }
+
+        // Validates the graph (Kahn's algorithm) and sizes the per-run
+        // counters. No-op when nothing changed since the last run.
+        void compile()
+        {
+            if (compiled_)
+                return;
+            const size_t n = nodes_.size();
+            roots_.clear();
+            std::vector<size_t> indegree(n), order;
+            order.reserve(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                indegree[i] = nodes_[i].num_predecessors;
+                if (indegree[i] == 0)
+                {
+                    roots_.push_back(i);
+                    order.push_back(i);
+                }
+            }
+            for (size_t head = 0; head < order.size(); ++head)
+            {
+                for (size_t s : nodes_[order[head]].successors)
+                {
+                    if (--indegree[s] == 0)
+                        order.push_back(s);
+                }
+            }
+            if (order.size() != n)
+            {
+                throw std::invalid_argument("TaskGraph has a cycle");
+            }
+            pending_ = std::make_unique<std::atomic<size_t>[]>(n);
+            compiled_ = true;
+        }
+
+        void dispatch(size_t id)
+        {
+            pool_->post(nodes_[id].options, [this, id]
+                        { execute(id); });
+        }
+
+        // Runs `id` and then, inline, one successor it made ready, until the
+        // chain ends. Other ready successors go back to the pool.
+        void execute(size_t id)
+        {
+            while (id != none)
+            {
+                Node &node = nodes_[id];
+                if (!failed_.load(std::memory_order_acquire))
+                {
+                    try
+                    {
+                        UTEC_PROFILE_SCOPE(scope, "graph", node.name);
+                        node.work();
+                    }
+                    catch (...)
+                    {
+                        if (!failed_.exchange(true, std::memory_order_acq_rel))
+                            error_ = std::current_exception();
+                    }
+                }
+
+                size_t next = none;
+                for (size_t s : node.successors)
+                {
+                    if (pending_[s].fetch_sub(1, std::memory_order_acq_rel) != 1)
+                        continue;
+                    if (next == none)
+                        next = s;
+                    else
+                        dispatch(s);
+                }
+                // Nothing of the graph may be touched once the last task is
+                // accounted for: the owner can destroy it right away
+                if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    complete();
+                    return;
+                }
+                id = next;
+            }
+        }
+
+        void complete()
+        {
+            auto on_done = std::move(on_done_);
+            on_done_ = nullptr;
+            std::exception_ptr error = error_;
+            if (on_done)
+            {
+                // The continuation owns the error; wait() will not rethrow it
+                error_ = nullptr;
+            }
+            {
+                // Under the lock, so a waiter cannot return (and destroy the
+                // graph) before the notification is done
+                std::lock_guard<std::mutex> lock(done_mutex_);
+                running_.store(false, std::memory_order_release);
+                done_cond_.notify_all();
+            }
+            if (on_done)
+                on_done(error);
+        }
+
+        void wait_for_completion()
+        {
+            std::unique_lock<std::mutex> lock(done_mutex_);
+            done_cond_.wait(lock, [this]
+                            { return !running_.load(std::memory_order_acquire); });
+        }
+
+        std::vector<Node> nodes_;
+        std::vector<size_t> roots_;
+        std::unique_ptr<std::atomic<size_t>[]> pending_; // Unmet dependencies, reset every run
+        bool compiled_ = false;
+
+        ThreadPool *pool_ = nullptr;
+        std::function<void(std::exception_ptr)> on_done_;
+        std::exception_ptr error_;
+        std::atomic<bool> failed_{false};
+        std::atomic<size_t> remaining_{0};
+        std::atomic<bool> running_{false};
+        std::mutex done_mutex_;
+        std::condition_variable done_cond_;
+    };
+
+} // namespace utec::parallel
+
+#endif // UTEC_PARALLEL_TASKGRAPH_H
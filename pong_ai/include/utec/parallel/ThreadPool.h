@@ -2,24 +2,64 @@
 #define UTEC_PARALLEL_THREADPOOL_H
 
 #include "ConcurrentQueue.h"
+#include "PriorityTaskQueue.h"
+#include "Affinity.h"
 #include <vector>
 #include <thread>
 #include <functional>
 #include <future>
+#include <latch>
+#include <coroutine>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <exception>
 
 namespace utec::parallel
 {
 
+    template <typename R>
+    void wait_all(std::vector<std::future<R>> &futures);
+
+    namespace detail
+    {
+        // Shared with callbacks that may outlive their pool (sleep_for
+        // timers). The pool clears `alive` under the mutex before it stops,
+        // so a callback holding the mutex with alive set can still post.
+        struct PoolLifetime
+        {
+            std::mutex mutex;
+            bool alive = true;
+        };
+    } // namespace detail
+
     class ThreadPool
     {
     public:
         explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency())
+            : ThreadPool(num_threads, AffinityOptions{})
+        {
+        }
+
+        // Workers pinned according to `affinity` (see PinPolicy). Each worker
+        // pins itself before taking any task, so memory it allocates and
+        // touches afterwards is placed on its own NUMA node.
+        ThreadPool(size_t num_threads, const AffinityOptions &affinity)
             : queue_(), workers_()
         {
+            Topology topology = affinity.policy == PinPolicy::None ? Topology() : Topology::detect();
+            worker_cpus_ = plan_placement(topology, affinity, num_threads);
+            for (int cpu : worker_cpus_)
+                worker_nodes_.push_back(cpu < 0 ? -1 : topology.node_of(cpu));
+            pinned_ = std::vector<std::atomic<bool>>(num_threads);
+
             for (size_t i = 0; i < num_threads; ++i)
             {
-                workers_.emplace_back([this]
+                workers_.emplace_back([this, i]
                                       {
+                worker_index() = static_cast<int>(i);
+                if (worker_cpus_[i] >= 0)
+                    pinned_[i] = pin_current_thread(worker_cpus_[i]);
                 while (true) {
                     std::function<void()> task;
                     if (!queue_.pop(task)) break;
@@ -30,6 +70,10 @@ namespace utec::parallel
 
         ~ThreadPool()
         {
+            {
+                std::lock_guard<std::mutex> lock(lifetime_->mutex);
+                lifetime_->alive = false;
+            }
             queue_.shutdown();
             for (auto &worker : workers_)
             {
@@ -38,8 +82,16 @@ namespace utec::parallel
             }
         }
 
+        // Normal-priority task, FIFO among its class
         template <typename F, typename... Args>
         auto enqueue(F &&f, Args &&...args) -> std::future<decltype(f(args...))>
+        {
+            return enqueue_with(TaskOptions{}, std::forward<F>(f), std::forward<Args>(args)...);
+        }
+
+        // Task with an explicit priority class and optional deadline
+        template <typename F, typename... Args>
+        auto enqueue_with(const TaskOptions &options, F &&f, Args &&...args) -> std::future<decltype(f(args...))>
         {
             using return_type = decltype(f(args...));
 
@@ -47,16 +99,156 @@ namespace utec::parallel
                 std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 
             std::future<return_type> res = task->get_future();
+#if defined(UTEC_PROFILING) && UTEC_PROFILING
+            // Records the task's run time and how long it waited in the queue
+            queue_.push([task, queued_at = UTEC_PROFILE_NOW()]()
+                        {
+                UTEC_PROFILE_TASK(scope, "pool_task", queued_at);
+                (*task)(); },
+                        options);
+#else
             queue_.push([task]()
-                        { (*task)(); });
+                        { (*task)(); },
+                        options);
+#endif
             return res;
         }
 
+        // Fire-and-forget: no future, no shared state. f must be copyable.
+        template <typename F>
+        void post(F &&f)
+        {
+            post(TaskOptions{}, std::forward<F>(f));
+        }
+
+        template <typename F>
+        void post(const TaskOptions &options, F &&f)
+        {
+#if defined(UTEC_PROFILING) && UTEC_PROFILING
+            queue_.push([fn = std::forward<F>(f), queued_at = UTEC_PROFILE_NOW()]() mutable
+                        {
+                UTEC_PROFILE_TASK(scope, "pool_task", queued_at);
+                fn(); },
+                        options);
+#else
+            queue_.push(std::function<void()>(std::forward<F>(f)), options);
+#endif
+        }
+
+        // `co_await pool.schedule()` continues the calling coroutine on a
+        // worker of this pool (see Task.h)
+        struct ScheduleAwaiter
+        {
+            ThreadPool &pool;
+            TaskOptions options;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                pool.post(options, [h]
+                          { h.resume(); });
+            }
+            void await_resume() const noexcept {}
+        };
+
+        ScheduleAwaiter schedule(const TaskOptions &options = {})
+        {
+            return ScheduleAwaiter{*this, options};
+        }
+
+        // Runs f(worker_index) exactly once on every worker and waits for all
+        // of them. Must not be called from a worker of this pool.
+        template <typename F>
+        void run_on_each_worker(F &&f)
+        {
+            const size_t n = workers_.size();
+            // Every task holds its worker until all n have started, so no
+            // worker can pick up two of them
+            std::latch started(static_cast<std::ptrdiff_t>(n));
+            std::vector<std::future<void>> done;
+            done.reserve(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                done.push_back(enqueue([&]
+                                       {
+                    started.arrive_and_wait();
+                    f(static_cast<size_t>(worker_index())); }));
+            }
+            wait_all(done);
+        }
+
+        // One value per worker, created by make(worker_index) on that worker,
+        // so buffers are allocated and first touched on the worker's NUMA node.
+        template <typename Make>
+        auto make_worker_local(Make &&make) -> std::vector<decltype(make(size_t{}))>
+        {
+            using Value = decltype(make(size_t{}));
+            std::vector<std::unique_ptr<Value>> slots(workers_.size());
+            run_on_each_worker([&](size_t i)
+                               { slots[i] = std::make_unique<Value>(make(i)); });
+            std::vector<Value> values;
+            values.reserve(slots.size());
+            for (auto &slot : slots)
+                values.push_back(std::move(*slot));
+            return values;
+        }
+
+        size_t size() const { return workers_.size(); }
+
+        std::shared_ptr<detail::PoolLifetime> lifetime() const { return lifetime_; }
+
+        // Queueing delay (enqueue -> start) of one priority class
+        QueueDelayStats queue_stats(Priority priority) const { return queue_.stats(priority); }
+        void reset_queue_stats() { queue_.reset_stats(); }
+
+        // Index of the calling thread within its pool, -1 outside any pool
+        static int current_worker() { return worker_index(); }
+
+        // Planned CPU / NUMA node of worker i (-1 when not pinned)
+        int worker_cpu(size_t i) const { return worker_cpus_.at(i); }
+        int worker_node(size_t i) const { return worker_nodes_.at(i); }
+
+        // Whether worker i managed to pin itself (false until it has started)
+        bool worker_pinned(size_t i) const { return pinned_.at(i).load(); }
+
     private:
-        ConcurrentQueue<std::function<void()>> queue_;
+        static int &worker_index()
+        {
+            thread_local int index = -1;
+            return index;
+        }
+
+        std::shared_ptr<detail::PoolLifetime> lifetime_ = std::make_shared<detail::PoolLifetime>();
+        PriorityTaskQueue queue_;
+        std::vector<int> worker_cpus_;
+        std::vector<int> worker_nodes_;
+        std::vector<std::atomic<bool>> pinned_;
         std::vector<std::thread> workers_;
     };
 
+    // Waits for every future, then rethrows the first exception. Tasks that
+    // capture the caller's locals by reference must all have finished before
+    // those locals go away, so a failure never cuts the wait short.
+    template <typename R>
+    void wait_all(std::vector<std::future<R>> &futures)
+    {
+        std::exception_ptr first_error;
+        for (auto &f : futures)
+        {
+            try
+            {
+                f.get();
+            }
+            catch (...)
+            {
+                if (!first_error)
+                    first_error = std::current_exception();
+            }
+        }
+        if (first_error)
+            std::rethrow_exception(first_error);
+    }
+
 } // namespace utec::parallel
 
-#endif
\ No newline at end of file
+#endif
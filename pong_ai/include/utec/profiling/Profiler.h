@@ -0,0 +1,300 @@
+#ifndef UTEC_PROFILING_PROFILER_H
+#define UTEC_PROFILING_PROFILER_H
+
+// Low-overhead hot-path instrumentation.
+//
+// Compile with -DUTEC_PROFILING=1 to enable the UTEC_PROFILE_* hooks placed in
+// the layers, NeuralNetwork and the ThreadPool; without it they expand to
+// nothing. Events go to a fixed-size ring buffer owned by the recording thread
+// (no locking on the hot path, oldest events are overwritten) and can be
+// dumped as Chrome trace-event JSON (chrome://tracing, Perfetto) or as a
+// per-name summary. Timestamps come from RDTSC on x86-64 when
+// UTEC_PROFILING_RDTSC is defined, otherwise from steady_clock.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(UTEC_PROFILING_RDTSC) && (defined(__x86_64__) || defined(_M_X64))
+#include <x86intrin.h>
+#define UTEC_PROFILING_HAS_RDTSC 1
+#endif
+
+namespace utec::profiling
+{
+
+    // ---- clock ----
+
+#ifdef UTEC_PROFILING_HAS_RDTSC
+    inline double ns_per_tick()
+    {
+        // Calibrated once against steady_clock
+        static const double ratio = []
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            uint64_t c0 = __rdtsc();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            uint64_t c1 = __rdtsc();
+            auto t1 = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+            return ns / static_cast<double>(c1 - c0);
+        }();
+        return ratio;
+    }
+
+    inline uint64_t now_ticks() { return __rdtsc(); }
+#else
+    inline double ns_per_tick() { return 1.0; }
+
+    inline uint64_t now_ticks()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+#endif
+
+    // ---- events ----
+
+    struct Event
+    {
+        const char *category; // static strings only
+        const char *name;
+        char phase;       // 'X' complete (scope), 'C' counter
+        uint64_t start;   // ticks
+        uint64_t duration; // ticks
+        double flops;     // work done inside the scope
+        uint64_t bytes;   // bytes allocated inside the scope
+        uint64_t wait;    // ticks spent queued before the scope (tasks)
+        double value;     // counter value
+    };
+
+    class ThreadBuffer
+    {
+    public:
+        static constexpr size_t capacity = size_t(1) << 15;
+
+        explicit ThreadBuffer(uint32_t tid) : tid_(tid), events_(capacity) {}
+
+        void push(const Event &e)
+        {
+            size_t i = head_.load(std::memory_order_relaxed);
+            events_[i & (capacity - 1)] = e;
+            head_.store(i + 1, std::memory_order_release);
+        }
+
+        // Copies the retained events, oldest first
+        std::vector<Event> snapshot() const
+        {
+            size_t head = head_.load(std::memory_order_acquire);
+            size_t count = std::min(head, capacity);
+            std::vector<Event> out;
+            out.reserve(count);
+            for (size_t i = head - count; i < head; ++i)
+                out.push_back(events_[i & (capacity - 1)]);
+            return out;
+        }
+
+        void clear() { head_.store(0, std::memory_order_release); }
+        uint32_t tid() const { return tid_; }
+
+        // Bytes allocated by this thread, sampled by scopes
+        uint64_t allocated = 0;
+
+    private:
+        uint32_t tid_;
+        std::atomic<size_t> head_{0};
+        std::vector<Event> events_;
+    };
+
+    struct SummaryRow
+    {
+        std::string category;
+        std::string name;
+        uint64_t calls = 0;
+        double total_us = 0;
+        double max_us = 0;
+        double wait_us = 0;
+        double flops = 0;
+        uint64_t bytes = 0;
+    };
+
+    class Profiler
+    {
+    public:
+        static Profiler &instance()
+        {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        // Buffer of the calling thread, registered on first use
+        ThreadBuffer &local()
+        {
+            thread_local std::shared_ptr<ThreadBuffer> buffer = register_thread();
+            return *buffer;
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &b : buffers_)
+                b->clear();
+        }
+
+        // Aggregates scope events by (category, name)
+        std::vector<SummaryRow> summary() const
+        {
+            std::map<std::pair<std::string, std::string>, SummaryRow> rows;
+            const double us = ns_per_tick() * 1e-3;
+            for (const auto &buffer : buffers())
+            {
+                for (const Event &e : buffer->snapshot())
+                {
+                    if (e.phase != 'X')
+                        continue;
+                    SummaryRow &row = rows[{e.category, e.name}];
+                    row.category = e.category;
+                    row.name = e.name;
+                    row.calls++;
+                    row.total_us += e.duration * us;
+                    row.max_us = std::max(row.max_us, e.duration * us);
+                    row.wait_us += e.wait * us;
+                    row.flops += e.flops;
+                    row.bytes += e.bytes;
+                }
+            }
+            std::vector<SummaryRow> out;
+            for (auto &kv : rows)
+                out.push_back(kv.second);
+            std::sort(out.begin(), out.end(), [](const SummaryRow &a, const SummaryRow &b)
+                      { return a.total_us > b.total_us; });
+            return out;
+        }
+
+        // Chrome trace-event JSON. Call while the instrumented threads are idle
+        // (events being written concurrently may show up half-updated).
+        bool write_chrome_trace(const std::string &path) const
+        {
+            std::ofstream out(path);
+            if (!out)
+                return false;
+            const double us = ns_per_tick() * 1e-3;
+            out << "{\"traceEvents\":[\n";
+            bool first = true;
+            for (const auto &buffer : buffers())
+            {
+                for (const Event &e : buffer->snapshot())
+                {
+                    out << (first ? "" : ",\n");
+                    first = false;
+                    out << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category
+                        << "\",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << buffer->tid()
+                        << ",\"ts\":" << e.start * us;
+                    if (e.phase == 'X')
+                    {
+                        out << ",\"dur\":" << e.duration * us << ",\"args\":{\"flops\":" << e.flops
+                            << ",\"bytes\":" << e.bytes << ",\"wait_us\":" << e.wait * us << "}}";
+                    }
+                    else
+                    {
+                        out << ",\"args\":{\"" << e.name << "\":" << e.value << "}}";
+                    }
+                }
+            }
+            out << "\n]}\n";
+            return static_cast<bool>(out);
+        }
+
+    private:
+        Profiler() = default;
+
+        std::shared_ptr<ThreadBuffer> register_thread()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto buffer = std::make_shared<ThreadBuffer>(static_cast<uint32_t>(buffers_.size()));
+            buffers_.push_back(buffer);
+            return buffer;
+        }
+
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return buffers_;
+        }
+
+        mutable std::mutex mutex_;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers_; // kept after threads exit
+    };
+
+    // Records a complete event for the enclosing scope
+    class ScopedEvent
+    {
+    public:
+        ScopedEvent(const char *category, const char *name, uint64_t queued_at = 0)
+            : buffer_(Profiler::instance().local()), category_(category), name_(name),
+              alloc_start_(buffer_.allocated), start_(now_ticks())
+        {
+            if (queued_at != 0 && queued_at < start_)
+                wait_ = start_ - queued_at;
+        }
+
+        ~ScopedEvent()
+        {
+            uint64_t end = now_ticks();
+            buffer_.push({category_, name_, 'X', start_, end - start_, flops_,
+                          buffer_.allocated - alloc_start_, wait_, 0.0});
+        }
+
+        ScopedEvent(const ScopedEvent &) = delete;
+        ScopedEvent &operator=(const ScopedEvent &) = delete;
+
+        void set_flops(double flops) { flops_ = flops; }
+
+    private:
+        ThreadBuffer &buffer_;
+        const char *category_;
+        const char *name_;
+        uint64_t alloc_start_;
+        uint64_t start_;
+        uint64_t wait_ = 0;
+        double flops_ = 0;
+    };
+
+    inline void record_counter(const char *name, double value)
+    {
+        Profiler::instance().local().push({"counter", name, 'C', now_ticks(), 0, 0.0, 0, 0, value});
+    }
+
+    inline void note_allocation(uint64_t bytes)
+    {
+        Profiler::instance().local().allocated += bytes;
+    }
+
+} // namespace utec::profiling
+
+#if defined(UTEC_PROFILING) && UTEC_PROFILING
+#define UTEC_PROFILE_SCOPE(var, category, name) ::utec::profiling::ScopedEvent var(category, name)
+#define UTEC_PROFILE_TASK(var, name, queued_at) ::utec::profiling::ScopedEvent var("task", name, queued_at)
+#define UTEC_PROFILE_FLOPS(var, flops) var.set_flops(static_cast<double>(flops))
+#define UTEC_PROFILE_COUNTER(name, value) ::utec::profiling::record_counter(name, static_cast<double>(value))
+#define UTEC_PROFILE_ALLOC(bytes) ::utec::profiling::note_allocation(bytes)
+#define UTEC_PROFILE_NOW() ::utec::profiling::now_ticks()
+#else
+#define UTEC_PROFILE_SCOPE(var, category, name) ((void)0)
+#define UTEC_PROFILE_TASK(var, name, queued_at) ((void)0)
+#define UTEC_PROFILE_FLOPS(var, flops) ((void)0)
+#define UTEC_PROFILE_COUNTER(name, value) ((void)0)
+#define UTEC_PROFILE_ALLOC(bytes) ((void)0)
+#define UTEC_PROFILE_NOW() uint64_t(0)
+#endif
+
+#endif // UTEC_PROFILING_PROFILER_H
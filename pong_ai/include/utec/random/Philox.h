@@ -0,0 +1,243 @@
+#ifndef UTEC_RANDOM_PHILOX_H
+#define UTEC_RANDOM_PHILOX_H
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace utec::random
+{
+
+    // Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+    // numbers: as easy as 1, 2, 3", SC'11).
+    //
+    // Output block n is a pure function of (key, counter): there is no
+    // sequential state to share, so any number of threads, layers or
+    // environments can draw reproducible, independent numbers. The 128-bit
+    // counter is laid out as
+    //     [block index (64 bits) | substream (32 bits) | stream (32 bits)]
+    // and the key is the 64-bit seed. A generator is 48 bytes.
+    class Philox
+    {
+    public:
+        using result_type = uint32_t;
+        using Block = std::array<uint32_t, 4>;
+
+        explicit Philox(uint64_t seed = 0, uint32_t stream = 0, uint32_t substream = 0)
+            : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+              stream_(stream), substream_(substream)
+        {
+        }
+
+        // Generator for another substream of the same seed and stream
+        Philox split(uint32_t substream) const { return Philox(seed(), stream_, substream); }
+
+        uint64_t seed() const { return (static_cast<uint64_t>(key_[1]) << 32) | key_[0]; }
+        uint32_t stream() const { return stream_; }
+        uint32_t substream() const { return substream_; }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<uint32_t>::max(); }
+
+        result_type operator()()
+        {
+            if (index_ == 4)
+            {
+                buffer_ = block(next_block_++);
+                index_ = 0;
+            }
+            return buffer_[index_++];
+        }
+
+        // Skips n outputs in O(1)
+        void discard(uint64_t n)
+        {
+            uint64_t position = position_() + n;
+            next_block_ = position / 4;
+            index_ = 4;
+            if (position % 4 != 0)
+            {
+                buffer_ = block(next_block_++);
+                index_ = static_cast<unsigned>(position % 4);
+            }
+        }
+
+        // Uniform in [0, 1)
+        float uniform() { return to_unit((*this)()); }
+
+        // Standard normal variate (Box-Muller, the sine half is dropped)
+        float normal()
+        {
+            float u1 = to_unit_open((*this)());
+            float u2 = to_unit((*this)());
+            return std::sqrt(-2.0f * std::log(u1)) * std::cos(two_pi * u2);
+        }
+
+        // Bulk generation: n uniforms in [lo, hi). Whole blocks are produced
+        // by a branch-free kernel over several counters at once, which the
+        // compiler turns into SIMD code.
+        template <typename T>
+        void fill_uniform(T *out, size_t n, T lo = T(0), T hi = T(1))
+        {
+            const T scale = hi - lo;
+            generate(n, [&](size_t i, uint32_t bits)
+                     { out[i] = lo + scale * static_cast<T>(to_unit(bits)); });
+        }
+
+        // Bulk generation: n normal variates (both Box-Muller halves are used)
+        template <typename T>
+        void fill_normal(T *out, size_t n, T mean = T(0), T stddev = T(1))
+        {
+            float pending_u1 = 0;
+            generate(n + (n & 1), [&](size_t i, uint32_t bits)
+                     {
+                if ((i & 1) == 0)
+                {
+                    pending_u1 = to_unit_open(bits);
+                    return;
+                }
+                float r = std::sqrt(-2.0f * std::log(pending_u1));
+                float theta = two_pi * to_unit(bits);
+                out[i - 1] = mean + stddev * static_cast<T>(r * std::cos(theta));
+                if (i < n)
+                    out[i] = mean + stddev * static_cast<T>(r * std::sin(theta)); });
+        }
+
+        // The raw Philox4x32-10 bijection
+        static Block philox(Block ctr, std::array<uint32_t, 2> key)
+        {
+            for (int round = 0; round < 10; ++round)
+            {
+                if (round > 0)
+                {
+                    key[0] += weyl0;
+                    key[1] += weyl1;
+                }
+                uint64_t p0 = static_cast<uint64_t>(mul0) * ctr[0];
+                uint64_t p1 = static_cast<uint64_t>(mul1) * ctr[2];
+                ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+                       static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+            }
+            return ctr;
+        }
+
+        // Output block n of this stream
+        Block block(uint64_t n) const
+        {
+            return philox({static_cast<uint32_t>(n), static_cast<uint32_t>(n >> 32), substream_, stream_}, key_);
+        }
+
+    private:
+        static constexpr uint32_t mul0 = 0xD2511F53;
+        static constexpr uint32_t mul1 = 0xCD9E8D57;
+        static constexpr uint32_t weyl0 = 0x9E3779B9;
+        static constexpr uint32_t weyl1 = 0xBB67AE85;
+        static constexpr float two_pi = 6.28318530717958647692f;
+        static constexpr size_t lanes = 8;
+
+        // 24 high bits -> [0, 1) and (0, 1]
+        static float to_unit(uint32_t bits) { return static_cast<float>(bits >> 8) * 0x1.0p-24f; }
+        static float to_unit_open(uint32_t bits) { return static_cast<float>((bits >> 8) + 1) * 0x1.0p-24f; }
+
+        uint64_t position_() const { return next_block_ * 4 - (4 - index_); }
+
+        // Feeds n consecutive outputs of the stream to sink(i, bits),
+        // continuing from (and advancing) the current position
+        template <typename Sink>
+        void generate(size_t n, Sink &&sink)
+        {
+            size_t i = 0;
+            while (i < n && index_ < 4)
+                sink(i++, buffer_[index_++]);
+
+            // lanes blocks per iteration, structure-of-arrays
+            while (n - i >= 4 * lanes)
+            {
+                uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    uint64_t b = next_block_ + l;
+                    c0[l] = static_cast<uint32_t>(b);
+                    c1[l] = static_cast<uint32_t>(b >> 32);
+                    c2[l] = substream_;
+                    c3[l] = stream_;
+                }
+                uint32_t k0 = key_[0], k1 = key_[1];
+                for (int round = 0; round < 10; ++round)
+                {
+                    if (round > 0)
+                    {
+                        k0 += weyl0;
+                        k1 += weyl1;
+                    }
+                    for (size_t l = 0; l < lanes; ++l)
+                    {
+                        uint64_t p0 = static_cast<uint64_t>(mul0) * c0[l];
+                        uint64_t p1 = static_cast<uint64_t>(mul1) * c2[l];
+                        uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+                        uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+                        c1[l] = static_cast<uint32_t>(p1);
+                        c3[l] = static_cast<uint32_t>(p0);
+                        c0[l] = n0;
+                        c2[l] = n2;
+                    }
+                }
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    sink(i++, c0[l]);
+                    sink(i++, c1[l]);
+                    sink(i++, c2[l]);
+                    sink(i++, c3[l]);
+                }
+                next_block_ += lanes;
+            }
+
+            while (i < n)
+                sink(i++, (*this)());
+        }
+
+        std::array<uint32_t, 2> key_;
+        uint32_t stream_;
+        uint32_t substream_;
+        uint64_t next_block_ = 0;
+        Block buffer_{};
+        unsigned index_ = 4; // Next unread word of buffer_ (4 = empty)
+    };
+
+    // Process-wide seed for generators that are not given one explicitly.
+    // Defaults to 0 so runs are reproducible; set_global_seed changes it.
+    inline std::atomic<uint64_t> &global_seed_storage()
+    {
+        static std::atomic<uint64_t> seed{0};
+        return seed;
+    }
+
+    inline uint64_t global_seed() { return global_seed_storage().load(std::memory_order_relaxed); }
+    inline void set_global_seed(uint64_t seed) { global_seed_storage().store(seed, std::memory_order_relaxed); }
+
+    // A fresh non-deterministic seed (one random_device call, not per object)
+    inline uint64_t entropy_seed()
+    {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }
+
+    // Hands out distinct stream ids for one category of consumers (e.g. one
+    // counter for layers, another for environments). Thread-safe.
+    struct LayerStreams;
+    struct EnvStreams;
+
+    template <typename Tag>
+    uint32_t next_stream()
+    {
+        static std::atomic<uint32_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+} // namespace utec::random
+
+#endif // UTEC_RANDOM_PHILOX_H
@@ -0,0 +1,243 @@
+#ifndef UTEC_TUNING_SWEEP_H
+#define UTEC_TUNING_SWEEP_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../nn/trainer.h"
+#include "../parallel/ThreadPool.h"
+
+namespace utec::tuning
+{
+    using utec::neural_network::TrainConfig;
+
+    enum class SearchMode
+    {
+        Grid,  // Every combination of the candidate lists
+        Random // num_samples combinations drawn uniformly from the lists
+    };
+
+    // Search space and budget of a sweep
+    struct SweepSpec
+    {
+        std::vector<std::vector<size_t>> architectures = {{64, 32}};
+        std::vector<float> learning_rates = {0.01f};
+        std::vector<float> l2_lambdas = {0.001f};
+        std::vector<float> prune_ratios = {0.1f};
+        size_t epochs = 1000; // Full budget of a surviving trial
+
+        SearchMode mode = SearchMode::Grid;
+        size_t num_samples = 16; // Random mode only
+        uint64_t seed = 42;      // Random mode only
+
+        // Successive halving: every trial first runs min_epochs, then only the
+        // best 1/eta continue to eta * min_epochs, and so on up to `epochs`.
+        // min_epochs == 0 (or >= epochs) trains every trial to the end.
+        size_t min_epochs = 0;
+        size_t eta = 3;
+
+        std::vector<TrainConfig> expand() const
+        {
+            if (architectures.empty() || learning_rates.empty() ||
+                l2_lambdas.empty() || prune_ratios.empty())
+            {
+                throw std::invalid_argument("Every sweep dimension needs at least one value");
+            }
+
+            auto make = [&](size_t a, size_t l, size_t r, size_t p)
+            {
+                TrainConfig c;
+                c.hidden = architectures[a];
+                c.learning_rate = learning_rates[l];
+                c.l2_lambda = l2_lambdas[r];
+                c.prune_ratio = prune_ratios[p];
+                c.epochs = epochs;
+                return c;
+            };
+
+            std::vector<TrainConfig> configs;
+            if (mode == SearchMode::Grid)
+            {
+                for (size_t a = 0; a < architectures.size(); ++a)
+                    for (size_t l = 0; l < learning_rates.size(); ++l)
+                        for (size_t r = 0; r < l2_lambdas.size(); ++r)
+                            for (size_t p = 0; p < prune_ratios.size(); ++p)
+                                configs.push_back(make(a, l, r, p));
+            }
+            else
+            {
+                std::mt19937_64 rng(seed);
+                auto pick = [&](size_t n)
+                { return std::uniform_int_distribution<size_t>(0, n - 1)(rng); };
+                for (size_t i = 0; i < num_samples; ++i)
+                {
+                    size_t a = pick(architectures.size());
+                    size_t l = pick(learning_rates.size());
+                    size_t r = pick(l2_lambdas.size());
+                    size_t p = pick(prune_ratios.size());
+                    configs.push_back(make(a, l, r, p));
+                }
+            }
+            return configs;
+        }
+    };
+
+    struct TrialResult
+    {
+        size_t id = 0;
+        TrainConfig config;
+        size_t epochs_run = 0;
+        float loss = 0;
+        double accuracy = 0; // Percentage on the training set
+        bool completed = false; // false: stopped early by successive halving
+        double seconds = 0;     // Training time of this trial
+    };
+
+    // Runs every trial of the spec on the pool. Each trial trains
+    // single-threaded on its own network; all of them share X and labels
+    // read-only. Results come back sorted best first (accuracy, then loss).
+    //
+    // on_rung, if given, is called on the calling thread after each halving
+    // rung with the results of that rung.
+    template <typename T, typename Label>
+    std::vector<TrialResult> run_sweep(const SweepSpec &spec,
+                                       const utec::algebra::Tensor<T, 2> &X,
+                                       const std::vector<Label> &labels,
+                                       utec::parallel::ThreadPool &pool,
+                                       const std::function<void(size_t, const std::vector<TrialResult> &)> &on_rung = {})
+    {
+        using Clock = std::chrono::steady_clock;
+        using utec::neural_network::Trainer;
+
+        const std::vector<TrainConfig> configs = spec.expand();
+        if (spec.epochs == 0)
+        {
+            throw std::invalid_argument("Sweep needs a positive epoch budget");
+        }
+        if (spec.eta < 2 && spec.min_epochs > 0 && spec.min_epochs < spec.epochs)
+        {
+            throw std::invalid_argument("Successive halving needs eta >= 2");
+        }
+
+        // Networks are built here, serially, so initialization does not race
+        std::vector<TrialResult> results(configs.size());
+        std::vector<std::unique_ptr<Trainer<T, Label>>> trainers;
+        trainers.reserve(configs.size());
+        for (size_t i = 0; i < configs.size(); ++i)
+        {
+            results[i].id = i;
+            results[i].config = configs[i];
+            trainers.push_back(std::make_unique<Trainer<T, Label>>(configs[i], X, labels));
+        }
+
+        std::vector<size_t> active(configs.size());
+        for (size_t i = 0; i < active.size(); ++i)
+            active[i] = i;
+
+        size_t budget = (spec.min_epochs == 0 || spec.min_epochs >= spec.epochs) ? spec.epochs : spec.min_epochs;
+        for (size_t rung = 0; !active.empty(); ++rung)
+        {
+            const bool last = budget >= spec.epochs;
+
+            std::vector<std::future<void>> pending;
+            pending.reserve(active.size());
+            for (size_t id : active)
+            {
+                pending.push_back(pool.enqueue([&, id, budget, last]
+                                               {
+                    auto &trainer = *trainers[id];
+                    auto start = Clock::now();
+                    trainer.run(budget - trainer.epochs_done());
+                    if (last)
+                        trainer.prune();
+                    double accuracy = trainer.evaluate();
+                    auto &r = results[id];
+                    r.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+                    r.epochs_run = trainer.epochs_done();
+                    r.loss = static_cast<float>(trainer.last_loss());
+                    r.accuracy = accuracy;
+                    r.completed = last; }));
+            }
+            // Rethrows a trial's exception once every trial of the rung is done
+            utec::parallel::wait_all(pending);
+
+            std::sort(active.begin(), active.end(), [&](size_t a, size_t b)
+                      {
+                if (results[a].accuracy != results[b].accuracy)
+                    return results[a].accuracy > results[b].accuracy;
+                return results[a].loss < results[b].loss; });
+
+            if (on_rung)
+            {
+                std::vector<TrialResult> rung_results;
+                for (size_t id : active)
+                    rung_results.push_back(results[id]);
+                on_rung(rung, rung_results);
+            }
+
+            if (last)
+                break;
+
+            // Stopped trials release their network right away
+            size_t keep = std::max<size_t>(1, (active.size() + spec.eta - 1) / spec.eta);
+            for (size_t i = keep; i < active.size(); ++i)
+                trainers[active[i]].reset();
+            active.resize(keep);
+            budget = std::min(spec.epochs, budget * spec.eta);
+        }
+
+        std::stable_sort(results.begin(), results.end(), [](const TrialResult &a, const TrialResult &b)
+                         {
+            if (a.completed != b.completed)
+                return a.completed;
+            if (a.epochs_run != b.epochs_run)
+                return a.epochs_run > b.epochs_run;
+            if (a.accuracy != b.accuracy)
+                return a.accuracy > b.accuracy;
+            return a.loss < b.loss; });
+        return results;
+    }
+
+    // One row per trial, ranked as returned by run_sweep
+    inline void write_results_csv(std::ostream &os, const std::vector<TrialResult> &results)
+    {
+        os << "rank,trial,hidden,learning_rate,l2_lambda,prune_ratio,epochs_run,completed,loss,accuracy,seconds\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &r = results[i];
+            os << i + 1 << "," << r.id << "," << r.config.hidden_string() << ","
+               << r.config.learning_rate << "," << r.config.l2_lambda << ","
+               << r.config.prune_ratio << "," << r.epochs_run << ","
+               << (r.completed ? 1 : 0) << "," << r.loss << "," << r.accuracy << ","
+               << r.seconds << "\n";
+        }
+    }
+
+    inline void print_results(std::ostream &os, const std::vector<TrialResult> &results, size_t top = 10)
+    {
+        os << std::left << std::setw(6) << "rank" << std::setw(7) << "trial"
+           << std::setw(42) << "config" << std::setw(8) << "epochs"
+           << std::setw(10) << "loss" << std::setw(10) << "acc%" << "time(s)\n";
+        for (size_t i = 0; i < results.size() && i < top; ++i)
+        {
+            const auto &r = results[i];
+            os << std::left << std::setw(6) << i + 1 << std::setw(7) << r.id
+               << std::setw(42) << r.config.describe() << std::setw(8) << r.epochs_run
+               << std::setw(10) << std::setprecision(4) << r.loss
+               << std::setw(10) << std::setprecision(4) << r.accuracy
+               << std::setprecision(3) << r.seconds << "\n";
+        }
+        os << std::right << std::setprecision(6);
+    }
+
+} // namespace utec::tuning
+
+#endif // UTEC_TUNING_SWEEP_H
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/utec/agent/LUTAgent.h"
+#include "../include/utec/io/Checkpointer.h"
+#include "../include/utec/io/Dataset.h"
+#include "../include/utec/nn/trainer.h"
+
+using namespace utec::neural_network;
+using namespace utec::nn;
+
+void print_agreement(const std::string &name, const LUTAgreement &a)
+{
+    static const char *actions[3] = {"up", "stay", "down"};
+    std::cout << name << ": " << a.rate() * 100 << "% of " << a.samples << " states agree\n";
+    std::cout << "  network \\ LUT    up   stay   down\n";
+    for (size_t n = 0; n < 3; ++n)
+    {
+        std::cout << "  " << actions[n] << "\t\t";
+        for (size_t l = 0; l < 3; ++l)
+            std::cout << " " << a.confusion[n][l];
+        std::cout << "\n";
+    }
+}
+
+// Nanoseconds per decision of f over states
+template <typename F>
+double ns_per_decision(const std::vector<State> &states, F &&f)
+{
+    int sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const State &s : states)
+        sink += f(s);
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    volatile int keep = sink;
+    (void)keep;
+    return elapsed.count() / states.size();
+}
+
+int main(int argc, char *argv[])
+{
+    // Usage: compile_lut [params_file] [lut_file] [cells_per_axis] [input.csv]
+    const std::string params_file = argc > 1 ? argv[1] : "trained_params.txt";
+    const std::string lut_file = argc > 2 ? argv[2] : "policy.lut";
+    const size_t cells = argc > 3 ? std::stoul(argv[3]) : 128;
+
+    // Topology train.cpp saves, so its parameter files load directly
+    auto model = build_model<float>(TrainConfig{}, 3, 3);
+    std::vector<float> params;
+    if (!utec::io::read_params(params_file, params) || params.size() != model->contar_parametros())
+    {
+        std::cerr << "Error: " << params_file << " does not hold " << model->contar_parametros()
+                  << " parameters\n";
+        return 1;
+    }
+    model->establecer_parametros(params);
+    PongAgent<float> agent(std::move(model));
+
+    utec::parallel::ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    auto start = std::chrono::steady_clock::now();
+    LUTAgent lut = LUTAgent::compile(agent, {cells, cells, cells}, pool);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Compiled " << cells << "^3 = " << lut.cells() << " cells in " << seconds << "s on "
+              << pool.size() << " threads\n";
+    std::cout << "Runs: " << lut.runs() << " (" << lut.bytes() << " bytes, dense table: " << lut.cells()
+              << " bytes)\n";
+
+    print_agreement("Uniform states", lut.agreement(agent, 1000000, 2024));
+    if (argc > 4)
+    {
+        std::vector<State> states;
+        for (const auto &row : utec::io::read_input_csv(argv[4]))
+            states.push_back({row[0], row[1], row[2]});
+        print_agreement("Dataset states", lut.agreement(agent, states));
+    }
+
+    std::vector<State> probe(200000);
+    utec::random::Philox rng(7);
+    for (auto &s : probe)
+        s = {rng.uniform(), rng.uniform(), rng.uniform()};
+    std::cout << "Decision time: LUT " << ns_per_decision(probe, [&](const State &s)
+                                                          { return lut.act(s); })
+              << " ns, network " << ns_per_decision(probe, [&](const State &s)
+                                                     { return agent.act(s); })
+              << " ns\n";
+
+    if (!lut.save(lut_file))
+    {
+        std::cerr << "Error: Could not write " << lut_file << "\n";
+        return 1;
+    }
+    std::cout << "LUT saved to " << lut_file << std::endl;
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../include/utec/io/PolicyServer.h"
+#include "../include/utec/io/Checkpointer.h"
+#include "../include/utec/nn/trainer.h"
+
+using namespace utec::neural_network;
+
+int main(int argc, char *argv[])
+{
+    // Usage: policy_server [params_file] [socket_path] [max_clients]
+    const std::string params_file = argc > 1 ? argv[1] : "trained_params.txt";
+    utec::io::PolicyServerConfig config;
+    if (argc > 2)
+        config.socket_path = argv[2];
+    if (argc > 3)
+        config.max_clients = std::stoul(argv[3]);
+
+    // Topology train.cpp saves, so its parameter files load directly
+    auto model = build_model<float>(TrainConfig{}, 3, 3);
+    std::vector<float> params;
+    if (!utec::io::read_params(params_file, params) || params.size() != model->contar_parametros())
+    {
+        std::cerr << "Error: " << params_file << " does not hold " << model->contar_parametros()
+                  << " parameters\n";
+        return 1;
+    }
+    model->establecer_parametros(params);
+
+    // Block the stop signals before any thread starts, then wait for one
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try
+    {
+        utec::io::PolicyServer<float> server(std::move(model), config);
+        std::cout << "Serving " << params_file << " on " << config.socket_path << " for up to "
+                  << config.max_clients << " clients (Ctrl-C to stop)" << std::endl;
+        int signal = 0;
+        sigwait(&signals, &signal);
+
+        server.stop();
+        const auto stats = server.stats();
+        std::cout << "Answered " << stats.states << " states in " << stats.requests << " requests, "
+                  << stats.batches << " forward passes (largest " << stats.max_batch_states << ")\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include "../include/utec/nn/trainer.h"
+#include "../include/utec/io/Dataset.h"
+#include "../include/utec/tuning/Sweep.h"
+#include "../include/utec/parallel/ThreadPool.h"
+
+using namespace utec::neural_network;
+using namespace utec::tuning;
+
+// Splits "a,b,c" into its fields
+std::vector<std::string> split(const std::string &text, char sep)
+{
+    std::vector<std::string> parts;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, sep))
+    {
+        if (!item.empty())
+            parts.push_back(item);
+    }
+    return parts;
+}
+
+std::vector<float> parse_floats(const std::string &text)
+{
+    std::vector<float> values;
+    for (const auto &v : split(text, ','))
+        values.push_back(std::stof(v));
+    return values;
+}
+
+// "64x32,128x64,32" -> {{64, 32}, {128, 64}, {32}}
+std::vector<std::vector<size_t>> parse_architectures(const std::string &text)
+{
+    std::vector<std::vector<size_t>> archs;
+    for (const auto &arch : split(text, ','))
+    {
+        std::vector<size_t> widths;
+        if (arch != "linear")
+        {
+            for (const auto &w : split(arch, 'x'))
+                widths.push_back(std::stoul(w));
+        }
+        archs.push_back(widths);
+    }
+    return archs;
+}
+
+void print_usage(const char *prog)
+{
+    std::cerr << "Usage: " << prog << " input.csv [results.csv] [options]\n"
+              << "  --hidden=64x32,32x16    architectures to try\n"
+              << "  --lr=0.005,0.01,0.05    learning rates\n"
+              << "  --l2=0,0.001            L2 lambdas\n"
+              << "  --prune=0.1             pruning ratios\n"
+              << "  --epochs=1000           full budget per trial\n"
+              << "  --random=N              sample N configurations instead of the grid\n"
+              << "  --seed=S                seed for --random\n"
+              << "  --min-epochs=100        first successive-halving rung (0 disables)\n"
+              << "  --eta=3                 keep the best 1/eta trials at each rung\n"
+              << "  --threads=N             concurrent trials (default: all cores)\n"
+              << "  --pin=compact|scatter   pin worker threads to cores (default: none)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Default search space around the hand-tuned train.cpp values
+    SweepSpec spec;
+    spec.architectures = {{64, 32}, {32, 16}, {128, 64}};
+    spec.learning_rates = {0.005f, 0.01f, 0.05f};
+    spec.l2_lambdas = {0.0f, 0.001f};
+    spec.prune_ratios = {0.1f};
+    spec.epochs = 1000;
+    spec.min_epochs = 100;
+    spec.eta = 3;
+
+    std::string input_file = argv[1];
+    std::string output_file = "sweep_results.csv";
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    utec::parallel::AffinityOptions affinity;
+
+    try
+    {
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0)
+            {
+                output_file = arg;
+                continue;
+            }
+            size_t eq = arg.find('=');
+            if (eq == std::string::npos)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            std::string key = arg.substr(2, eq - 2);
+            std::string value = arg.substr(eq + 1);
+
+            if (key == "hidden")
+                spec.architectures = parse_architectures(value);
+            else if (key == "lr")
+                spec.learning_rates = parse_floats(value);
+            else if (key == "l2")
+                spec.l2_lambdas = parse_floats(value);
+            else if (key == "prune")
+                spec.prune_ratios = parse_floats(value);
+            else if (key == "epochs")
+                spec.epochs = std::stoul(value);
+            else if (key == "random")
+            {
+                spec.mode = SearchMode::Random;
+                spec.num_samples = std::stoul(value);
+            }
+            else if (key == "seed")
+                spec.seed = std::stoull(value);
+            else if (key == "min-epochs")
+                spec.min_epochs = std::stoul(value);
+            else if (key == "eta")
+                spec.eta = std::stoul(value);
+            else if (key == "threads")
+                threads = std::max<size_t>(1, std::stoul(value));
+            else if (key == "pin" && (value == "compact" || value == "scatter" || value == "none"))
+            {
+                affinity.policy = value == "compact"   ? utec::parallel::PinPolicy::Compact
+                                  : value == "scatter" ? utec::parallel::PinPolicy::Scatter
+                                                       : utec::parallel::PinPolicy::None;
+            }
+            else
+            {
+                std::cerr << "Unknown option: " << arg << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: invalid option value (" << e.what() << ")\n";
+        return 1;
+    }
+
+    // One read-only copy of the dataset shared by every trial
+    auto input_data = utec::io::read_input_csv(input_file);
+    if (input_data.empty())
+    {
+        return 1;
+    }
+    const Tensor<float, 2> X = utec::io::to_tensor(input_data);
+    const std::vector<int8_t> labels = derive_labels(X);
+
+    std::vector<TrialResult> results;
+    try
+    {
+        size_t trials = spec.expand().size();
+        std::cout << "Running " << trials << " trials on " << threads << " threads\n";
+
+        utec::parallel::ThreadPool pool(threads, affinity);
+        results = run_sweep(spec, X, labels, pool, [](size_t rung, const std::vector<TrialResult> &rung_results)
+                            {
+            const auto &best = rung_results.front();
+            std::cout << "Rung " << rung << ": " << rung_results.size() << " trials at "
+                      << best.epochs_run << " epochs | best " << best.accuracy << "% ("
+                      << best.config.describe() << ")\n"; });
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "\n";
+    print_results(std::cout, results);
+
+    std::ofstream out(output_file);
+    if (!out)
+    {
+        std::cerr << "Error: Could not open results file: " << output_file << "\n";
+        return 1;
+    }
+    write_results_csv(out, results);
+    std::cout << "\nResults table saved to " << output_file << std::endl;
+    return 0;
+}
@@ -6,161 +6,26 @@
 #include <memory>
 #include <string>
 #include <sstream>
-#include "../include/utec/nn/neural_network.h"
-#include "../include/utec/nn/dense.h"
-#include "../include/utec/nn/activation.h"
-#include "../include/utec/nn/loss.h"
-#include "../include/utec/nn/sequential.h"
+#include <cstdint>
+#include "../include/utec/nn/trainer.h"
+#include "../include/utec/nn/metrics.h"
 #include "../include/utec/agent/PongAgent.h"
 #include "../include/utec/agent/EnvGym.h"
+#include "../include/utec/io/AsyncLogger.h"
+#include "../include/utec/io/Dataset.h"
+#include "../include/utec/io/Checkpointer.h"
 
 using namespace utec::neural_network;
 using namespace utec::nn;
 using namespace utec::algebra;
 
-// Function to read CSV files into vectors
-std::vector<std::vector<float>> read_input_csv(const std::string &filename)
+// One row of the monitoring output
+struct EpochMetrics
 {
-    std::vector<std::vector<float>> data;
-    std::ifstream file(filename);
-
-    if (!file)
-    {
-        std::cerr << "Error: Could not open input file: " << filename << "\n";
-        return data;
-    }
-
-    std::string line;
-    while (std::getline(file, line))
-    {
-        if (line.empty())
-            continue;
-
-        std::vector<float> row;
-        std::stringstream ss(line);
-        std::string value;
-
-        while (std::getline(ss, value, ','))
-        {
-            try
-            {
-                row.push_back(std::stof(value));
-            }
-            catch (...)
-            {
-                std::cerr << "Warning: Invalid float value in input CSV: '" << value << "'\n";
-                row.clear();
-                break;
-            }
-        }
-
-        // Verify exactly 3 values per row (ball_x, ball_y, paddle_y)
-        if (row.size() == 3)
-        {
-            data.push_back(row);
-        }
-        else if (!row.empty())
-        {
-            std::cerr << "Warning: Expected 3 values per row, got " << row.size() << "\n";
-        }
-    }
-
-    if (data.empty())
-    {
-        std::cerr << "Error: No valid data found in input file\n";
-    }
-    else
-    {
-        std::cout << "Successfully loaded " << data.size() << " input samples\n";
-        std::cout << "First sample: "
-                  << data[0][0] << ", "
-                  << data[0][1] << ", "
-                  << data[0][2] << "\n";
-    }
-
-    return data;
-}
-
-// Function to convert action value to one-hot encoding
-std::vector<float> action_to_onehot(int action)
-{
-    std::vector<float> onehot(3, 0.0f);
-    if (action == -1)
-        onehot[2] = 1.0f; // Up
-    else if (action == 0)
-        onehot[1] = 1.0f; // Stay
-    else if (action == 1)
-        onehot[0] = 1.0f; // Down
-    return onehot;
-}
-
-// L2 Regularization implementation
-void apply_l2_regularization(NeuralNetwork<float> &net, float lambda)
-{
-    auto params = net.obtener_parametros();
-    for (auto &param : params)
-    {
-        param -= lambda * param;
-    }
-    net.establecer_parametros(params);
-}
-
-// Magnitude-based pruning
-void prune_network(NeuralNetwork<float> &net, float prune_ratio)
-{
-    auto params = net.obtener_parametros();
-
-    // Calculate threshold based on magnitude
-    std::vector<float> abs_params;
-    for (auto p : params)
-        abs_params.push_back(std::abs(p));
-    std::sort(abs_params.begin(), abs_params.end());
-    float threshold = abs_params[static_cast<size_t>(prune_ratio * abs_params.size())];
-
-    // Prune parameters below threshold
-    for (auto &p : params)
-    {
-        if (std::abs(p) < threshold)
-            p = 0.0f;
-    }
-
-    net.establecer_parametros(params);
-}
-
-// Function to compute accuracy
-float compute_accuracy(const Tensor<float, 2> &pred, const Tensor<float, 2> &Y)
-{
-    size_t num_samples = pred.shape()[0];
-    size_t correct = 0;
-
-    for (size_t i = 0; i < num_samples; ++i)
-    {
-        int pred_action = 0;
-        int true_action = 0;
-        float max_val = pred(i, 0);
-
-        // Find predicted action
-        for (int j = 1; j < 3; j++)
-        {
-            if (pred(i, j) > max_val)
-            {
-                max_val = pred(i, j);
-                pred_action = j;
-            }
-        }
-
-        // Find true action
-        if (Y(i, 1) == 1.0f)
-            true_action = 1;
-        else if (Y(i, 2) == 1.0f)
-            true_action = 2;
-
-        if (pred_action == true_action)
-            correct++;
-    }
-
-    return static_cast<float>(correct) / num_samples * 100.0f;
-}
+    size_t epoch;
+    float reward;
+    double precision;
+};
 
 int main(int argc, char *argv[])
 {
@@ -172,136 +37,93 @@ int main(int argc, char *argv[])
 
     // Load only input data
     const std::string input_file = argv[1];
-    auto input_data = read_input_csv(input_file);
+    auto input_data = utec::io::read_input_csv(input_file);
     if (input_data.empty())
     {
         return 1;
     }
 
     // Prepare input tensor
-    size_t num_samples = input_data.size();
-    Tensor<float, 2> X(num_samples, 3); // Input features
-
-    for (size_t i = 0; i < num_samples; ++i)
-    {
-        // Input features
-        for (size_t j = 0; j < 3; ++j)
-        {
-            X(i, j) = input_data[i][j];
-        }
-    }
-
-    // Create network architecture
-    Sequential<float> model;
-    model.add_layer(std::make_unique<Dense<float>>(3, 64));
-    model.add_layer(std::make_unique<ReLU<float>>());
-    model.add_layer(std::make_unique<Dense<float>>(64, 32));
-    model.add_layer(std::make_unique<ReLU<float>>());
-    model.add_layer(std::make_unique<Dense<float>>(32, 3));
-
-    // Create neural network
-    NeuralNetwork<float> net;
-    net.add_layer(std::make_unique<Sequential<float>>(std::move(model)));
+    const Tensor<float, 2> X = utec::io::to_tensor(input_data);
 
-    // Training parameters
-    const size_t epochs = 1000;
-    const float learning_rate = 0.01f;
-    const float l2_lambda = 0.001f;
-    const float prune_ratio = 0.1f;
+    // Training parameters (64/32 architecture, see TrainConfig)
+    TrainConfig config;
+    config.epochs = 1000;
+    config.learning_rate = 0.01f;
+    config.l2_lambda = 0.001f;
+    config.prune_ratio = 0.1f;
+    const size_t checkpoint_every = 100;
+    const std::string params_file = "trained_params.txt";
 
     // Open results file for Colab monitoring
     const std::string output_file = (argc > 2) ? argv[2] : "output.csv";
     std::ofstream results_file(output_file);
     results_file << "epoch,reward,precision\n";
 
-    // Training loop
-    for (size_t epoch = 0; epoch < epochs; ++epoch)
-    {
-        // Forward pass
-        Tensor<float, 2> pred = net.forward(X);
+    // Console/CSV output and checkpoints are written by background threads
+    utec::io::AsyncLogger<EpochMetrics> logger([&](const EpochMetrics &m)
+                                               {
+        std::cout << "Epoch " << m.epoch << " | Best Reward: " << m.reward
+                  << " | Precision: " << m.precision << "%\n";
+        results_file << m.epoch << "," << m.reward << "," << m.precision << "\n"; });
+    utec::io::AsyncCheckpointer<float> checkpointer(params_file);
 
-        // Generate synthetic targets and calculate accuracy
-        Tensor<float, 2> Y(num_samples, 3);
-        size_t correct = 0;
-        for (size_t i = 0; i < num_samples; ++i)
-        {
-            float ball_y = X(i, 1);
-            float paddle_y = X(i, 2);
-            float diff = ball_y - paddle_y;
+    // Softmax cross-entropy on the raw logits of the 3 actions; accuracy is
+    // only needed on logging epochs, where the metrics engine computes it
+    const std::vector<int8_t> labels = derive_labels(X);
+    Trainer<float> trainer(config, X, labels);
+    ClassificationMetrics metrics(3);
 
-            // Determine correct action
-            int true_action;
-            if (diff > 0.1f)
-            {
-                Y(i, 0) = 1.0f; // down
-                true_action = 0;
-            }
-            else if (diff < -0.1f)
-            {
-                Y(i, 2) = 1.0f; // up
-                true_action = 2;
-            }
-            else
-            {
-                Y(i, 1) = 1.0f; // stay
-                true_action = 1;
-            }
-
-            // Calculate accuracy
-            int pred_action = 0;
-            float max_val = pred(i, 0);
-            for (int j = 1; j < 3; j++)
-            {
-                if (pred(i, j) > max_val)
-                {
-                    max_val = pred(i, j);
-                    pred_action = j;
-                }
-            }
-            if (pred_action == true_action)
-                correct++;
-        }
-        float accuracy = static_cast<float>(correct) / num_samples * 100.0f;
-
-        // Calculate loss
-        MSELoss<float> criterion;
-        float loss = criterion.forward(pred, Y);
-
-        // Backward pass
-        Tensor<float, 2> grad = criterion.backward();
-        net.backward(grad);
-        net.optimizer(learning_rate);
-
-        // Apply L2 regularization
-        apply_l2_regularization(net, l2_lambda);
+    // Training loop
+    for (size_t epoch = 0; epoch < config.epochs; ++epoch)
+    {
+        float loss = trainer.step();
 
         // Colab monitoring output
         if (epoch % 10 == 0)
         {
-            std::cout << "Epoch " << epoch << " | Best Reward: " << (100 - loss)
-                      << " | Precision: " << accuracy << "%\n";
+            metrics.reset();
+            metrics.update(trainer.last_output(), labels);
+            logger.log({epoch, 100 - loss, metrics.accuracy()});
+        }
 
-            // Save to CSV for final analysis
-            results_file << epoch << "," << (100 - loss) << "," << accuracy << "\n";
+        // Crash-safe periodic checkpoint (copy now, write in background)
+        if ((epoch + 1) % checkpoint_every == 0)
+        {
+            checkpointer.snapshot(trainer.network().obtener_parametros());
         }
     }
+    logger.flush();
+
+    // Final confusion matrix on the training set
+    trainer.evaluate(metrics);
+    std::cout << "Final precision: " << metrics.accuracy() << "%\n";
+    metrics.print_confusion(std::cout, {"down", "stay", "up"});
 
     // Apply pruning for parameter reduction
-    prune_network(net, prune_ratio);
-    std::cout << "Applied pruning: Removed " << prune_ratio * 100
+    trainer.prune();
+    std::cout << "Applied pruning: Removed " << config.prune_ratio * 100
               << "% of smallest weights" << std::endl;
 
-    // Save trained parameters
-    auto params = net.obtener_parametros();
-    std::ofstream param_file("trained_params.txt");
-    for (const auto &p : params)
+    // Save trained parameters (atomically replaces the last checkpoint)
+    checkpointer.snapshot(trainer.network().obtener_parametros());
+    try
     {
-        param_file << p << "\n";
+        checkpointer.flush();
     }
-    param_file.close();
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "Training complete! Parameters saved to " << params_file << std::endl;
 
-    std::cout << "Training complete! Parameters saved to trained_params.txt" << std::endl;
-    results_file.close();
+#if defined(UTEC_PROFILING) && UTEC_PROFILING
+    // Built with -DUTEC_PROFILING=1: per-layer timings for chrome://tracing
+    utec::profiling::Profiler::instance().write_chrome_trace("train_trace.json");
+    std::cout << "Profiling trace saved to train_trace.json" << std::endl;
+#endif
 
     return 0;
 }
\ No newline at end of file
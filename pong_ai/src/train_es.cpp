@@ -0,0 +1,51 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "../include/utec/agent/EvolutionStrategies.h"
+#include "../include/utec/nn/trainer.h"
+#include "../include/utec/io/Checkpointer.h"
+
+using namespace utec::neural_network;
+using namespace utec::nn;
+
+int main(int argc, char *argv[])
+{
+    // Usage: train_es [generations] [params_file] [action_repeat]
+    const size_t generations = argc > 1 ? std::stoul(argv[1]) : 200;
+    const std::string params_file = argc > 2 ? argv[2] : "es_params.txt";
+
+    ESConfig config;
+    config.workers = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 3)
+        config.action_repeat = std::stoul(argv[3]);
+    utec::parallel::ThreadPool pool(config.workers);
+    // Topology train.cpp saves, so the parameter files are interchangeable
+    EvolutionStrategies<float> es([]
+                                  { return build_model<float>(TrainConfig{}, 3, 3); },
+                                  config, pool);
+
+    std::cout << "Evolution strategies: " << es.parameters().size() << " parameters, "
+              << 2 * config.population << " policies x " << config.episodes
+              << " episodes per generation on " << config.workers << " threads\n";
+
+    for (size_t g = 0; g < generations; ++g)
+    {
+        ESStats stats = es.step();
+        if (g % 10 == 0 || g + 1 == generations)
+        {
+            std::cout << "Generation " << g << " | Mean reward: " << stats.mean_fitness
+                      << " | Best reward: " << stats.max_fitness
+                      << " | Eval: " << es.evaluate(32, 12345)
+                      << " | " << stats.seconds << "s\n";
+        }
+    }
+
+    if (!utec::io::write_params_atomically(params_file, es.parameters()))
+    {
+        std::cerr << "Error: Could not write " << params_file << "\n";
+        return 1;
+    }
+    std::cout << "Parameters saved to " << params_file << std::endl;
+    return 0;
+}
@@ -1,7 +1,9 @@
 #include "../include/utec/agent/PongAgent.h"
 #include "../include/utec/agent/EnvGym.h"
+#include "../include/utec/agent/EvolutionStrategies.h"
 #include "../include/utec/nn/dense.h"
 #include "../include/utec/nn/sequential.h"
+#include <cstring>
 #include <iostream>
 
 using namespace utec::nn;
@@ -110,11 +112,85 @@ void test_boundaries()
     std::cout << (test ? "PASSED" : "FAILED") << "\n";
 }
 
+bool same_bits(const State &a, const State &b)
+{
+    return std::memcmp(&a, &b, sizeof(State)) == 0;
+}
+
+void test_step_repeat()
+{
+    std::cout << "5. step_repeat equivale bit a bit a step por frame\n";
+    bool ok = true;
+    size_t frames = 0, skipped = 0, hits = 0;
+    for (uint32_t episode = 0; episode < 200 && ok; ++episode)
+    {
+        EnvGym per_frame(77, episode), repeated(77, episode);
+        State s = per_frame.reset();
+        ok = same_bits(s, repeated.reset());
+        bool done = false;
+        for (size_t t = 0; t < 5000 && !done && ok; ++t)
+        {
+            // Track the ball (so the paddle hits) or hold a fixed action;
+            // event-driven spans alternate with fixed-length ones
+            const int action = t % 4 == 3 ? static_cast<int>(t % 3) - 1 : (s.ball_y > s.paddle_y ? 1 : -1);
+            const size_t span = t % 2 == 0 ? repeated.frames_to_event() + 1 : 1 + (t * 37) % 200;
+            skipped += span - 1;
+
+            float reward = 0, r;
+            bool d = false;
+            size_t k = 0;
+            for (; k < span && !d; ++k)
+            {
+                s = per_frame.step(action, r, d);
+                reward += r;
+                hits += r > 0;
+            }
+            float reward_repeat;
+            size_t stepped;
+            State s_repeat = repeated.step_repeat(action, span, reward_repeat, done, stepped);
+            ok = same_bits(s, s_repeat) && reward == reward_repeat && d == done && k == stepped;
+            frames += stepped;
+        }
+        ok = ok && done;
+    }
+    std::cout << "Frames: " << frames << ", skipped checks: " << skipped << ", hits: " << hits << "\n";
+    std::cout << (ok && hits > 0 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_run_episode_action_repeat()
+{
+    std::cout << "6. run_episode con action_repeat\n";
+    using T = float;
+    auto agent = PongAgent<T>(create_down_model<T>());
+    bool ok = true;
+    for (uint32_t episode = 0; episode < 20 && ok; ++episode)
+    {
+        // Reference: one decision every 8 frames through step()
+        EnvGym env(5, episode), reference(5, episode);
+        State s = reference.reset();
+        float expected = 0, reward;
+        bool done = false;
+        int action = 0;
+        for (size_t t = 0; t < 1000 && !done; ++t)
+        {
+            if (t % 8 == 0)
+                action = agent.act(s);
+            s = reference.step(action, reward, done);
+            expected += reward;
+        }
+        ok = run_episode(agent, env, 1000, 8) == expected;
+    }
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n";
+}
+
 int main()
 {
     test_basic_instantiation();
     test_single_step();
     test_integration();
     test_boundaries();
+    std::cout << "\n";
+    test_step_repeat();
+    test_run_episode_action_repeat();
     return 0;
 }
\ No newline at end of file
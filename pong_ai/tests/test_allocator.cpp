@@ -0,0 +1,191 @@
+#include "../include/utec/algebra/Tensor.h"
+#include "../include/utec/algebra/Reduce.h"
+#include "../include/utec/agent/PongAgent.h"
+#include "../include/utec/nn/dense.h"
+#include "../include/utec/nn/activation.h"
+#include "../include/utec/nn/sequential.h"
+#include <iostream>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+// Counts every heap allocation made by this program. Every replaceable
+// new/delete form forwards to these two helpers, so allocation and release
+// always pair malloc/aligned_alloc with free. They are kept out of line so
+// the compiler never matches an inlined free() against a new-expression.
+static std::atomic<size_t> heap_allocations{0};
+
+[[gnu::noinline]] static void *counted_alloc(size_t bytes, size_t align) noexcept
+{
+    ++heap_allocations;
+    if (bytes == 0)
+        bytes = 1;
+    if (align <= alignof(std::max_align_t))
+        return std::malloc(bytes);
+    return std::aligned_alloc(align, (bytes + align - 1) / align * align);
+}
+
+[[gnu::noinline]] static void counted_free(void *p) noexcept { std::free(p); }
+
+static void *counted_alloc_or_throw(size_t bytes, size_t align)
+{
+    if (void *p = counted_alloc(bytes, align))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t bytes) { return counted_alloc_or_throw(bytes, 0); }
+void *operator new[](size_t bytes) { return counted_alloc_or_throw(bytes, 0); }
+void *operator new(size_t bytes, std::align_val_t align) { return counted_alloc_or_throw(bytes, static_cast<size_t>(align)); }
+void *operator new[](size_t bytes, std::align_val_t align) { return counted_alloc_or_throw(bytes, static_cast<size_t>(align)); }
+void *operator new(size_t bytes, const std::nothrow_t &) noexcept { return counted_alloc(bytes, 0); }
+void *operator new[](size_t bytes, const std::nothrow_t &) noexcept { return counted_alloc(bytes, 0); }
+void *operator new(size_t bytes, std::align_val_t align, const std::nothrow_t &) noexcept { return counted_alloc(bytes, static_cast<size_t>(align)); }
+void *operator new[](size_t bytes, std::align_val_t align, const std::nothrow_t &) noexcept { return counted_alloc(bytes, static_cast<size_t>(align)); }
+
+void operator delete(void *p) noexcept { counted_free(p); }
+void operator delete[](void *p) noexcept { counted_free(p); }
+void operator delete(void *p, size_t) noexcept { counted_free(p); }
+void operator delete[](void *p, size_t) noexcept { counted_free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { counted_free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { counted_free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { counted_free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { counted_free(p); }
+
+using namespace utec::algebra;
+
+template <typename T>
+bool aligned_to(const T *p, size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+void test_alignment()
+{
+    std::cout << "Test 1: Tensor storage is cache-line aligned\n";
+    bool ok = true;
+    for (size_t n = 1; n < 200; n += 7)
+    {
+        Tensor<float, 2> a(n, 3);
+        Tensor<double, 1> b(n);
+        Tensor<float, 2, NumaLocalAllocator<float>> c(n, 1000);
+        ok = ok && aligned_to(a.data(), 64) && aligned_to(b.data(), 64) && aligned_to(c.data(), 64);
+    }
+    // 4096 x 1024 floats = 16 MB: backed by 2 MB aligned huge-page candidates
+    Tensor<float, 2, HugePageAllocator<float>> big(4096, 1024);
+    big.fill(1.0f);
+    ok = ok && aligned_to(big.data(), huge_page_size) && sum(big) == 4096.0f * 1024.0f;
+
+    // resize() keeps the alignment guarantee when it reallocates
+    Tensor<float, 2> r(2, 2);
+    r.resize({300, 17});
+    ok = ok && aligned_to(r.data(), 64);
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_mixed_allocators()
+{
+    std::cout << "Test 2: Tensors with different allocators interoperate\n";
+    Tensor<float, 2> a(4, 8);
+    Tensor<float, 2, PoolAllocator<float>> b(4, 8);
+    Tensor<float, 1, HugePageAllocator<float>> bias(8);
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a.data()[i] = static_cast<float>(i);
+        b.data()[i] = 2.0f;
+    }
+    bias.fill(0.5f);
+
+    Tensor<float, 2> c = a * b;
+    Tensor<float, 2, PoolAllocator<float>> d = a + b;
+    d += a;
+    Tensor<float, 2, NumaLocalAllocator<float>> e(a);
+
+    bool ok = c(3, 7) == 62.0f && d(3, 7) == 64.0f && e(2, 5) == a(2, 5);
+    // Rvalue reuse keeps the buffer (and allocator) of the dying operand
+    auto f = std::move(d) * 0.5f;
+    ok = ok && std::is_same_v<decltype(f), Tensor<float, 2, PoolAllocator<float>>> && f(3, 7) == 32.0f;
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_pool_recycling()
+{
+    std::cout << "Test 3: Pool allocator recycles buffers by size class\n";
+    auto &cache = *detail::SizeClassCache::local();
+    const size_t misses_before = cache.misses();
+
+    const float *first = nullptr;
+    bool reused = true;
+    for (int step = 0; step < 100; ++step)
+    {
+        // Same size class (<= 4 KB) every step: only the first allocates
+        Tensor<float, 2, PoolAllocator<float>> tmp(16, 60 + step % 4);
+        if (first == nullptr)
+            first = tmp.data();
+        reused = reused && tmp.data() == first;
+    }
+    const size_t misses = cache.misses() - misses_before;
+
+    // A buffer freed on another thread joins that thread's cache
+    Tensor<float, 1, PoolAllocator<float>> moved(1000);
+    std::thread([t = std::move(moved)] {}).join();
+
+    bool padding = padded_leading_dim<float>(3) == 16 && padded_leading_dim<float>(64) == 64 &&
+                   padded_leading_dim<float>(256) == 272 && padded_leading_dim<double>(128) == 136;
+
+    std::cout << "System allocations for 100 steps: " << misses << "\n";
+    std::cout << (reused && misses == 1 && padding ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_inline_storage()
+{
+    std::cout << "Test 4: Small tensors live inside the object\n";
+    const size_t before = heap_allocations;
+    Tensor<float, 2> a(1, 3), b(8, 8);
+    a(0, 2) = 1.5f;
+    Tensor<float, 2> c = a;
+    Tensor<float, 2> d = std::move(c);
+    d.resize({4, 16});
+    Tensor<float, 2> e = b * b + b;
+    SmallTensor<float, 2, 256> wide(16, 16);
+    bool no_heap = heap_allocations == before;
+
+    bool ok = a.is_inline() && d.is_inline() && wide.is_inline() && d(0, 2) == 1.5f && d(3, 15) == 0.0f;
+    // Growing past the inline capacity spills to the heap and keeps the prefix
+    d.resize({8, 16});
+    ok = ok && !d.is_inline() && d(0, 2) == 1.5f && d(7, 15) == 0.0f && aligned_to(d.data(), 64);
+
+    // Batch-1 inference through a 3-64-32-3 network: no allocation per decision
+    auto net = std::make_unique<utec::neural_network::Sequential<float>>();
+    net->add_layer(std::make_unique<utec::neural_network::Dense<float>>(3, 64));
+    net->add_layer(std::make_unique<utec::neural_network::ReLU<float>>());
+    net->add_layer(std::make_unique<utec::neural_network::Dense<float>>(64, 32));
+    net->add_layer(std::make_unique<utec::neural_network::ReLU<float>>());
+    net->add_layer(std::make_unique<utec::neural_network::Dense<float>>(32, 3));
+    utec::nn::PongAgent<float> agent(std::move(net));
+    utec::nn::State state{0.5f, 0.5f, 0.4f};
+    agent.act(state);
+    const size_t before_act = heap_allocations;
+    for (int i = 0; i < 100; ++i)
+        agent.act(state);
+    const size_t act_allocations = heap_allocations - before_act;
+
+    std::cout << "Heap allocations for 100 decisions: " << act_allocations << "\n";
+    std::cout << (no_heap && ok && act_allocations == 0 ? "PASSED" : "FAILED") << "\n";
+}
+
+int main()
+{
+    test_alignment();
+    test_mixed_allocators();
+    test_pool_recycling();
+    test_inline_storage();
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "../include/utec/parallel/SpscQueue.h"
+#include "../include/utec/io/AsyncLogger.h"
+#include "../include/utec/io/Checkpointer.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cmath>
+
+using namespace utec::parallel;
+using namespace utec::io;
+
+void test_spsc_queue()
+{
+    std::cout << "Test 1: SPSC queue ordering under concurrency\n";
+    SpscQueue<int> queue(64);
+    const int num_items = 100000;
+    bool in_order = true;
+
+    std::thread consumer([&]
+                         {
+        int expected = 0;
+        int value;
+        while (expected < num_items)
+        {
+            if (queue.try_pop(value))
+            {
+                if (value != expected)
+                    in_order = false;
+                ++expected;
+            }
+        } });
+
+    for (int i = 0; i < num_items; ++i)
+    {
+        while (!queue.try_push(i))
+            std::this_thread::yield();
+    }
+    consumer.join();
+
+    std::cout << "Capacity: " << queue.capacity() << " (expected 64)\n";
+    std::cout << (in_order && queue.empty() && queue.capacity() == 64 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_async_logger()
+{
+    std::cout << "Test 2: AsyncLogger formats every row in order\n";
+    std::ostringstream sink;
+    {
+        AsyncLogger<std::pair<int, float>> logger([&](const std::pair<int, float> &row)
+                                                  { sink << row.first << "," << row.second << "\n"; },
+                                                  8);
+        for (int i = 0; i < 100; ++i)
+            logger.log({i, i * 0.5f});
+        logger.flush();
+    }
+
+    std::istringstream lines(sink.str());
+    std::string line;
+    int count = 0;
+    bool ordered = true;
+    while (std::getline(lines, line))
+    {
+        if (line.substr(0, line.find(',')) != std::to_string(count))
+            ordered = false;
+        ++count;
+    }
+    std::cout << "Rows written: " << count << " (expected 100)\n";
+    std::cout << (ordered && count == 100 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_logger_backpressure()
+{
+    std::cout << "Test 3: AsyncLogger keeps rows intact when the queue is full\n";
+    std::vector<std::string> received;
+    {
+        AsyncLogger<std::string> logger([&](const std::string &row)
+                                        {
+            // Slow sink so the producer keeps hitting a full queue
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            received.push_back(row); },
+                                        2);
+        for (int i = 0; i < 200; ++i)
+            logger.log("row-" + std::to_string(i) + "-with-a-payload-longer-than-sso");
+        logger.flush();
+    }
+
+    bool intact = received.size() == 200;
+    for (size_t i = 0; intact && i < received.size(); ++i)
+    {
+        if (received[i] != "row-" + std::to_string(i) + "-with-a-payload-longer-than-sso")
+            intact = false;
+    }
+    std::cout << "Rows received: " << received.size() << " (expected 200)\n";
+    std::cout << (intact ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_checkpointer()
+{
+    std::cout << "Test 4: Atomic checkpoint writes\n";
+    const std::string path = "checkpoint_test_params.txt";
+    std::vector<float> params = {0.5f, -1.25f, 3.0e-7f, 42.0f};
+    {
+        AsyncCheckpointer<float> checkpointer(path);
+        checkpointer.snapshot({1.0f, 2.0f});
+        checkpointer.snapshot(params); // may supersede the first one
+        checkpointer.flush();
+    }
+
+    std::ifstream in(path);
+    std::vector<float> loaded;
+    float v;
+    while (in >> v)
+        loaded.push_back(v);
+    std::ifstream tmp(path + ".tmp");
+    bool no_tmp = !tmp.good();
+    std::remove(path.c_str());
+
+    bool same = loaded == params;
+    std::cout << "Loaded " << loaded.size() << " values, temp file left: " << (no_tmp ? "no" : "yes") << "\n";
+    std::cout << (same && no_tmp ? "PASSED" : "FAILED") << "\n\n";
+}
+
+int main()
+{
+    test_spsc_queue();
+    test_async_logger();
+    test_logger_backpressure();
+    test_checkpointer();
+    return 0;
+}
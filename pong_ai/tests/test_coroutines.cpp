@@ -0,0 +1,185 @@
+#include "../include/utec/parallel/Task.h"
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace utec::parallel;
+using namespace std::chrono_literals;
+
+Task<int> square_on_pool(ThreadPool &pool, int x)
+{
+    co_await pool.schedule();
+    co_return x * x;
+}
+
+Task<int> sum_of_squares(ThreadPool &pool, int n)
+{
+    int total = 0;
+    for (int i = 1; i <= n; ++i)
+        total += co_await square_on_pool(pool, i);
+    co_return total;
+}
+
+void test_chained_tasks()
+{
+    std::cout << "Test 1: Chained tasks on the pool\n";
+    ThreadPool pool(2);
+    int result = sync_wait(sum_of_squares(pool, 10));
+    std::cout << "Sum of squares 1..10: " << result << " (expected 385)\n";
+    std::cout << (result == 385 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+Task<int> sleepy(ThreadPool &pool, int id, std::atomic<int> &in_flight, std::atomic<int> &peak)
+{
+    co_await pool.schedule();
+    int now = ++in_flight;
+    int prev = peak.load();
+    while (now > prev && !peak.compare_exchange_weak(prev, now))
+    {
+    }
+    co_await sleep_for(pool, 50ms);
+    --in_flight;
+    co_return id;
+}
+
+void test_sleep_does_not_block_workers()
+{
+    std::cout << "Test 2: Many sleeping coroutines on few threads\n";
+    ThreadPool pool(2);
+    const int n = 64;
+    std::atomic<int> in_flight{0}, peak{0};
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < n; ++i)
+        tasks.push_back(sleepy(pool, i, in_flight, peak));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> ids = sync_wait(when_all(std::move(tasks)));
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    bool ordered = ids.size() == static_cast<size_t>(n);
+    for (int i = 0; ordered && i < n; ++i)
+        ordered = ids[i] == i;
+
+    // Blocking sleeps would take n / threads * 50ms = 1.6s
+    std::cout << n << " x 50ms sleeps took " << ms << " ms, peak in flight " << peak << "\n";
+    std::cout << (ordered && peak > 2 && ms < 800 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+Task<int> failing(ThreadPool &pool)
+{
+    co_await pool.schedule();
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+Task<int> catches(ThreadPool &pool)
+{
+    try
+    {
+        co_return co_await failing(pool);
+    }
+    catch (const std::runtime_error &)
+    {
+        co_return -1;
+    }
+}
+
+void test_exception_propagation()
+{
+    std::cout << "Test 3: Exception propagation\n";
+    ThreadPool pool(2);
+    bool caught_in_coroutine = sync_wait(catches(pool)) == -1;
+
+    bool caught_by_sync_wait = false;
+    try
+    {
+        sync_wait(failing(pool));
+    }
+    catch (const std::runtime_error &e)
+    {
+        caught_by_sync_wait = std::string(e.what()) == "boom";
+    }
+
+    std::vector<Task<int>> tasks;
+    tasks.push_back(square_on_pool(pool, 3));
+    tasks.push_back(failing(pool));
+    bool caught_by_when_all = false;
+    try
+    {
+        sync_wait(when_all(std::move(tasks)));
+    }
+    catch (const std::runtime_error &)
+    {
+        caught_by_when_all = true;
+    }
+
+    std::cout << (caught_in_coroutine && caught_by_sync_wait && caught_by_when_all ? "PASSED" : "FAILED")
+              << "\n\n";
+}
+
+Task<void> count_with_yields(ThreadPool &pool, std::atomic<int> &counter, int steps)
+{
+    co_await pool.schedule();
+    for (int i = 0; i < steps; ++i)
+    {
+        ++counter;
+        co_await yield(pool);
+    }
+}
+
+void test_void_tasks_and_yield()
+{
+    std::cout << "Test 4: Task<void>, yield and realtime scheduling\n";
+    ThreadPool pool(1);
+    std::atomic<int> counter{0};
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < 8; ++i)
+        tasks.push_back(count_with_yields(pool, counter, 100));
+    sync_wait(when_all(std::move(tasks)));
+
+    auto realtime = [](ThreadPool &p) -> Task<std::thread::id>
+    {
+        co_await p.schedule({Priority::Realtime, std::nullopt});
+        co_return std::this_thread::get_id();
+    };
+    bool on_worker = sync_wait(realtime(pool)) != std::this_thread::get_id();
+
+    std::cout << "Counter: " << counter << " (expected 800)\n";
+    std::cout << (counter == 800 && on_worker && pool.queue_stats(Priority::Realtime).count == 1
+                      ? "PASSED"
+                      : "FAILED")
+              << "\n";
+}
+
+void test_sleep_outlives_pool()
+{
+    std::cout << "\nTest 5: A pending sleep_for survives its pool being destroyed\n";
+    {
+        auto doomed = std::make_unique<ThreadPool>(1);
+        auto sleeper = sleep_for(*doomed, 100ms);
+        sleeper.await_suspend(std::noop_coroutine());
+        std::this_thread::sleep_for(20ms);
+        doomed.reset();
+    }
+    // The timer expires with its pool gone; the process must not abort
+    std::this_thread::sleep_for(150ms);
+
+    ThreadPool pool(1);
+    std::atomic<int> in_flight{0}, peak{0};
+    const bool timers_work = sync_wait(sleepy(pool, 7, in_flight, peak)) == 7;
+    std::cout << (timers_work ? "PASSED" : "FAILED") << "\n";
+}
+
+int main()
+{
+    test_chained_tasks();
+    test_sleep_does_not_block_workers();
+    test_exception_propagation();
+    test_void_tasks_and_yield();
+    test_sleep_outlives_pool();
+    return 0;
+}
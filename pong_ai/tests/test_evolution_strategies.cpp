@@ -0,0 +1,93 @@
+#include "../include/utec/agent/EvolutionStrategies.h"
+#include "../include/utec/nn/dense.h"
+#include "../include/utec/nn/activation.h"
+#include "../include/utec/nn/sequential.h"
+#include <iostream>
+
+using namespace utec::nn;
+using namespace utec::neural_network;
+
+// Linear policy (3 -> 3) that starts out always moving the paddle down
+std::unique_ptr<ILayer<float>> create_policy()
+{
+    auto model = std::make_unique<Sequential<float>>();
+    Tensor<float, 2> W(3, 3);
+    W.fill(0.0f);
+    Tensor<float, 1> b(3);
+    b.fill(0.0f);
+    b(0) = 0.1f;
+    model->add_layer(std::make_unique<Dense<float>>(3, 3, W, b));
+    return model;
+}
+
+ESConfig small_config(size_t workers)
+{
+    ESConfig config;
+    config.max_steps = 300;
+    config.workers = workers;
+    config.seed = 4;
+    return config;
+}
+
+void test_seeded_episodes()
+{
+    std::cout << "Test 1: Seeded EnvGym episodes are reproducible\n";
+    EnvGym a(123), b(123);
+    State sa = a.reset(), sb = b.reset();
+    bool same = true;
+    float ra, rb;
+    bool da, db;
+    for (int t = 0; t < 200; ++t)
+    {
+        sa = a.step(t % 3 - 1, ra, da);
+        sb = b.step(t % 3 - 1, rb, db);
+        same &= sa.ball_x == sb.ball_x && sa.ball_y == sb.ball_y && ra == rb && da == db;
+    }
+    std::cout << (same ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_worker_count_independence()
+{
+    std::cout << "Test 2: Same seed gives the same parameters for any worker count\n";
+    utec::parallel::ThreadPool pool(3);
+    EvolutionStrategies<float> serial(create_policy, small_config(1), pool);
+    EvolutionStrategies<float> parallel(create_policy, small_config(3), pool);
+    for (int g = 0; g < 3; ++g)
+    {
+        serial.step();
+        parallel.step();
+    }
+    bool same = serial.parameters() == parallel.parameters();
+    std::cout << "Generations: " << serial.generation() << "\n";
+    std::cout << (same ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_fitness_improves()
+{
+    std::cout << "Test 3: ES improves game reward\n";
+    utec::parallel::ThreadPool pool(2);
+    EvolutionStrategies<float> es(create_policy, small_config(2), pool);
+
+    // Weak ball-tracking policy: the "stay" bias wins most of the time.
+    // Layout: W [ball_x, ball_y, paddle_y] x [down, stay, up], then b
+    es.set_parameters({0.0f, 0.0f, 0.0f,
+                       1.5f, 0.0f, -1.5f,
+                       -1.5f, 0.0f, 1.5f,
+                       0.0f, 0.3f, 0.0f});
+
+    float before = es.evaluate(32, 99);
+    for (int g = 0; g < 30; ++g)
+        es.step();
+    float after = es.evaluate(32, 99);
+
+    std::cout << "Mean reward: " << before << " -> " << after << "\n";
+    std::cout << (after > before + 0.5f ? "PASSED" : "FAILED") << "\n\n";
+}
+
+int main()
+{
+    test_seeded_episodes();
+    test_worker_count_independence();
+    test_fitness_improves();
+    return 0;
+}
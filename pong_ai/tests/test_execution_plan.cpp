@@ -0,0 +1,146 @@
+#include "../include/utec/nn/execution_plan.h"
+#include "../include/utec/nn/neural_network.h"
+#include "../include/utec/nn/dense.h"
+#include "../include/utec/nn/activation.h"
+#include "../include/utec/nn/sequential.h"
+#include <iostream>
+#include <cmath>
+
+using namespace utec::neural_network;
+
+// Builds a deep ReLU stack with deterministic weights
+template <typename T>
+std::unique_ptr<Sequential<T>> create_model(size_t depth)
+{
+    auto model = std::make_unique<Sequential<T>>();
+    size_t in = 3;
+    for (size_t l = 0; l < depth; ++l)
+    {
+        size_t out = (l + 1 == depth) ? 3 : 16;
+        Tensor<T, 2> W(in, out);
+        for (size_t i = 0; i < in; ++i)
+            for (size_t j = 0; j < out; ++j)
+                W(i, j) = static_cast<T>(std::sin(0.7 * (i + 1) * (j + 2) + l)) * 0.5f;
+        model->add_layer(std::make_unique<Dense<T>>(in, out, W));
+        if (l + 1 != depth)
+            model->add_layer(std::make_unique<ReLU<T>>());
+        in = out;
+    }
+    return model;
+}
+
+template <typename T>
+Tensor<T, 2> create_input(size_t batch)
+{
+    Tensor<T, 2> X(batch, 3);
+    for (size_t i = 0; i < batch; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            X(i, j) = static_cast<T>(std::cos(0.3 * i + j));
+    return X;
+}
+
+template <typename T>
+T max_abs_diff(const Tensor<T, 2> &a, const Tensor<T, 2> &b)
+{
+    if (a.shape() != b.shape())
+        return 1e9f;
+    T worst = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        worst = std::max(worst, std::abs(a.data()[i] - b.data()[i]));
+    return worst;
+}
+
+void test_inference_matches_forward()
+{
+    std::cout << "Test 1: Inference plan matches Sequential::forward\n";
+    using T = float;
+    auto model = create_model<T>(6);
+    auto X = create_input<T>(32);
+
+    Tensor<T, 2> expected = model->forward(X);
+    ExecutionPlan<T> plan(*model, 3, 32, PlanMode::Inference);
+    const Tensor<T, 2> &out = plan.forward(X);
+
+    std::cout << "Steps: " << plan.step_count() << ", buffers: " << plan.buffer_count()
+              << " (expected 2)\n";
+    bool passed = max_abs_diff(out, expected) < 1e-5f && plan.buffer_count() == 2;
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_training_matches_backward()
+{
+    std::cout << "Test 2: Training plan matches forward/backward/update\n";
+    using T = float;
+    auto reference = create_model<T>(4);
+    auto planned = create_model<T>(4);
+    auto X = create_input<T>(8);
+
+    ExecutionPlan<T> plan(*planned, 3, 8, PlanMode::Training);
+    T worst = 0;
+    for (int it = 0; it < 3; ++it)
+    {
+        Tensor<T, 2> ref_out = reference->forward(X);
+        const Tensor<T, 2> &out = plan.forward(X);
+        worst = std::max(worst, max_abs_diff(out, ref_out));
+
+        Tensor<T, 2> grad(8, 3);
+        grad.fill(0.1f);
+        Tensor<T, 2> ref_dx = reference->backward(grad);
+        const Tensor<T, 2> &dx = plan.backward(grad);
+        worst = std::max(worst, max_abs_diff(dx, ref_dx));
+
+        reference->update(0.05f);
+        plan.update(0.05f);
+    }
+
+    // Inputs of the Dense layers stay alive, ReLU inputs are recycled
+    std::cout << "Max difference: " << worst << ", buffers: " << plan.buffer_count()
+              << " for " << plan.step_count() << " steps\n";
+    bool passed = worst < 1e-4f && plan.buffer_count() < plan.step_count();
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_network_compile()
+{
+    std::cout << "Test 3: NeuralNetwork::compile and shape mismatch\n";
+    using T = float;
+    NeuralNetwork<T> net;
+    net.add_layer(create_model<T>(3));
+    auto plan = net.compile(3, 4);
+    bool test1 = plan.output_features() == 3 && plan.mode() == PlanMode::Inference;
+
+    bool test2 = false;
+    try
+    {
+        Tensor<T, 2> bad(4, 5);
+        plan.forward(bad);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "Caught exception: " << e.what() << "\n";
+        test2 = true;
+    }
+
+    // Oversized batches would regrow the buffers, so they are rejected
+    bool test3 = false;
+    const size_t bytes = plan.planned_bytes();
+    try
+    {
+        plan.forward(create_input<T>(5));
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "Caught exception: " << e.what() << "\n";
+        test3 = plan.planned_bytes() == bytes;
+    }
+    bool test4 = plan.forward(create_input<T>(2)).shape()[0] == 2;
+    std::cout << (test1 && test2 && test3 && test4 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+int main()
+{
+    test_inference_matches_forward();
+    test_training_matches_backward();
+    test_network_compile();
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "../include/utec/agent/LUTAgent.h"
+#include "../include/utec/nn/trainer.h"
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using namespace utec::nn;
+
+// Small 3-16-3 network with reproducible weights
+std::unique_ptr<utec::neural_network::ILayer<float>> make_model()
+{
+    utec::neural_network::TrainConfig config;
+    config.hidden = {16};
+    utec::random::Philox rng(3);
+    return utec::neural_network::build_model<float>(config, 3, 3, &rng);
+}
+
+void test_exact_at_cell_centers()
+{
+    std::cout << "Test 1: LUT matches the network at every cell center\n";
+    PongAgent<float> agent(make_model());
+    const LUTResolution res{8, 12, 20};
+    LUTAgent lut = LUTAgent::compile(agent, res);
+
+    // More runs than rows: the fixture policy is not constant along paddle_y
+    bool ok = lut.cells() == 8 * 12 * 20 && lut.runs() > 8 * 12 && lut.runs() < lut.cells();
+    for (size_t i = 0; i < res.ball_x; ++i)
+        for (size_t j = 0; j < res.ball_y; ++j)
+            for (size_t k = 0; k < res.paddle_y; ++k)
+            {
+                const State s{(i + 0.5f) / res.ball_x, (j + 0.5f) / res.ball_y, (k + 0.5f) / res.paddle_y};
+                ok = ok && lut.act(s) == agent.act(s);
+            }
+
+    // Out-of-range states use the nearest cell
+    ok = ok && lut.act({-3.0f, 0.5f, 2.0f}) == lut.act({0.01f, 0.5f, 0.99f}) &&
+         lut.act({1.0f, 1e30f, NAN}) == lut.act({0.99f, 0.99f, 0.01f});
+    std::cout << "Cells: " << lut.cells() << ", runs: " << lut.runs() << "\n";
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_parallel_compile_and_agreement()
+{
+    std::cout << "Test 2: Parallel compile and agreement report\n";
+    PongAgent<float> agent(make_model());
+    utec::parallel::ThreadPool pool(4);
+    LUTAgent serial = LUTAgent::compile(agent, {48, 48, 48});
+    LUTAgent parallel = LUTAgent::compile(agent, {48, 48, 48}, pool);
+
+    // Same table either way, checked on a fine probe of the whole cube
+    bool identical = serial.runs() == parallel.runs();
+    for (int p = 0; p < 100000 && identical; ++p)
+    {
+        const State s{std::fmod(p * 0.6180339f, 1.0f), std::fmod(p * 0.4142135f, 1.0f),
+                      std::fmod(p * 0.7320508f, 1.0f)};
+        identical = serial.act(s) == parallel.act(s);
+    }
+
+    // Off-center states disagree only near decision boundaries
+    const LUTAgreement report = parallel.agreement(agent, 100000, 42);
+    size_t total = 0;
+    for (auto &row : report.confusion)
+        for (size_t count : row)
+            total += count;
+    std::cout << "Agreement: " << report.rate() * 100 << "% of " << report.samples << " states\n";
+    std::cout << (identical && report.samples == 100000 && total == report.samples && report.rate() > 0.97
+                      ? "PASSED"
+                      : "FAILED")
+              << "\n\n";
+}
+
+void test_save_and_load()
+{
+    std::cout << "Test 3: Save and load a compiled table\n";
+    PongAgent<float> agent(make_model());
+    LUTAgent lut = LUTAgent::compile(agent, {16, 16, 16});
+    const std::string path = "/tmp/utec_lut_" + std::to_string(::getpid()) + ".lut";
+
+    LUTAgent loaded;
+    bool ok = loaded.empty() && lut.save(path) && LUTAgent::load(path, loaded) && !loaded.empty();
+    ok = ok && loaded.runs() == lut.runs() && loaded.bytes() == lut.bytes();
+    for (int p = 0; p < 10000 && ok; ++p)
+    {
+        const State s{std::fmod(p * 0.31f, 1.0f), std::fmod(p * 0.17f, 1.0f), std::fmod(p * 0.23f, 1.0f)};
+        ok = lut.act(s) == loaded.act(s);
+    }
+
+    // A truncated file is rejected and leaves the target untouched
+    std::FILE *f = std::fopen(path.c_str(), "r+b");
+    bool truncated = f != nullptr && ::ftruncate(::fileno(f), 40) == 0;
+    if (f)
+        std::fclose(f);
+    ok = ok && truncated && !LUTAgent::load(path, loaded) && loaded.runs() == lut.runs();
+    ok = ok && !LUTAgent::load(path + ".missing", loaded);
+    std::remove(path.c_str());
+
+    bool rejected = false;
+    try
+    {
+        LUTAgent::compile(agent, {0, 4, 4});
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected = true;
+    }
+    std::cout << (ok && rejected ? "PASSED" : "FAILED") << "\n";
+}
+
+int main()
+{
+    test_exact_at_cell_centers();
+    test_parallel_compile_and_agreement();
+    test_save_and_load();
+    return 0;
+}
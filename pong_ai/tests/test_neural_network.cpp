@@ -2,7 +2,9 @@
 #include "../include/utec/nn/dense.h"
 #include "../include/utec/nn/activation.h"
 #include "../include/utec/nn/loss.h"
+#include "../include/utec/nn/metrics.h"
 #include "../include/utec/nn/neural_network.h"
+#include "../include/utec/nn/sequential.h"
 #include <iostream>
 
 using namespace utec::neural_network;
@@ -20,7 +22,7 @@ void test_relu()
     auto R = relu.forward(M);
     bool test1 = R(0, 1) == 2;
 
-    Tensor<float, 2> GR({2, 2});
+    Tensor<float, 2> GR(2, 2);
     GR.fill(1.0f);
     auto dM = relu.backward(GR);
     bool test2 = dM(0, 0) == 0 && dM(1, 1) == 0;
@@ -46,6 +48,64 @@ void test_mseloss()
     std::cout << (test1 && test2 ? "PASSED" : "FAILED") << "\n\n";
 }
 
+void test_softmax_cross_entropy()
+{
+    std::cout << "Prueba SoftmaxCrossEntropyLoss forward/backward\n";
+    Tensor<double, 2> Z(2, 3);
+    Z(0, 0) = 1;
+    Z(0, 1) = 2;
+    Z(0, 2) = 3;
+    // Large logits must not overflow
+    Z(1, 0) = 1000;
+    Z(1, 1) = 0;
+    Z(1, 2) = -1000;
+    std::vector<int> labels = {2, 1};
+
+    SoftmaxCrossEntropyLoss<double> loss;
+    double L = loss.forward(Z, labels);
+    // Row 0: log(e^1 + e^2 + e^3) - 3, row 1: 1000
+    double expected = (0.40760596444 + 1000.0) / 2;
+    bool test1 = std::abs(L - expected) < 1e-6;
+
+    const Tensor<double, 2> &dZ = loss.backward();
+    bool test2 = std::abs(dZ(0, 0) - 0.09003057 / 2) < 1e-6 &&
+                 std::abs(dZ(0, 2) - (0.66524096 - 1) / 2) < 1e-6 &&
+                 std::abs(dZ(1, 1) - (-0.5)) < 1e-6;
+    bool test3 = std::abs(loss.accuracy() - 50.0) < 1e-9;
+    std::cout << (test1 && test2 && test3 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_metrics()
+{
+    std::cout << "Prueba ClassificationMetrics\n";
+    Tensor<float, 2> out(4, 3);
+    out(0, 0) = 1; // pred 0
+    out(1, 2) = 1; // pred 2
+    out(2, 1) = 1; // pred 1
+    out(3, 2) = 1; // pred 2
+    std::vector<int8_t> labels = {0, 1, 1, 2};
+
+    ClassificationMetrics metrics(3);
+    metrics.update(out, labels);
+    bool test1 = std::abs(metrics.accuracy() - 75.0) < 1e-9;
+    bool test2 = metrics.count(1, 2) == 1 && metrics.count(2, 2) == 1;
+    bool test3 = std::abs(metrics.recall(1) - 50.0) < 1e-9 &&
+                 std::abs(metrics.precision(2) - 50.0) < 1e-9;
+
+    // A batch with a bad label in its last row is rejected as a whole
+    bool test4 = false;
+    try
+    {
+        metrics.update(out, std::vector<int8_t>{0, 1, 1, 3});
+    }
+    catch (const std::out_of_range &)
+    {
+        test4 = metrics.total() == 4 && metrics.count(0, 0) == 1 && metrics.count(1, 2) == 1 &&
+                std::abs(metrics.accuracy() - 75.0) < 1e-9;
+    }
+    std::cout << (test1 && test2 && test3 && test4 ? "PASSED" : "FAILED") << "\n\n";
+}
+
 void test_xor()
 {
     std::cout << "Prueba Entrenamiento XOR\n";
@@ -135,6 +195,211 @@ void test_shape_mismatch()
         std::cout << "Caught wrong exception: " << e.what() << "\n";
     }
 
+    // Gradients whose shape does not match the cached forward pass
+    auto rejects = [](auto &&backward)
+    {
+        try
+        {
+            backward();
+        }
+        catch (const std::invalid_argument &)
+        {
+            return true;
+        }
+        return false;
+    };
+    Dense<T> dense(3, 3);
+    ReLU<T> relu;
+    Tensor<T, 2> x(2, 3);
+    x.fill(1.0f);
+    dense.forward(x);
+    relu.forward(x);
+    bool grads_checked = rejects([&]
+                                 { dense.backward(Tensor<T, 2>(64, 3)); }) &&
+                         rejects([&]
+                                 { dense.backward(Tensor<T, 2>(2, 4)); }) &&
+                         rejects([&]
+                                 { relu.backward(Tensor<T, 2>(64, 3)); });
+    relu.release_cache();
+    grads_checked = grads_checked && rejects([&]
+                                             { relu.backward(Tensor<T, 2>(2, 3)); });
+
+    std::cout << (passed && grads_checked ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_checkpointing()
+{
+    std::cout << "Prueba Gradient checkpointing\n";
+    using T = float;
+
+    // Two identical deep models, one with checkpointing every 3 layers
+    auto build = []()
+    {
+        auto model = std::make_unique<Sequential<T>>();
+        size_t in = 2;
+        for (size_t l = 0; l < 5; ++l)
+        {
+            Tensor<T, 2> W(in, 8);
+            for (size_t i = 0; i < in; ++i)
+                for (size_t j = 0; j < 8; ++j)
+                    W(i, j) = (static_cast<T>((i * 7 + j * 3 + l) % 11) - 5) * 0.1f;
+            model->add_layer(std::make_unique<Dense<T>>(in, 8, W));
+            model->add_layer(std::make_unique<ReLU<T>>());
+            in = 8;
+        }
+        return model;
+    };
+    auto plain = build();
+    auto checkpointed = build();
+    checkpointed->set_checkpointing(3);
+
+    Tensor<T, 2> X(4, 2);
+    X(0, 0) = 0.5f;
+    X(1, 1) = -0.25f;
+    X(2, 0) = 1.0f;
+    X(3, 1) = 0.75f;
+
+    bool passed = true;
+    for (int it = 0; it < 3; ++it)
+    {
+        auto out1 = plain->forward(X);
+        auto out2 = checkpointed->forward(X);
+        Tensor<T, 2> grad(4, 8);
+        grad.fill(0.5f);
+        auto dx1 = plain->backward(grad);
+        auto dx2 = checkpointed->backward(grad);
+        plain->update(0.1f);
+        checkpointed->update(0.1f);
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            for (size_t j = 0; j < 2; ++j)
+                passed = passed && std::abs(dx1(i, j) - dx2(i, j)) < 1e-5f;
+            for (size_t j = 0; j < 8; ++j)
+                passed = passed && std::abs(out1(i, j) - out2(i, j)) < 1e-5f;
+        }
+    }
+    auto p1 = plain->obtener_parametros();
+    auto p2 = checkpointed->obtener_parametros();
+    for (size_t i = 0; i < p1.size(); ++i)
+        passed = passed && std::abs(p1[i] - p2[i]) < 1e-5f;
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_packed_inference()
+{
+    std::cout << "Prueba Inferencia con pesos empaquetados\n";
+    using T = float;
+    bool passed = true;
+
+    // Packed kernels vs the training forward: narrow and wide panels, with
+    // and without a zero-padded tail, over several batch sizes
+    for (size_t out : {3, 17, 64, 70})
+    {
+        Tensor<T, 2> W(19, out);
+        for (size_t i = 0; i < W.size(); ++i)
+            W.data()[i] = static_cast<T>(static_cast<int>(i % 13) - 6) * 0.05f;
+        Dense<T> layer(19, out, W);
+        for (size_t batch = 1; batch <= 9; ++batch)
+        {
+            Tensor<T, 2> X(batch, 19);
+            for (size_t i = 0; i < X.size(); ++i)
+                X.data()[i] = static_cast<T>(i % 5) * 0.3f - 0.5f;
+            Tensor<T, 2> expected = layer.forward(X), got;
+            layer.infer_into(X, got);
+            passed = passed && got.shape() == expected.shape();
+            for (size_t i = 0; passed && i < got.size(); ++i)
+                passed = std::abs(got.data()[i] - expected.data()[i]) < 1e-5f;
+        }
+    }
+
+    // Weights changed by training or by establecer_parametros are repacked
+    Dense<T> layer(4, 5);
+    Tensor<T, 2> X(1, 4), Y, Z;
+    X.fill(1.0f);
+    layer.infer_into(X, Y);
+    layer.forward(X);
+    Tensor<T, 2> grad(1, 5);
+    grad.fill(1.0f);
+    layer.backward(grad);
+    layer.update(0.1f);
+    layer.infer_into(X, Z);
+    auto reference = layer.forward(X);
+    passed = passed && std::abs(Z(0, 0) - reference(0, 0)) < 1e-6f && std::abs(Z(0, 0) - Y(0, 0)) > 1e-3f;
+
+    auto params = layer.obtener_parametros();
+    for (auto &p : params)
+        p = 0.5f;
+    layer.establecer_parametros(params);
+    layer.infer_into(X, Z);
+    passed = passed && Z(0, 4) == 2.5f;
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_padded_weights()
+{
+    std::cout << "Prueba Pesos con filas rellenadas\n";
+    using T = float;
+    bool passed = true;
+
+    // 256 columns are stored with a padded row stride; every kernel must
+    // still see a plain [in, out] matrix
+    for (size_t out : {3, 256})
+    {
+        const size_t in = 5, batch = 3;
+        Tensor<T, 2> W(in, out), X(batch, in), G(batch, out);
+        for (size_t i = 0; i < W.size(); ++i)
+            W.data()[i] = static_cast<T>(static_cast<int>(i % 11) - 5) * 0.1f;
+        for (size_t i = 0; i < X.size(); ++i)
+            X.data()[i] = static_cast<T>(i % 4) * 0.5f - 0.5f;
+        for (size_t i = 0; i < G.size(); ++i)
+            G.data()[i] = static_cast<T>(i % 3) - 1.0f;
+        Dense<T> layer(in, out, W);
+
+        Tensor<T, 2> Y = layer.forward(X), DX = layer.backward(G);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            for (size_t j = 0; j < out; ++j)
+            {
+                T y = 0;
+                for (size_t k = 0; k < in; ++k)
+                    y += X(i, k) * W(k, j);
+                passed = passed && std::abs(Y(i, j) - y) < 1e-5f;
+            }
+            for (size_t k = 0; k < in; ++k)
+            {
+                T dx = 0;
+                for (size_t j = 0; j < out; ++j)
+                    dx += G(i, j) * W(k, j);
+                passed = passed && std::abs(DX(i, k) - dx) < 1e-4f;
+            }
+        }
+
+        // Parameters come out in [in, out] order, and clones match
+        auto params = layer.obtener_parametros();
+        passed = passed && params.size() == layer.contar_parametros() && params.size() == in * out + out;
+        for (size_t i = 0; passed && i < W.size(); ++i)
+            passed = params[i] == W.data()[i];
+        auto copy = layer.clone();
+        Tensor<T, 2> Yc = copy->forward(X);
+        for (size_t i = 0; passed && i < Y.size(); ++i)
+            passed = Yc.data()[i] == Y.data()[i];
+
+        // One SGD step: W -= lr * X^T G
+        layer.update(0.5f);
+        params = layer.obtener_parametros();
+        for (size_t k = 0; k < in; ++k)
+            for (size_t j = 0; j < out; ++j)
+            {
+                T dw = 0;
+                for (size_t i = 0; i < batch; ++i)
+                    dw += X(i, k) * G(i, j);
+                passed = passed && std::abs(params[k * out + j] - (W(k, j) - 0.5f * dw)) < 1e-5f;
+            }
+    }
+
     std::cout << (passed ? "PASSED" : "FAILED") << "\n\n";
 }
 
@@ -142,7 +407,12 @@ int main()
 {
     test_relu();
     test_mseloss();
+    test_softmax_cross_entropy();
+    test_metrics();
     test_xor();
     test_shape_mismatch();
+    test_checkpointing();
+    test_packed_inference();
+    test_padded_weights();
     return 0;
 }
\ No newline at end of file
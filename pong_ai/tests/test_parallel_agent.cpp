@@ -2,6 +2,8 @@
 #include "../include/utec/agent/PongAgent.h"
 #include "../include/utec/nn/dense.h"
 #include "../include/utec/nn/sequential.h"
+#include "../include/utec/parallel/Rcu.h"
+#include <atomic>
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -197,7 +199,76 @@ void test_concurrent_access()
     }
 
     std::cout << "Completed " << futures.size() << " tasks without errors\n";
-    std::cout << "PASSED\n";
+    std::cout << "PASSED\n\n";
+}
+
+// Every element equals id; the destructor records that id was reclaimed
+std::atomic<bool> reclaimed[512];
+
+struct Payload
+{
+    int id;
+    std::vector<int> values;
+    explicit Payload(int i) : id(i), values(64, i) {}
+    ~Payload() { reclaimed[id] = true; }
+};
+
+void test_hot_swap()
+{
+    std::cout << "Test 4: Hot swap of weights while serving\n";
+    using T = float;
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+
+    // Readers never see a mixed or reclaimed version
+    utec::parallel::RcuCell<Payload> cell(std::make_unique<Payload>(0));
+    auto reader = [&]
+    {
+        while (!done)
+        {
+            auto snapshot = cell.read();
+            const int id = snapshot->id;
+            for (int v : snapshot->values)
+                consistent = consistent && v == id;
+            consistent = consistent && static_cast<uint64_t>(id) + 1 == snapshot.version() && !reclaimed[id];
+        }
+    };
+    std::thread r1(reader), r2(reader);
+    for (int id = 1; id < 512; ++id)
+        cell.publish(std::make_unique<Payload>(id));
+    done = true;
+    r1.join();
+    r2.join();
+    bool cell_ok = consistent && cell.version() == 512 && reclaimed[510] && !reclaimed[511];
+
+    // A serving agent flips between "always down" and "always up" weights
+    auto sequential = std::make_unique<utec::neural_network::Sequential<T>>();
+    sequential->add_layer(std::make_unique<utec::neural_network::Dense<T>>(
+        3, 3, utec::algebra::Tensor<T, 2>(3, 3), utec::algebra::Tensor<T, 1>(3)));
+    ParallelPongAgent<T> agent(std::move(sequential), 2);
+    // Biases only; a half-written update (b0 already 0, b2 still 0) would
+    // answer "stay"
+    std::vector<T> down(12, 0.0f), up(12, 0.0f);
+    down[9] = 1.0f; // bias of action index 0
+    up[11] = 1.0f;  // bias of action index 2
+    down[10] = up[10] = 0.6f;
+
+    std::atomic<int> stay_answers{0};
+    done = false;
+    std::thread server([&]
+                       {
+        while (!done) {
+            if (agent.act_async({0.5f, 0.5f, 0.5f}).get() == 0)
+                ++stay_answers;
+        } });
+    for (int i = 0; i < 200; ++i)
+        agent.establecer_parametros(i % 2 == 0 ? down : up);
+    done = true;
+    server.join();
+
+    bool agent_ok = stay_answers == 0 && agent.model_version() == 201 && agent.act({0.1f, 0.2f, 0.3f}) == -1;
+    std::cout << "Versions published: " << agent.model_version() << "\n";
+    std::cout << (cell_ok && agent_ok ? "PASSED" : "FAILED") << "\n";
 }
 
 int main()
@@ -205,5 +276,6 @@ int main()
     test_parallel_inference();
     test_result_correctness();
     test_concurrent_access();
+    test_hot_swap();
     return 0;
 }
\ No newline at end of file
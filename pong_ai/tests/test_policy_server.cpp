@@ -0,0 +1,252 @@
+#include "../include/utec/io/PolicyServer.h"
+#include "../include/utec/nn/trainer.h"
+#include <iostream>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <poll.h>
+#include <sys/wait.h>
+#include <thread>
+#include <vector>
+
+using namespace utec::io;
+using utec::nn::State;
+
+// 3-16-3 network with fixed weights, identical in every process
+std::unique_ptr<utec::neural_network::ILayer<float>> make_model()
+{
+    utec::neural_network::TrainConfig config;
+    config.hidden = {16};
+    utec::random::Philox rng(3);
+    return utec::neural_network::build_model<float>(config, 3, 3, &rng);
+}
+
+std::vector<State> make_states(size_t n, size_t seed)
+{
+    std::vector<State> states(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const float t = static_cast<float>(i * 7 + seed * 13);
+        states[i] = {std::fmod(t * 0.031f, 1.0f), std::fmod(t * 0.017f, 1.0f), std::fmod(t * 0.023f, 1.0f)};
+    }
+    return states;
+}
+
+std::string socket_path(const char *name)
+{
+    return "/tmp/utec_" + std::string(name) + "_" + std::to_string(::getpid()) + ".sock";
+}
+
+// Child process: connects (retrying until the server is up) and checks
+// the served actions against a local copy of the network
+int run_child(const std::string &path)
+{
+    for (int attempt = 0; attempt < 500; ++attempt)
+    {
+        try
+        {
+            PolicyClient client(path);
+            utec::nn::PongAgent<float> local(make_model());
+            auto states = make_states(200, 1);
+            bool ok = client.act_batch(states) == local.act_batch(states);
+            for (size_t i = 0; i < 20; ++i)
+                ok = ok && client.act(states[i]) == local.act(states[i]);
+            return ok ? 0 : 1;
+        }
+        catch (const std::exception &)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    return 2;
+}
+
+void test_multi_process(pid_t child, const std::string &path)
+{
+    std::cout << "Test 1: Clients in another process share the server's model\n";
+    PolicyServer<float> server(make_model(), {path, 4, 512});
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    const bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && server.stats().states == 220;
+    std::cout << "Child exit code: " << (WIFEXITED(status) ? WEXITSTATUS(status) : -1) << "\n";
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_batching()
+{
+    std::cout << "Test 2: Requests of concurrent clients are batched\n";
+    const std::string path = socket_path("batching");
+    PolicyServer<float> server(make_model(), {path, 4, 512});
+    utec::nn::PongAgent<float> local(make_model());
+
+    // 1000 states per call: 16 request slots, twice the ring of a client
+    std::vector<std::vector<State>> states;
+    std::vector<std::vector<int>> expected;
+    for (size_t c = 0; c < 3; ++c)
+    {
+        states.push_back(make_states(1000, c));
+        expected.push_back(local.act_batch(states.back()));
+    }
+    std::atomic<int> matching{0};
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < 3; ++c)
+    {
+        clients.emplace_back([&, c]
+                             {
+            PolicyClient client(path);
+            bool same = true;
+            for (int round = 0; round < 5; ++round)
+                same = same && client.act_batch(states[c]) == expected[c];
+            if (same)
+                ++matching; });
+    }
+    for (auto &t : clients)
+        t.join();
+
+    const PolicyServerStats stats = server.stats();
+    std::cout << "Requests: " << stats.requests << ", forward passes: " << stats.batches
+              << ", largest batch: " << stats.max_batch_states << " states\n";
+    const bool ok = matching == 3 && stats.states == 15000 && stats.requests == 240 &&
+                    stats.batches < stats.requests && stats.max_batch_states <= 512;
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_control_channel()
+{
+    std::cout << "Test 3: Reload, channel limits and shutdown\n";
+    const std::string path = socket_path("control");
+    PolicyServer<float> server(make_model(), {path, 1, 64});
+    const State state{0.2f, 0.7f, 0.4f};
+
+    bool full = false, reloaded = false, rejected = false;
+    {
+        PolicyClient client(path);
+
+        // Only one channel: a second client is turned away
+        try
+        {
+            PolicyClient extra(path);
+        }
+        catch (const std::runtime_error &)
+        {
+            full = true;
+        }
+
+        // Zero weights and a bias on "up" (index 2): every state answers -1
+        std::vector<float> params(3 * 16 + 16 + 16 * 3 + 3, 0.0f);
+        params.back() = 1.0f;
+        const std::string params_file = socket_path("params") + ".txt";
+        write_params_atomically(params_file, params);
+        reloaded = client.reload(params_file) && client.act(state) == -1 && server.model_version() == 2;
+        rejected = !client.reload(params_file + ".missing");
+        std::remove(params_file.c_str());
+    }
+
+    // The channel is handed out again once its client has disconnected
+    std::unique_ptr<PolicyClient> next;
+    for (int attempt = 0; attempt < 200 && !next; ++attempt)
+    {
+        try
+        {
+            next = std::make_unique<PolicyClient>(path);
+        }
+        catch (const std::runtime_error &)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    const bool reattached = next && next->act(state) == -1;
+
+    // After stop() a waiting client gets an error instead of hanging
+    server.stop();
+    bool stopped = false;
+    try
+    {
+        next->act(state);
+    }
+    catch (const std::runtime_error &)
+    {
+        stopped = true;
+    }
+
+    std::cout << (full && reloaded && rejected && reattached && stopped ? "PASSED" : "FAILED") << "\n\n";
+}
+
+// Attaches like a PolicyClient, then publishes `in_flight` requests of
+// `count` states each. True if the server drops the connection for it.
+bool send_malformed(const std::string &path, uint32_t in_flight, uint32_t count)
+{
+    // The previous channel may still be on its way back to the free list
+    int fd = -1;
+    std::string reply;
+    for (int attempt = 0; attempt < 200 && reply.rfind("ATTACH ", 0) != 0; ++attempt)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        fd = utec::io::detail::connect_unix(path);
+        if (fd < 0 || !utec::io::detail::receive_line(fd, reply))
+            return false;
+    }
+    if (reply.rfind("ATTACH ", 0) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    const size_t space = reply.find(' ', 7);
+    utec::io::detail::PolicySegment segment;
+    segment.open(reply.substr(space + 1));
+    auto &channel = segment.channel(std::stoul(reply.substr(7, space - 7)));
+
+    const uint32_t base = channel.submitted.load();
+    for (uint32_t k = 0; k < std::min<uint32_t>(in_flight, utec::io::detail::policy_ring_slots); ++k)
+        channel.slots[(base + k) % utec::io::detail::policy_ring_slots].count = count;
+    channel.submitted.store(base + in_flight);
+    segment.header().doorbell.fetch_add(1);
+    utec::io::detail::futex_wake(segment.header().doorbell);
+
+    pollfd closed{fd, POLLIN, 0};
+    char c;
+    const bool dropped = ::poll(&closed, 1, 2000) > 0 && ::recv(fd, &c, 1, 0) == 0;
+    ::close(fd);
+    return dropped;
+}
+
+void test_malformed_requests()
+{
+    std::cout << "Test 4: Malformed requests close only the offending channel\n";
+    const std::string path = socket_path("malformed");
+    PolicyServer<float> server(make_model(), {path, 2, 64});
+    utec::nn::PongAgent<float> local(make_model());
+    const std::vector<State> states = make_states(100, 5);
+    const std::vector<int> expected = local.act_batch(states);
+
+    PolicyClient good(path);
+    const bool ahead = send_malformed(path, 1u << 30, 1);
+    const bool empty = send_malformed(path, 1, 0);
+    const bool oversized = send_malformed(path, 1, utec::io::detail::policy_slot_states + 1);
+    const bool served = good.act_batch(states) == expected;
+
+    const PolicyServerStats stats = server.stats();
+    std::cout << "Protocol errors: " << stats.protocol_errors << " (expected 3)\n";
+    std::cout << (ahead && empty && oversized && served && stats.protocol_errors == 3 ? "PASSED" : "FAILED")
+              << "\n";
+}
+
+int main()
+{
+    // Fork before any thread exists: the child only runs client code
+    const std::string path = socket_path("multi");
+    const pid_t child = ::fork();
+    if (child == 0)
+        ::_exit(run_child(path));
+
+    test_multi_process(child, path);
+    test_batching();
+    test_control_channel();
+    test_malformed_requests();
+    return 0;
+}
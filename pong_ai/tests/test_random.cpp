@@ -0,0 +1,117 @@
+#include "../include/utec/random/Philox.h"
+#include "../include/utec/nn/dense.h"
+#include "../include/utec/agent/EnvGym.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+using namespace utec::random;
+
+void test_known_answers()
+{
+    std::cout << "Test 1: Philox4x32-10 known-answer vectors\n";
+    // Reference values from the Random123 distribution (kat_vectors)
+    auto zero = Philox::philox({0, 0, 0, 0}, {0, 0});
+    auto ones = Philox::philox({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff});
+    auto pi = Philox::philox({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+
+    bool ok = zero == Philox::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8} &&
+              ones == Philox::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd} &&
+              pi == Philox::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+    std::cout << std::hex << "zero -> " << zero[0] << " " << zero[1] << " " << zero[2] << " " << zero[3]
+              << std::dec << "\n";
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_streams_and_discard()
+{
+    std::cout << "Test 2: Streams, substreams and O(1) discard\n";
+    Philox a(42, 3), b(42, 3), other(42, 4);
+    Philox sub = a.split(1);
+
+    std::vector<uint32_t> seq(1000);
+    for (auto &x : seq)
+        x = a();
+    bool reproducible = true, distinct = true;
+    size_t same_as_other = 0, same_as_sub = 0;
+    for (size_t i = 0; i < seq.size(); ++i)
+    {
+        reproducible &= b() == seq[i];
+        same_as_other += other() == seq[i];
+        same_as_sub += sub() == seq[i];
+    }
+    distinct = same_as_other < 3 && same_as_sub < 3;
+
+    Philox skip(42, 3);
+    skip.discard(517);
+    bool discard_ok = skip() == seq[517];
+    skip.discard(100);
+    discard_ok &= skip() == seq[618];
+
+    std::cout << "reproducible=" << reproducible << " distinct=" << distinct
+              << " discard=" << discard_ok << "\n";
+    std::cout << (reproducible && distinct && discard_ok ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_bulk_generation()
+{
+    std::cout << "Test 3: Bulk uniform/normal generation\n";
+    // Bulk output must match the scalar sequence, including after a partial block
+    Philox scalar(7), bulk(7);
+    scalar();
+    bulk();
+    std::vector<float> u(203);
+    bulk.fill_uniform(u.data(), u.size(), -1.0f, 1.0f);
+    bool matches = true;
+    for (float v : u)
+        matches &= std::abs(v - (-1.0f + 2.0f * scalar.uniform())) < 1e-6f;
+    matches &= bulk() == scalar();
+
+    std::vector<double> z(100001);
+    Philox(9).fill_normal(z.data(), z.size(), 2.0, 3.0);
+    double mean = 0, var = 0;
+    for (double v : z)
+        mean += v;
+    mean /= z.size();
+    for (double v : z)
+        var += (v - mean) * (v - mean);
+    var /= z.size();
+
+    std::cout << "normal mean=" << mean << " var=" << var << " (expected 2, 9)\n";
+    std::cout << (matches && std::abs(mean - 2.0) < 0.05 && std::abs(var - 9.0) < 0.2 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_layer_and_env_seeding()
+{
+    std::cout << "Test 4: Reproducible weight init and environments\n";
+    Philox r1(5, 0), r2(5, 0);
+    utec::neural_network::Dense<float> d1(16, 8, r1), d2(16, 8, r2);
+    bool same_weights = d1.obtener_parametros() == d2.obtener_parametros();
+
+    // Layers built without a generator get distinct streams
+    utec::neural_network::Dense<float> d3(16, 8), d4(16, 8);
+    bool distinct_layers = d3.obtener_parametros() != d4.obtener_parametros();
+
+    utec::nn::EnvGym e1(11, 2), e2(11, 2), e3(11, 3);
+    auto s1 = e1.reset(), s2 = e2.reset(), s3 = e3.reset();
+    float r;
+    bool done;
+    s1 = e1.step(0, r, done);
+    s2 = e2.step(0, r, done);
+    s3 = e3.step(0, r, done);
+    bool same_env = s1.ball_x == s2.ball_x && s1.ball_y == s2.ball_y;
+    bool distinct_env = s1.ball_x != s3.ball_x || s1.ball_y != s3.ball_y;
+
+    std::cout << "weights=" << same_weights << " layers=" << distinct_layers
+              << " env=" << same_env << " streams=" << distinct_env << "\n";
+    std::cout << (same_weights && distinct_layers && same_env && distinct_env ? "PASSED" : "FAILED") << "\n\n";
+}
+
+int main()
+{
+    test_known_answers();
+    test_streams_and_discard();
+    test_bulk_generation();
+    test_layer_and_env_seeding();
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "../include/utec/algebra/Reduce.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace utec::algebra;
+using utec::parallel::ThreadPool;
+
+void test_axis_reductions()
+{
+    std::cout << "Test 1: sum, mean, max and argmax along each axis\n";
+    // x(i, j, k) = i * 100 + j * 10 + k on a [2, 3, 4] tensor
+    Tensor<float, 3> x(2, 3, 4);
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            for (size_t k = 0; k < 4; ++k)
+                x(i, j, k) = static_cast<float>(i * 100 + j * 10 + k);
+
+    auto s0 = sum(x, 0);
+    auto s1 = sum(x, 1);
+    auto s2 = sum(x, 2);
+    auto m1 = mean(x, 1);
+    auto mx = max(x, 1);
+    auto am = argmax(x, 2);
+
+    bool ok = s0.shape() == std::array<size_t, 3>{1, 3, 4} && s1.shape() == std::array<size_t, 3>{2, 1, 4} &&
+              s2.shape() == std::array<size_t, 3>{2, 3, 1};
+    ok = ok && s0(0, 2, 3) == 20 + 3 + 100 + 20 + 3;
+    ok = ok && s1(1, 0, 1) == 3 * 101 + 30;
+    ok = ok && s2(1, 1, 0) == 4 * 110 + 6;
+    ok = ok && m1(1, 0, 1) == 111 && mx(1, 0, 3) == 123;
+    ok = ok && am(0, 0, 0) == 3 && am(1, 2, 0) == 3;
+
+    // Reduced results broadcast back against the input
+    Tensor<float, 3> centered = x - mx;
+    ok = ok && centered(0, 0, 0) == -20 && centered(1, 2, 3) == 0;
+
+    // Ties resolve to the first maximum
+    Tensor<float, 2> tie(2, 3);
+    const float tie_values[] = {1, 5, 5, 7, 2, 7};
+    std::copy(tie_values, tie_values + 6, tie.data());
+    auto tie_arg = argmax(tie, 1);
+    ok = ok && tie_arg(0, 0) == 1 && tie_arg(1, 0) == 0 && sum(tie) == 27 && max(tie) == 7;
+
+    // *_into accepts any tensor with the right number of elements
+    Tensor<float, 1> col_sums(3);
+    sum_into(tie, 0, col_sums);
+    ok = ok && col_sums(0) == 8 && col_sums(1) == 7 && col_sums(2) == 12;
+
+    // Reducing an empty axis gives zeros, whatever the output held before
+    Tensor<float, 2> empty(0, 5);
+    Tensor<float, 1> empty_sums(5);
+    empty_sums.fill(-1.0f);
+    sum_into(empty, 0, empty_sums);
+    auto empty_sum = sum(empty, 0);
+    auto empty_mean = mean(empty, 0);
+    ok = ok && empty_sum.shape() == std::array<size_t, 2>{1, 5};
+    for (size_t j = 0; j < 5; ++j)
+        ok = ok && empty_sums(j) == 0 && empty_sum(0, j) == 0 && empty_mean(0, j) == 0;
+
+    bool bad_axis = false, bad_output = false;
+    try
+    {
+        sum(x, 3);
+    }
+    catch (const std::out_of_range &)
+    {
+        bad_axis = true;
+    }
+    try
+    {
+        Tensor<float, 1> wrong(2);
+        sum_into(tie, 0, wrong);
+    }
+    catch (const std::invalid_argument &)
+    {
+        bad_output = true;
+    }
+
+    std::cout << (ok && bad_axis && bad_output ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_pairwise_accuracy()
+{
+    std::cout << "Test 2: Pairwise summation accuracy\n";
+    // 2^22 copies of 0.1f: a naive running float sum drifts by several percent
+    const size_t n = size_t{1} << 22;
+    Tensor<float, 1> x(n);
+    x.fill(0.1f);
+    const double exact = 0.1f * static_cast<double>(n);
+
+    float naive = 0;
+    for (size_t i = 0; i < n; ++i)
+        naive += x(i);
+    const double naive_err = std::abs(naive - exact) / exact;
+    const double pairwise_err = std::abs(sum(x) - exact) / exact;
+
+    // Same along an axis: columns of a [n / 4, 4] view
+    Tensor<float, 2> rows(n / 4, 4);
+    rows.fill(0.1f);
+    Tensor<float, 2> cols = sum(rows, 0);
+    const double col_err = std::abs(cols(0, 2) - exact / 4) / (exact / 4);
+
+    // Fused expressions reduce exactly like their materialized value
+    Tensor<float, 1> y(n);
+    for (size_t i = 0; i < n; ++i)
+        y(i) = static_cast<float>(i % 7) * 0.25f;
+    Tensor<float, 1> z = x * y - y;
+    const bool fused_matches = sum(x * y - y) == sum(z);
+
+    std::cout << "Relative error: naive " << naive_err << ", pairwise " << pairwise_err
+              << ", column " << col_err << "\n";
+    std::cout << (pairwise_err < 1e-6 && col_err < 1e-6 && naive_err > 100 * pairwise_err && fused_matches
+                      ? "PASSED"
+                      : "FAILED")
+              << "\n\n";
+}
+
+void test_parallel_matches_serial()
+{
+    std::cout << "Test 3: Parallel reductions match the serial ones bit for bit\n";
+    ThreadPool pool(4);
+    Tensor<float, 2> x(3000, 70);
+    for (size_t i = 0; i < x.size(); ++i)
+        x.data()[i] = std::sin(static_cast<float>(i)) * 1000.0f;
+    Tensor<float, 1> flat(1 << 20);
+    for (size_t i = 0; i < flat.size(); ++i)
+        flat.data()[i] = std::cos(static_cast<float>(i));
+
+    bool ok = sum(flat, pool) == sum(flat) && mean(flat, pool) == mean(flat);
+    for (size_t axis = 0; axis < 2; ++axis)
+    {
+        Tensor<float, 2> ps = sum(x, axis, pool), ss = sum(x, axis);
+        Tensor<float, 2> pm = max(x, axis, pool), sm = max(x, axis);
+        Tensor<size_t, 2> pa = argmax(x, axis, pool), sa = argmax(x, axis);
+        for (size_t i = 0; i < ss.size(); ++i)
+            ok = ok && ps.data()[i] == ss.data()[i] && pm.data()[i] == sm.data()[i] && pa.data()[i] == sa.data()[i];
+    }
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n";
+}
+
+int main()
+{
+    test_axis_reductions();
+    test_pairwise_accuracy();
+    test_parallel_matches_serial();
+    return 0;
+}
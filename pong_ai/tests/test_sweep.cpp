@@ -0,0 +1,113 @@
+#include "../include/utec/nn/trainer.h"
+#include "../include/utec/tuning/Sweep.h"
+#include "../include/utec/parallel/ThreadPool.h"
+#include <iostream>
+#include <sstream>
+#include <cmath>
+
+using namespace utec::neural_network;
+using namespace utec::tuning;
+
+// Small synthetic Pong dataset: ball_x, ball_y, paddle_y
+Tensor<float, 2> create_dataset(size_t samples)
+{
+    Tensor<float, 2> X(samples, 3);
+    for (size_t i = 0; i < samples; ++i)
+    {
+        X(i, 0) = static_cast<float>(std::fmod(0.37 * i, 1.0));
+        X(i, 1) = static_cast<float>(std::fmod(0.61 * i + 0.2, 1.0));
+        X(i, 2) = static_cast<float>(std::fmod(0.23 * i + 0.5, 1.0));
+    }
+    return X;
+}
+
+void test_trainer_incremental()
+{
+    std::cout << "Test 1: Trainer runs epochs incrementally\n";
+    Tensor<float, 2> X = create_dataset(64);
+    auto labels = derive_labels(X);
+
+    TrainConfig config;
+    config.hidden = {16};
+    config.learning_rate = 0.05f;
+    Trainer<float> trainer(config, X, labels);
+
+    float first = trainer.step();
+    trainer.run(49);
+    float last = trainer.last_loss();
+    std::cout << "Epochs: " << trainer.epochs_done() << ", loss " << first << " -> " << last << "\n";
+    std::cout << (trainer.epochs_done() == 50 && last < first ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_grid_expansion()
+{
+    std::cout << "Test 2: Grid and random search specs\n";
+    SweepSpec spec;
+    spec.architectures = {{8}, {16, 8}};
+    spec.learning_rates = {0.01f, 0.05f, 0.1f};
+    spec.l2_lambdas = {0.0f, 0.001f};
+    size_t grid = spec.expand().size();
+
+    spec.mode = SearchMode::Random;
+    spec.num_samples = 5;
+    auto sampled = spec.expand();
+    auto again = spec.expand();
+    bool same_seed_same_trials = true;
+    for (size_t i = 0; i < sampled.size(); ++i)
+        same_seed_same_trials &= sampled[i].describe() == again[i].describe();
+
+    std::cout << "Grid trials: " << grid << " (expected 12), random trials: " << sampled.size() << "\n";
+    std::cout << (grid == 12 && sampled.size() == 5 && same_seed_same_trials ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_successive_halving()
+{
+    std::cout << "Test 3: Successive halving stops poor trials early\n";
+    Tensor<float, 2> X = create_dataset(64);
+    auto labels = derive_labels(X);
+
+    SweepSpec spec;
+    spec.architectures = {{8}, {16}};
+    spec.learning_rates = {0.001f, 0.05f, 0.1f};
+    spec.l2_lambdas = {0.0f};
+    spec.epochs = 40;
+    spec.min_epochs = 10;
+    spec.eta = 2;
+
+    utec::parallel::ThreadPool pool(2);
+    size_t rungs = 0;
+    auto results = run_sweep(spec, X, labels, pool, [&](size_t, const std::vector<TrialResult> &)
+                             { ++rungs; });
+
+    // 6 trials -> 3 at 20 epochs -> 2 at 40 epochs
+    size_t completed = 0;
+    bool ranked = true;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        completed += results[i].completed;
+        if (i > 0 && results[i].completed && results[i].accuracy > results[i - 1].accuracy)
+            ranked = false;
+    }
+    bool best_is_full = results.front().completed && results.front().epochs_run == 40;
+
+    std::ostringstream csv;
+    write_results_csv(csv, results);
+    size_t lines = 0;
+    for (char c : csv.str())
+        lines += c == '\n';
+
+    std::cout << "Trials: " << results.size() << ", completed: " << completed << ", rungs: " << rungs << "\n";
+    std::cout << (results.size() == 6 && completed == 2 && rungs == 3 && ranked &&
+                          best_is_full && lines == 7
+                      ? "PASSED"
+                      : "FAILED")
+              << "\n\n";
+}
+
+int main()
+{
+    test_trainer_incremental();
+    test_grid_expansion();
+    test_successive_halving();
+    return 0;
+}
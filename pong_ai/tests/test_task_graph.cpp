@@ -0,0 +1,179 @@
+#include "../include/utec/parallel/TaskGraph.h"
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+using namespace utec::parallel;
+
+void test_dependency_order()
+{
+    std::cout << "Test 1: Dependencies are respected\n";
+    ThreadPool pool(4);
+    TaskGraph graph;
+    std::mutex m;
+    std::vector<std::string> order;
+    auto record = [&](std::string name)
+    {
+        return [&, name]
+        {
+            std::lock_guard<std::mutex> lock(m);
+            order.push_back(name);
+        };
+    };
+
+    // Diamond: a -> {b, c} -> d -> e
+    auto a = graph.emplace(record("a"), "a");
+    auto b = graph.emplace(record("b"), "b");
+    auto c = graph.emplace(record("c"), "c");
+    auto d = graph.emplace(record("d"), "d");
+    auto e = graph.emplace(record("e"), "e");
+    a.precede(b).precede(c);
+    d.succeed(b).succeed(c).precede(e);
+
+    bool ok = true;
+    for (int run = 0; run < 50 && ok; ++run)
+    {
+        order.clear();
+        graph.run(pool);
+        auto pos = [&](const std::string &name)
+        {
+            for (size_t i = 0; i < order.size(); ++i)
+                if (order[i] == name)
+                    return i;
+            return order.size();
+        };
+        ok = order.size() == 5 && pos("a") < pos("b") && pos("a") < pos("c") &&
+             pos("b") < pos("d") && pos("c") < pos("d") && pos("d") < pos("e");
+    }
+    std::cout << "Tasks: " << graph.size() << ", edges: " << graph.num_edges() << "\n";
+    std::cout << (ok && graph.num_edges() == 5 && !graph.running() ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_reexecution()
+{
+    std::cout << "Test 2: Build once, run many times\n";
+    ThreadPool pool(4);
+    const size_t shards = 8;
+    const int steps = 500;
+
+    // forward(shard) -> reduce -> update, like one data-parallel training step
+    std::vector<int> partial(shards, 0);
+    int reduced = 0, updates = 0;
+    TaskGraph step;
+    auto reduce = step.emplace([&]
+                               {
+        reduced = 0;
+        for (int p : partial)
+            reduced += p; },
+                               "reduce");
+    auto update = step.emplace([&]
+                               { updates += reduced == static_cast<int>(shards) ? 1 : 0; },
+                               "update");
+    reduce.precede(update);
+    for (size_t s = 0; s < shards; ++s)
+    {
+        auto fwd = step.emplace([&, s]
+                                { partial[s] = 1; },
+                                "forward");
+        fwd.precede(reduce);
+    }
+
+    for (int i = 0; i < steps; ++i)
+    {
+        std::fill(partial.begin(), partial.end(), 0);
+        step.run(pool);
+    }
+    std::cout << "Complete steps: " << updates << " (expected " << steps << ")\n";
+    std::cout << (updates == steps ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_errors_and_cycles()
+{
+    std::cout << "Test 3: Exceptions and cycle detection\n";
+    ThreadPool pool(2);
+    TaskGraph graph;
+    std::atomic<int> after_failure{0};
+    bool fail = true;
+    auto a = graph.emplace([&]
+                           { if (fail) throw std::runtime_error("shard failed"); });
+    auto b = graph.emplace([&]
+                           { ++after_failure; });
+    a.precede(b);
+
+    bool caught = false;
+    try
+    {
+        graph.run(pool);
+    }
+    catch (const std::runtime_error &)
+    {
+        caught = true;
+    }
+    // The failed run skipped b; the graph is reusable afterwards
+    bool skipped = after_failure == 0;
+    fail = false;
+    graph.run(pool);
+    bool reusable = after_failure == 1;
+
+    TaskGraph cyclic;
+    auto x = cyclic.emplace([] {});
+    auto y = cyclic.emplace([] {});
+    x.precede(y);
+    y.precede(x);
+    bool cycle_detected = false;
+    try
+    {
+        cyclic.run(pool);
+    }
+    catch (const std::invalid_argument &)
+    {
+        cycle_detected = true;
+    }
+
+    std::cout << (caught && skipped && reusable && cycle_detected && !cyclic.running() ? "PASSED" : "FAILED")
+              << "\n\n";
+}
+
+void test_continuation()
+{
+    std::cout << "Test 4: Asynchronous run with continuation\n";
+    ThreadPool pool(2);
+    TaskGraph graph;
+    std::atomic<int> work{0};
+    for (int i = 0; i < 16; ++i)
+        graph.emplace([&]
+                      { ++work; });
+
+    // The continuation re-launches the graph until it has run three times
+    std::promise<int> finished;
+    int runs = 0;
+    std::function<void(std::exception_ptr)> again = [&](std::exception_ptr error)
+    {
+        if (error || ++runs == 3)
+            finished.set_value(runs);
+        else
+            graph.run_async(pool, again);
+    };
+    graph.run_async(pool, again);
+    int total_runs = finished.get_future().get();
+    graph.wait();
+
+    TaskGraph empty;
+    empty.run(pool);
+
+    std::cout << "Runs: " << total_runs << ", tasks executed: " << work << " (expected 48)\n";
+    std::cout << (total_runs == 3 && work == 48 ? "PASSED" : "FAILED") << "\n";
+}
+
+int main()
+{
+    test_dependency_order();
+    test_reexecution();
+    test_errors_and_cycles();
+    test_continuation();
+    return 0;
+}
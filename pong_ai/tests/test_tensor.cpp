@@ -1,4 +1,4 @@
-#include "../include/utec/algebra/tensor.h"
+#include "../include/utec/algebra/Tensor.h"
 #include <iostream>
 #include <stdexcept>
 
@@ -92,6 +92,77 @@ void test_case_7()
     std::cout << (test1 && test2 ? "PASSED" : "FAILED") << "\n\n";
 }
 
+void test_case_8()
+{
+    std::cout << "Caso 8: Expresiones perezosas y operadores compuestos\n";
+    Tensor<float, 2> a(2, 3), b(2, 3), c(2, 3);
+    a.fill(1.0f);
+    b.fill(2.0f);
+    c.fill(3.0f);
+    Tensor<float, 2> bias(1, 3);
+    bias(0, 2) = 10.0f;
+
+    // Fused evaluation, with broadcasting inside the expression
+    Tensor<float, 2> r = a + b * c - bias;
+    bool test1 = r(0, 0) == 7.0f && r(1, 2) == -3.0f;
+
+    // In place: accumulate and scale without temporaries
+    a += bias;
+    a *= 2.0f;
+    a -= b * 0.5f;
+    bool test2 = a(1, 2) == 21.0f && a(0, 0) == 1.0f;
+
+    // A dying operand lends its buffer to the result (heap-sized, since
+    // tensors under 256 bytes are stored inline and copied on move)
+    Tensor<float, 2> tmp = b;
+    Tensor<float, 2> reused = std::move(tmp) + c;
+    Tensor<float, 2> big(32, 32), big_c(32, 32);
+    big.fill(1.0f);
+    big_c.fill(2.0f);
+    const float *buffer = big.data();
+    Tensor<float, 2> big_reused = std::move(big) + big_c;
+    bool test3 = reused(0, 1) == 5.0f && big_reused.data() == buffer && big_reused(31, 31) == 3.0f;
+
+    // Compound assignment cannot grow the left-hand side
+    bool test4 = false;
+    try
+    {
+        bias += a;
+    }
+    catch (const std::invalid_argument &)
+    {
+        test4 = true;
+    }
+    std::cout << (test1 && test2 && test3 && test4 ? "PASSED" : "FAILED") << "\n\n";
+}
+
+void test_case_9()
+{
+    std::cout << "Caso 9: Broadcasting N-dimensional\n";
+    // [2, 1, 4] * [1, 3, 1] + [2, 3, 4]
+    Tensor<int, 3> a(2, 1, 4), b(1, 3, 1), c(2, 3, 4);
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = static_cast<int>(i);
+    for (size_t i = 0; i < b.size(); ++i)
+        b.data()[i] = static_cast<int>(10 * (i + 1));
+    c.fill(1);
+    Tensor<int, 3> r = a * b + c;
+
+    bool ok = r.shape() == std::array<size_t, 3>{2, 3, 4};
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            for (size_t k = 0; k < 4; ++k)
+                ok = ok && r(i, j, k) == a(i, 0, k) * b(0, j, 0) + 1;
+
+    // Long rows with a per-row scale (stride-0 operand in the inner loop)
+    Tensor<float, 2> m(3, 1000), scale(3, 1);
+    m.fill(2.0f);
+    scale(1, 0) = 3.0f;
+    Tensor<float, 2> s = m * scale;
+    ok = ok && s(0, 999) == 0.0f && s(1, 0) == 6.0f && s(1, 700) == 6.0f;
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n\n";
+}
+
 int main()
 {
     test_case_1();
@@ -101,5 +172,7 @@ int main()
     test_case_5();
     test_case_6();
     test_case_7();
+    test_case_8();
+    test_case_9();
     return 0;
 }
\ No newline at end of file
@@ -3,6 +3,11 @@
 #include <vector>
 #include <atomic>
 #include <future>
+#include <mutex>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
 
 using namespace utec::parallel;
 
@@ -90,10 +95,161 @@ void test_exception_handling()
     }
 }
 
+void test_placement_policies()
+{
+    std::cout << "\nTest 4: Compact/scatter/explicit placement\n";
+    // Two nodes, two cores per node, two SMT threads per core
+    std::vector<CpuInfo> cpus;
+    for (int cpu = 0; cpu < 8; ++cpu)
+    {
+        int node = cpu < 4 ? 0 : 1;
+        cpus.push_back({cpu, (cpu % 4) / 2, node, node});
+    }
+    Topology topo(cpus);
+
+    auto compact = plan_placement(topo, {PinPolicy::Compact, {}}, 4);
+    auto scatter = plan_placement(topo, {PinPolicy::Scatter, {}}, 4);
+    auto explicit_ = plan_placement(topo, {PinPolicy::Explicit, {6, 2}}, 3);
+    auto none = plan_placement(topo, {}, 2);
+
+    bool ok = compact == std::vector<int>{0, 1, 2, 3} &&
+              scatter == std::vector<int>{0, 4, 2, 6} &&
+              explicit_ == std::vector<int>{6, 2, 6} &&
+              none == std::vector<int>{-1, -1} &&
+              Topology::parse_cpu_list("0-2,5,7-8") == std::vector<int>{0, 1, 2, 5, 7, 8};
+    std::cout << "Scatter: " << scatter[0] << "," << scatter[1] << "," << scatter[2] << "," << scatter[3]
+              << " (expected 0,4,2,6)\n";
+    std::cout << (ok ? "PASSED" : "FAILED") << "\n";
+}
+
+void test_pinned_workers()
+{
+    std::cout << "\nTest 5: Pinned workers and per-worker buffers\n";
+    Topology topo = Topology::detect();
+    ThreadPool pool(2, {PinPolicy::Compact, {}});
+
+    // Each worker runs the broadcast exactly once and reports where it runs
+    std::vector<int> seen(pool.size(), 0);
+    std::vector<int> ran_on(pool.size(), -1);
+    pool.run_on_each_worker([&](size_t w)
+                            {
+        seen[w]++;
+        ran_on[w] = current_cpu(); });
+
+    bool once_each = seen == std::vector<int>(pool.size(), 1);
+    bool on_planned_cpu = true;
+    for (size_t w = 0; w < pool.size(); ++w)
+    {
+        if (pool.worker_pinned(w))
+            on_planned_cpu &= ran_on[w] == pool.worker_cpu(w);
+    }
+
+    // Buffers allocated and first touched by their own worker
+    auto buffers = pool.make_worker_local([](size_t w)
+                                          {
+        std::vector<float> buffer(1 << 16);
+        first_touch(buffer.data(), buffer.size());
+        buffer[0] = static_cast<float>(w);
+        return buffer; });
+    bool buffers_ok = buffers.size() == pool.size() && buffers[1][0] == 1.0f;
+
+    std::cout << "CPUs: " << topo.size() << ", nodes: " << topo.num_nodes()
+              << ", worker 0 on cpu " << pool.worker_cpu(0) << "\n";
+    std::cout << (once_each && on_planned_cpu && buffers_ok && ThreadPool::current_worker() == -1
+                      ? "PASSED"
+                      : "FAILED")
+              << "\n";
+}
+
+void test_priority_lanes()
+{
+    std::cout << "\nTest 6: Priority lanes and earliest-deadline-first\n";
+    ThreadPool pool(1);
+    std::mutex m;
+    std::vector<std::string> order;
+    auto record = [&](std::string name)
+    {
+        return [&, name]
+        {
+            std::lock_guard<std::mutex> lock(m);
+            order.push_back(name);
+        };
+    };
+
+    // Hold the only worker so everything below is queued before dispatch
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    auto blocker = pool.enqueue([opened]
+                                { opened.wait(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::future<void>> futures;
+    futures.push_back(pool.enqueue_with({Priority::Background, std::nullopt}, record("bg")));
+    futures.push_back(pool.enqueue(record("normal")));
+    futures.push_back(pool.enqueue_with({Priority::Realtime, std::nullopt}, record("rt")));
+    futures.push_back(pool.enqueue_with({Priority::Realtime, now + std::chrono::seconds(2)}, record("rt_late")));
+    futures.push_back(pool.enqueue_with({Priority::Realtime, now + std::chrono::seconds(1)}, record("rt_early")));
+    gate.set_value();
+    blocker.get();
+    for (auto &f : futures)
+        f.get();
+
+    std::vector<std::string> expected = {"rt_early", "rt_late", "rt", "normal", "bg"};
+    auto rt = pool.queue_stats(Priority::Realtime);
+    auto bg = pool.queue_stats(Priority::Background);
+
+    std::cout << "Order:";
+    for (const auto &name : order)
+        std::cout << " " << name;
+    std::cout << "\nRealtime waits: " << rt.count << " tasks, mean " << rt.mean_us() << " us\n";
+    std::cout << (order == expected && rt.count == 3 && bg.count == 1 && rt.missed_deadlines == 0 &&
+                          rt.percentile_us(99) <= rt.max_us()
+                      ? "PASSED"
+                      : "FAILED")
+              << "\n";
+}
+
+void test_wait_all()
+{
+    std::cout << "\nTest 7: wait_all drains every task before rethrowing\n";
+    ThreadPool pool(4);
+    std::atomic<int> finished{0};
+    std::vector<std::future<void>> futures;
+    futures.push_back(pool.enqueue([]
+                                   { throw std::runtime_error("first"); }));
+    for (int i = 0; i < 6; ++i)
+    {
+        futures.push_back(pool.enqueue([&finished, i]
+                                       {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10 * (i + 1)));
+            if (i == 2)
+                throw std::logic_error("later");
+            ++finished; }));
+    }
+
+    std::string caught;
+    try
+    {
+        wait_all(futures);
+    }
+    catch (const std::exception &e)
+    {
+        caught = e.what();
+    }
+    // The slow tasks finished before the exception left wait_all
+    std::cout << "Rethrown: " << caught << ", finished tasks: " << finished << "\n";
+    std::cout << (caught == "first" && finished == 5 ? "PASSED" : "FAILED") << "\n";
+}
+
 int main()
 {
     test_basic_task_execution();
     test_parallel_computation();
     test_exception_handling();
+    test_placement_policies();
+    test_pinned_workers();
+    test_priority_lanes();
+    test_wait_all();
     return 0;
 }
\ No newline at end of file